@@ -0,0 +1,198 @@
+/*!
+ * @file ADC128D818Bulk.cpp
+ * @author Setting-Dawn
+ * @brief Implementation of a register-level ADC128D818 driver with block reads.
+ * @details Register sequence follows the adc128d818_driver library by bryanduxbury.
+ * @version 1.1.0
+ * @date 2026-Oct-16
+ */
+
+#include "ADC128D818Bulk.h"
+
+/**
+ * @brief Creates a driver for one ADC128D818 on the given bus.
+ *
+ * @param bus the TWI bus the ADC is connected to
+ * @param ADCaddress the TWI address of the ADC
+ */
+ADC128D818Bulk::ADC128D818Bulk(TwoWire* bus, uint8_t ADCaddress)
+{
+    wire = bus;
+    address = ADCaddress;
+    transactions = 0;
+    bytes = 0;
+    conversions = 0;
+    disabled = 0x00;
+}
+
+/*! @brief Configures the ADC for single ended conversion of all channels
+* @details Waits for the power-on reset to finish, selects mode 1 (8 single ended
+* inputs) with the internal reference and enables all channels. The ADC then
+* either converts continuously, or stays in shutdown until startOneShot() is called.
+* @param oneShot true to only convert when triggered by startOneShot()
+* @return true if the ADC became ready and accepted the configuration
+*/
+bool ADC128D818Bulk::begin(bool oneShot)
+{
+    wire->begin();
+
+    // The not ready bit stays set until the power-on initialization has finished
+    uint8_t busy = 0x02;
+    for (uint8_t attempt = 0; attempt < 10 && (busy & 0x02); attempt++)
+    {
+        if (!readRegisters(ADC128D818_BUSY_STATUS_REG, &busy, 1)) {return false;}
+        if (busy & 0x02) {delay(35);}
+    }
+    if (busy & 0x02) {return false;}
+
+    disabled = 0x00;
+    return writeRegister(ADC128D818_CONFIG_REG, 0x00)             // Stop while configuring
+        && writeRegister(ADC128D818_ADVANCED_CONFIG_REG, 1 << 1)  // Mode 1, internal reference
+        && writeRegister(ADC128D818_CONV_RATE_REG, 0x01)          // Continuous conversion
+        && writeRegister(ADC128D818_CHANNEL_DISABLE_REG, 0x00)    // All channels enabled
+        && (oneShot || writeRegister(ADC128D818_CONFIG_REG, 0x01)); // Start, interrupts disabled
+}
+
+/*! @brief Selects which channels are converted
+* @details The register may only be changed in shutdown, so this is for one-shot
+* mode. It is only written when the mask differs from what the ADC already holds.
+* @param mask bit n set to skip channel n
+* @return true if the ADC acknowledged the write, or none was needed
+*/
+bool ADC128D818Bulk::setDisabledChannels(uint8_t mask)
+{
+    if (mask == disabled) {return true;}
+    if (!writeRegister(ADC128D818_CHANNEL_DISABLE_REG, mask)) {return false;}
+    disabled = mask;
+    return true;
+}
+
+/*! @brief Gets the channels currently skipped
+* @return bit n set if channel n is disabled
+*/
+uint8_t ADC128D818Bulk::getDisabledChannels(void) {return disabled;}
+
+/*! @brief Starts a single round of conversions of every enabled channel
+* @details Only for one-shot mode. The round is over once readBusy() reports idle.
+* @return true if the ADC acknowledged the trigger
+*/
+bool ADC128D818Bulk::startOneShot(void)
+{
+    for (uint8_t c=0;c<8;c++)
+    {
+        if (!(disabled & (1 << c))) {conversions++;}
+    }
+    return writeRegister(ADC128D818_ONE_SHOT_REG, 0x01);
+}
+
+/*! @brief Reads whether the ADC is converting
+* @param busy set while a round of conversions is in progress
+* @return true if the status was read
+*/
+bool ADC128D818Bulk::readBusy(bool& busy)
+{
+    uint8_t status;
+    if (!readRegisters(ADC128D818_BUSY_STATUS_REG, &status, 1)) {return false;}
+    busy = status & 0x01;
+    return true;
+}
+
+/*! @brief Reads the result registers of all 8 channels in one transaction
+* @param codes array filled with the 12 bit conversion result of channels 0-7
+* @return true if all 16 bytes were received
+*/
+bool ADC128D818Bulk::readAll(uint16_t codes[8])
+{
+    uint8_t data[16];
+    if (!readRegisters(ADC128D818_CHANNEL_READING_REG, data, 16)) {return false;}
+
+    // Results are 12 bits, MSB first and left aligned in each 16 bit register
+    for (uint8_t i=0;i<8;i++)
+    {
+        codes[i] = ((uint16_t)data[2*i] << 8 | data[2*i+1]) >> 4;
+    }
+    return true;
+}
+
+/*! @brief Reads the result register of a single channel
+* @param channel the 0-7 channel to read
+* @return the 12 bit conversion result, or 0 if the read failed
+*/
+uint16_t ADC128D818Bulk::read(uint8_t channel)
+{
+    uint8_t data[2];
+    if (!readRegisters(ADC128D818_CHANNEL_READING_REG + channel, data, 2)) {return 0;}
+    return ((uint16_t)data[0] << 8 | data[1]) >> 4;
+}
+
+/*! @brief Reads a single channel and converts it to volts
+* @param channel the 0-7 channel to read
+* @return the channel voltage
+*/
+float ADC128D818Bulk::readConverted(uint8_t channel) {return toVolts(read(channel));}
+
+/*! @brief Converts a conversion result to volts
+* @param code a 12 bit conversion result
+* @return the corresponding voltage using the internal reference
+*/
+float ADC128D818Bulk::toVolts(uint16_t code) {return code * (ADC128D818_INTERNAL_REF_V / 4096.0f);}
+
+/*! @brief Gets the number of TWI transactions issued since the counters were cleared
+* @return transaction count
+*/
+uint32_t ADC128D818Bulk::getTransactions(void) {return transactions;}
+
+/*! @brief Gets the number of bytes put on the bus since the counters were cleared
+* @return byte count, including address bytes
+*/
+uint32_t ADC128D818Bulk::getBytes(void) {return bytes;}
+
+/*! @brief Gets the number of channel conversions started since the counters were cleared
+* @return conversion count
+*/
+uint32_t ADC128D818Bulk::getConversions(void) {return conversions;}
+
+/*! @brief Clears the transaction, byte and conversion counters
+*/
+void ADC128D818Bulk::clearCounters(void)
+{
+    transactions = 0;
+    bytes = 0;
+    conversions = 0;
+}
+
+/*! @brief Writes one register
+* @param reg the register address
+* @param value the value to write
+* @return true if the ADC acknowledged the write
+*/
+bool ADC128D818Bulk::writeRegister(uint8_t reg, uint8_t value)
+{
+    wire->beginTransmission(address);
+    wire->write(reg);
+    wire->write(value);
+    transactions++;
+    bytes += 3;
+    return wire->endTransmission() == 0;
+}
+
+/*! @brief Reads consecutive registers starting at reg
+* @details The register pointer write and the read are joined by a repeated start
+* so they form a single transaction.
+* @param reg the first register address
+* @param data buffer receiving len bytes
+* @param len number of bytes to read
+* @return true if all bytes were received
+*/
+bool ADC128D818Bulk::readRegisters(uint8_t reg, uint8_t* data, uint8_t len)
+{
+    transactions++;
+    bytes += 3 + len; // Write address, register pointer, read address and the data
+
+    wire->beginTransmission(address);
+    wire->write(reg);
+    if (wire->endTransmission(false) != 0) {return false;}
+    if (wire->requestFrom(address, len) != len) {return false;}
+    for (uint8_t i=0;i<len;i++) {data[i] = wire->read();}
+    return true;
+}
@@ -0,0 +1,77 @@
+/*!
+ * @file ADC128D818Bulk.h
+ * @author Setting-Dawn
+ * @brief Header file for a register-level ADC128D818 driver with block reads.
+ * @version 1.1.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __ADC128D818BULK_H__
+#define __ADC128D818BULK_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// ADC128D818 register map
+#define ADC128D818_CONFIG_REG           0x00
+#define ADC128D818_CONV_RATE_REG        0x07
+#define ADC128D818_CHANNEL_DISABLE_REG  0x08
+#define ADC128D818_ONE_SHOT_REG         0x09
+#define ADC128D818_ADVANCED_CONFIG_REG  0x0B
+#define ADC128D818_BUSY_STATUS_REG      0x0C
+#define ADC128D818_CHANNEL_READING_REG  0x20
+
+/// Reference voltage of the internal ADC128D818 reference
+#define ADC128D818_INTERNAL_REF_V 2.56f
+/// Bytes on the bus for one readAll(), including address bytes
+#define ADC128D818_READ_ALL_BYTES (3 + 16)
+/// Bytes on the bus for one register write, including the address byte
+#define ADC128D818_WRITE_BYTES 3
+/// Bytes on the bus for one readBusy(), including address bytes
+#define ADC128D818_BUSY_BYTES (3 + 1)
+/// Typical conversion time of one channel, from the 12.2 ms monitoring cycle of all 8 channels
+#define ADC128D818_CHANNEL_CONVERSION_US 1525
+
+/**
+ * @class ADC128D818Bulk
+ * @brief Drives an ADC128D818 8 channel ADC in single ended mode and reads all channels at once.
+ *
+ * @details The channel reading registers 0x20-0x27 are contiguous, so after a single
+ * register pointer write the 16 result bytes are clocked out in one read, joined to the
+ * write by a repeated start. The driver counts the transactions and bytes it puts on the
+ * bus so the cost of a frame can be reported.
+ *
+ * In one-shot mode the ADC stays in shutdown and only converts when startOneShot() is
+ * called, converting just the channels left enabled by setDisabledChannels(). Each
+ * round then takes ADC128D818_CHANNEL_CONVERSION_US per enabled channel, and its end
+ * is found by polling readBusy().
+ */
+class ADC128D818Bulk {
+    private:
+        TwoWire* wire;
+        uint8_t address;
+        uint32_t transactions; // TWI transactions issued since the counters were cleared
+        uint32_t bytes;        // Bytes on the bus, including address bytes, since the counters were cleared
+        uint32_t conversions;  // Channel conversions started by startOneShot() since the counters were cleared
+        uint8_t disabled;      // Contents of the channel disable register
+
+        bool writeRegister(uint8_t reg, uint8_t value);
+        bool readRegisters(uint8_t reg, uint8_t* data, uint8_t len);
+    public:
+        ADC128D818Bulk(TwoWire* bus, uint8_t ADCaddress);
+        bool begin(bool oneShot = false);
+        bool setDisabledChannels(uint8_t mask);
+        uint8_t getDisabledChannels(void);
+        bool startOneShot(void);
+        bool readBusy(bool& busy);
+        bool readAll(uint16_t codes[8]);
+        uint16_t read(uint8_t channel);
+        float readConverted(uint8_t channel);
+        static float toVolts(uint16_t code);
+        uint32_t getTransactions(void);
+        uint32_t getBytes(void);
+        uint32_t getConversions(void);
+        void clearCounters(void);
+};
+
+#endif //__ADC128D818BULK_H__
@@ -2,8 +2,8 @@
  * @file CD74HC4067SM.cpp
  * @author Setting-Dawn
  * @brief Implementation of CD74HC4067SM multiplexer class.
- * @version 1.0.0
- * @date 2025-NOV-12
+ * @version 1.1.0
+ * @date 2026-Oct-16
  */
 
 #include "CD74HC4067SM.h"
@@ -21,11 +21,13 @@
 * @param Spin1 the Arduino pin used to control the s1 pin
 * @param Spin2 the Arduino pin used to control the s2 pin
 * @param Spin3 the Arduino pin used to control the s3 pin
-* @param enablePin the Arduino pin used to control !E pin
+* @param enablePin the Arduino pin used to control !E pin, or CD74HC4067SM_NO_ENABLE if
+*        no output pin reaches it; enable() and disable() then leave the chip as it is
  * 
  * @details The multiplexer uses binary addressing via pins S0, S1, S2, and S3 to select
  * one of 16 channels (0-15). When enabled (nE = LOW), the selected channel is connected
  * to the common I/O pin. When disabled (nE = HIGH), no channels are connected.
+ * The set and clear masks of every channel are built here.
  * 
  * @see switchPin(), enable(), disable()
  */
@@ -35,47 +37,59 @@ CD74HC4067SM::CD74HC4067SM(uint8_t SPin0,
                             uint8_t SPin3,
                             uint8_t enablePin) 
 {
-    // Assign all pins in use
-    s0 = SPin0;
-    s1 = SPin1;
-    s2 = SPin2;
-    s3 = SPin3;
-    nE = enablePin;
+    const uint8_t select[4] = {SPin0, SPin1, SPin2, SPin3};
+
+    // Select pin sk carries bit k of the channel number
+    memset(channel, 0, sizeof(channel));
+    for (uint8_t c=0;c<16;c++)
+    {
+        for (uint8_t k=0;k<4;k++) {setPin(channel[c], select[k], (c >> k) & 1);}
+    }
+    enableBank = 0;
+    enableMask = 0;
+    if (enablePin != CD74HC4067SM_NO_ENABLE)
+    {
+        enableBank = enablePin / 32;
+        enableMask = 1UL << (enablePin % 32);
+    }
 
     // Assign Arduino pins to OUTPUT mode
-    pinMode(s0,OUTPUT);
-    pinMode(s1,OUTPUT);
-    pinMode(s2,OUTPUT);
-    pinMode(s3,OUTPUT);
-    pinMode(nE,OUTPUT);
+    for (uint8_t k=0;k<4;k++) {pinMode(select[k],OUTPUT);}
+    if (enableMask) {pinMode(enablePin,OUTPUT);}
 };
 
+/*! @brief Adds a pin level to a set of GPIO register masks
+* @param masks the masks to add it to
+* @param pin the Arduino pin
+* @param level true to drive the pin HIGH, false for LOW
+*/
+void CD74HC4067SM::setPin(CD74HC4067SMMasks& masks, uint8_t pin, bool level)
+{
+    uint32_t bit = 1UL << (pin % 32);
+    if (level) {masks.set[pin / 32] |= bit;}
+    else {masks.clear[pin / 32] |= bit;}
+}
+
 /*! @brief switches connection to chosen pin value
-* @details enables the set of s-pins to represent the binary
-* of the chosen pin which closes the selected circuit to the chip output
+* @details sets the s-pins to represent the binary of the chosen pin, which
+* closes the selected circuit to the chip output. Clearing and setting the
+* select pins are separate register writes, so between them the chip briefly
+* selects another channel; gating disables the chip across the switch so that
+* channel is never connected. Without a driven nE, gating has no effect.
 * @param pin the 0-15 value of the desired channel
+* @param gated true to disable the chip while switching; it is enabled afterwards
 */
-void CD74HC4067SM::switchPin(uint8_t pin) 
+void CD74HC4067SM::switchPin(uint8_t pin, bool gated) 
 {
-    // s0 Controls bit 0, check if the requested pin
-    // needs s0 to be HIGH, otherwise set it LOW
-    if (pin & 0001) {digitalWrite(s0,HIGH);}
-    else {digitalWrite(s0,LOW);}
+    const CD74HC4067SMMasks& masks = channel[pin & 0x0F];
+    if (gated) {disable();}
 
-    // s1 Controls bit 1, check if the requested pin
-    // needs s1 to be HIGH, otherwise set it LOW
-    if (pin & 0010) {digitalWrite(s1,HIGH);}
-    else { digitalWrite(s1,LOW);}
+    if (masks.clear[0]) {GPIO.out_w1tc = masks.clear[0];}
+    if (masks.clear[1]) {GPIO.out1_w1tc.val = masks.clear[1];}
+    if (masks.set[0]) {GPIO.out_w1ts = masks.set[0];}
+    if (masks.set[1]) {GPIO.out1_w1ts.val = masks.set[1];}
 
-    // s2 Controls bit 2, check if the requested pin
-    // needs s2 to be HIGH, otherwise set it LOW
-    if (pin & 0100) {digitalWrite(s2,HIGH);}
-    else {digitalWrite(s2,LOW);}
-
-    // s3 Controls bit 3, check if the requested pin 
-    // needs s3 to be HIGH, otherwise set it LOW
-    if (pin & 1000) {digitalWrite(s3,HIGH);}
-    else {digitalWrite(s3,LOW);}
+    if (gated) {enable();}
 }
 
 /*! @brief Turns on pass-through
@@ -83,10 +97,20 @@ void CD74HC4067SM::switchPin(uint8_t pin)
 * of the selected channel
 * @param void no input is used
 */
-void CD74HC4067SM::enable(void) {digitalWrite(nE,LOW);}
+void CD74HC4067SM::enable(void)
+{
+    if (!enableMask) {return;}
+    if (enableBank == 0) {GPIO.out_w1tc = enableMask;}
+    else {GPIO.out1_w1tc.val = enableMask;}
+}
 
 /*! @brief Turns off pass-through
 * @details sets the notEnable pin HIGH to set to no channels
 * @param void no input is used
 */
-void CD74HC4067SM::disable(void) {digitalWrite(nE,HIGH);}
\ No newline at end of file
+void CD74HC4067SM::disable(void)
+{
+    if (!enableMask) {return;}
+    if (enableBank == 0) {GPIO.out_w1ts = enableMask;}
+    else {GPIO.out1_w1ts.val = enableMask;}
+}
@@ -2,14 +2,29 @@
  * @file CD74HC4067SM.h
  * @author Setting-Dawn
  * @brief Header file for CD74HC4067SM multiplexer class.
- * @version 1.0.0
- * @date 2025-NOV-12
+ * @version 1.1.0
+ * @date 2026-Oct-16
  */
 
 #ifndef __CD74HC4067SM_H__
 #define __CD74HC4067SM_H__
 
 #include <Arduino.h>
+#include <soc/gpio_struct.h>
+
+/// GPIO output registers of the ESP32: pins 0-31 and pins 32-39
+#define CD74HC4067SM_GPIO_BANKS 2
+/// Enable pin of a multiplexer whose nE is not driven by the controller, which then never gates it
+#define CD74HC4067SM_NO_ENABLE 0xFF
+
+/**
+ * @struct CD74HC4067SMMasks
+ * @brief Bits to set and clear in each GPIO output register to drive a set of pins.
+ */
+struct CD74HC4067SMMasks {
+    uint32_t set[CD74HC4067SM_GPIO_BANKS];
+    uint32_t clear[CD74HC4067SM_GPIO_BANKS];
+};
 
 /**
  * @class CD74HC4067SM
@@ -23,23 +38,26 @@
  * @details The multiplexer uses binary addressing via pins S0, S1, S2, and S3 to select
  * one of 16 channels (0-15). When enabled (nE = LOW), the selected channel is connected
  * to the common I/O pin. When disabled (nE = HIGH), no channels are connected.
+ *
+ * The GPIO register writes for every channel are computed at construction, so a switch
+ * drives all four select pins with one W1TS and one W1TC write per GPIO register used.
  */
 class CD74HC4067SM {
     private:
-        uint8_t s0;
-        uint8_t s1;
-        uint8_t s2;
-        uint8_t s3;
-        uint8_t nE;
+        CD74HC4067SMMasks channel[16]; // Select pin levels of each channel
+        uint32_t enableMask;           // nE's bit in its GPIO register, 0 if nE is not driven
+        uint8_t enableBank;            // GPIO register holding nE
+
+        static void setPin(CD74HC4067SMMasks& masks, uint8_t pin, bool level);
     public:
         CD74HC4067SM(uint8_t SPin0,
             uint8_t SPin1,
             uint8_t SPin2,
             uint8_t SPin3,
             uint8_t enablePin);
-        void switchPin(uint8_t pin);
+        void switchPin(uint8_t pin, bool gated = false);
         void enable(void);
         void disable(void);
 };
 
-#endif //__CD74HC4067SM_H__
\ No newline at end of file
+#endif //__CD74HC4067SM_H__
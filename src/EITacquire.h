@@ -0,0 +1,1009 @@
+/*!
+ * @file EITacquire.h
+ * @author Setting-Dawn
+ * @brief Pipelined EIT acquisition engine, generic over the electrode count.
+ * @details The engine is a template so every buffer is sized at compile time,
+ * which is why its implementation lives in this header.
+ * @version 1.8.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __EITACQUIRE_H__
+#define __EITACQUIRE_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <utility>
+#include <esp_timer.h>
+#include "TWIbus.h"
+#include "ADC128D818Bulk.h"
+#include "PCA9956Bulk.h"
+#include "CD74HC4067SM.h"
+#include "EITprotocol.h"
+#include "EITframe.h"
+
+/// Default time allowed for the electrodes to settle after an excitation switch before the
+/// ADCs are triggered. The ADCs convert on demand, so this no longer has to cover a full
+/// ADC128D818 monitoring cycle.
+#define EIT_DEFAULT_SETTLE_US 2000
+/// The settle timer wakes the reading task this long before the end of the settle time,
+/// which is then reached by busy waiting. Covers the dispatch latency of esp_timer callbacks.
+#define EIT_WAKE_LEAD_US 100
+/// Notification bit the settle timer sets in the reading task
+#define EIT_NOTIFY_SETTLED 0x02
+static_assert((EIT_NOTIFY_SETTLED & TWI_NOTIFY_DONE) == 0, "The reading task shares its notification with the bus");
+/// Busy status reads after which an ADC still converting is read anyway
+#define EIT_MAX_BUSY_POLLS 32
+/// Increment of the settle times tried by calibrateSettling()
+#define EIT_SETTLE_STEP_US 250
+/// Longest settle time tried by calibrateSettling(), also used to take its settled reference.
+/// One full ADC128D818 continuous monitoring cycle, which is what the settle time used to cover.
+#define EIT_SETTLE_MAX_US 13000
+/// ADC codes by which a reading may differ from the settled reference during calibration
+#define EIT_SETTLE_TOLERANCE 2
+/// Largest oversampling shift, 64 reads per excitation. Averaging 4^n reads gains n bits of
+/// resolution, and 3 extra bits keep every voltage difference of 12 bit codes in an int16_t.
+#define EIT_MAX_OVERSAMPLING_SHIFT 6
+
+/**
+ * @struct EITStats
+ * @brief Timing of the most recent excitation step and frame of the acquisition engine.
+ * @details All durations are in microseconds. Published through a Share so the
+ * web host can report them without touching the engine.
+ */
+struct EITStats {
+    uint32_t switchUs;  ///< Time spent switching the mux and current source
+    uint32_t settleUs;  ///< Time actually spent waiting for the electrodes to settle
+    uint32_t jitterUs;  ///< How late the latest step started its reads after the end of its settle time
+    uint32_t maxJitterUs; ///< Latest start of any step of the last complete frame
+    uint32_t lateSteps; ///< Steps of the last complete frame whose settle time was over before processing finished
+    uint32_t readUs;    ///< Time from triggering the ADC conversions until all results were read, including waiting for the bus
+    uint32_t frameReadUs; ///< Sum of readUs over the last complete frame
+    uint32_t adcRounds; ///< Rounds of conversions per frame, more than one per excitation when oversampling
+    float noiseFloorUv; ///< RMS noise of the decimated electrode voltages in the last frame, 0 unless every excitation oversamples
+    uint32_t processUs; ///< Time spent computing voltage differences
+    uint32_t frameUs;   ///< Time taken by the last complete frame
+    uint32_t adcTransactions; ///< TWI transactions used to read the ADCs during the last frame
+    uint32_t adcBytes;  ///< Bytes on the bus used to read the ADCs during the last frame
+    uint32_t pcaTransactions; ///< TWI transactions used to switch the current sources during the last frame
+    uint32_t pcaBytes;  ///< Bytes on the bus used to switch the current sources during the last frame
+    uint32_t adcConversions; ///< Channel conversions of all ADCs during the last frame
+    uint32_t busyPolls; ///< Busy status reads which found an ADC still converting during the last frame
+    uint32_t frames;    ///< Number of complete frames since startup
+    uint32_t failedSteps; ///< Steps since startup whose switch, trigger or read failed on the bus
+    uint32_t droppedFrames; ///< Frames since startup not published because a read of one of their steps failed
+};
+
+/**
+ * @class EITAcquire
+ * @brief Steps through the excitation states of one EIT frame, overlapping work between them.
+ *
+ * @details The ADC results for excitation n are read, the multiplexer and PCA9956 are
+ * immediately switched to excitation n+1, and the voltage differences for n are then
+ * computed while n+1 is settling. The engine only waits for whatever is left of the
+ * configured settle time instead of a fixed task delay per state. The drive and
+ * measurement pairs come from the precomputed table of the protocol.
+ *
+ * The whole frame is compiled into a schedule with one step per excitation, holding the
+ * multiplexer channel, the PCA9956 register image and the bus traffic of the switch, so
+ * nothing is derived while stepping. The end of each settle time is timed by a one-shot
+ * esp_timer instead of scheduler ticks, so every step starts its reads within
+ * microseconds of the moment it is due; how late each one is is kept in the statistics.
+ *
+ * The ADCs convert on demand: once the electrodes have settled each one is triggered for
+ * a single round of only the channels the excitation measures, as listed in its step. The
+ * engine sleeps for the expected conversion time of the longest round and then polls the
+ * busy status of each ADC as part of its read job, reading the results once it is idle.
+ * With interleaved reads each ADC is instead read as soon as its own round is due, so the
+ * transfer of the first results overlaps the conversions still running on the others.
+ *
+ * Each excitation has its own settle time, which calibrateSettling() can measure.
+ *
+ * Each excitation may also be oversampled: 2^n rounds of conversions are summed per
+ * electrode and decimated by a shift, a first order CIC (boxcar) filter in integers only.
+ * The result keeps n/2 extra bits of resolution, limited by the least oversampled
+ * excitation so that all values of a frame share one scale. The spread of the rounds
+ * within each excitation gives the noise floor of the decimated values.
+ *
+ * Electrodes are wired in banks of 16: each bank has one CD74HC4067SM grounding the sink
+ * electrode, one PCA9956 sourcing current on channels 0-15, and two ADC128D818s reading
+ * electrodes 0-7 and 8-15 of the bank on channels 7-0. Banks share the multiplexer select
+ * pins and are cascaded through their enable pins.
+ *
+ * Every transaction goes through the TWIBus as low priority jobs. Each ADC is read by its
+ * own job, so higher priority transactions of other tasks can run between them. A step
+ * whose reads fail is not processed and its frame is dropped rather than published with
+ * stale values; a failed switch is made again before the next step settles.
+ * @tparam PROTOCOL the EITProtocol to run
+ */
+template <typename PROTOCOL>
+class EITAcquire {
+    public:
+        static constexpr uint8_t electrodes = PROTOCOL::electrodes;
+        static constexpr uint8_t adcCount = (electrodes + 7) / 8;    ///< ADC128D818s, 8 electrodes each
+        static constexpr uint8_t bankCount = (electrodes + 15) / 16; ///< Multiplexer and PCA9956 pairs
+        using Frame = EITFrame<PROTOCOL>;
+
+    private:
+        /// The ADC and result buffer the trigger and read jobs of one ADC work on
+        struct AdcRead {
+            ADC128D818Bulk* adc;
+            uint16_t* codes;
+            TWIJob* job;       // The read job, whose byte count depends on whether the ADC was idle
+            uint8_t disabled;  // Channels the next round of conversions skips
+            bool ready;        // Set by the read job once the round was over and the results read
+            int64_t triggeredAt; // esp_timer_get_time() when the trigger job started the round
+        };
+
+        ADC128D818Bulk adc[adcCount];
+        CD74HC4067SM mux[bankCount];
+        PCA9956Bulk currCtrl[bankCount];
+        const uint8_t* pcaAddress;
+        TWIBus* twi;
+
+        /// Everything needed to switch to one excitation, derived from the protocol at compile time
+        struct Step {
+            uint8_t sinkBank;      ///< Bank whose multiplexer grounds the sink
+            uint8_t sinkChannel;   ///< Multiplexer channel of the sink
+            uint8_t sourceBank;    ///< Bank whose PCA9956 sources the current
+            uint8_t previousBank;  ///< Bank sourcing the current of the step before
+            uint16_t switchBytes;  ///< Bytes the switch to this step puts on the bus
+            uint8_t ledout[PCA9956_BANK_LEDOUT_BYTES]; ///< LEDOUT0-3 of sourceBank, turning on only the source
+            uint8_t adcDisabled[adcCount]; ///< Channels of each ADC no measurement of this step uses
+            uint32_t conversionUs; ///< Expected time of the longest round of conversions of this step
+            uint16_t adcConversionUs[adcCount]; ///< Expected time of the round of each ADC
+        };
+
+        /// The steps of one frame, in excitation order
+        struct Schedule {
+            Step step[electrodes];
+        };
+
+        /*! @brief Compiles the schedule of a frame at compile time
+        * @details Step k switches from excitation k-1 to excitation k, wrapping around
+        * at the start of the frame.
+        * @return the schedule
+        */
+        static constexpr Schedule buildSchedule(void)
+        {
+            Schedule schedule {};
+            for (uint8_t k=0;k<electrodes;k++)
+            {
+                const EITExcitation& exc = PROTOCOL::table.excitation[k];
+                const EITExcitation& before = PROTOCOL::table.excitation[(k + electrodes - 1) % electrodes];
+                Step& step = schedule.step[k];
+                step.sinkBank = exc.sink / 16;
+                step.sinkChannel = exc.sink % 16;
+                step.sourceBank = exc.source / 16;
+                step.previousBank = before.source / 16;
+                step.switchBytes = (step.previousBank == step.sourceBank ? 1 : 2) * PCA9956_LEDOUT_WRITE_BYTES;
+                uint8_t channel = exc.source % 16;
+                step.ledout[channel / 4] = PCA9956_LED_ON << (2 * (channel % 4));
+
+                // Only electrodes in a measurement pair of this excitation are converted
+                bool used[electrodes] {};
+                for (uint8_t i=0;i<exc.count;i++)
+                {
+                    used[PROTOCOL::table.measurement[exc.first + i].plus] = true;
+                    used[PROTOCOL::table.measurement[exc.first + i].minus] = true;
+                }
+                uint8_t longest = 0;
+                for (uint8_t a=0;a<adcCount;a++)
+                {
+                    uint8_t converted = 0;
+                    for (uint8_t c=0;c<8;c++)
+                    {
+                        uint8_t e = a * 8 + 7 - c; // Each ADC records its 8 electrodes in order on channels 7-0
+                        if (e < electrodes && used[e]) {converted++;}
+                        else {step.adcDisabled[a] |= 1 << c;}
+                    }
+                    if (converted > longest) {longest = converted;}
+                    step.adcConversionUs[a] = converted * ADC128D818_CHANNEL_CONVERSION_US;
+                }
+                step.conversionUs = longest * ADC128D818_CHANNEL_CONVERSION_US;
+            }
+            return schedule;
+        }
+
+        /*! @brief Checks that every step drives exactly its source channel
+        * @return true if the schedule is consistent with the protocol
+        */
+        static constexpr bool scheduleValid(void)
+        {
+            for (uint8_t k=0;k<electrodes;k++)
+            {
+                const Step& step = schedule.step[k];
+                uint8_t on = 0;
+                for (uint8_t c=0;c<16;c++)
+                {
+                    uint8_t mode = (step.ledout[c / 4] >> (2 * (c % 4))) & 0x03;
+                    if (mode == PCA9956_LED_ON) {on++;}
+                    else if (mode != 0) {return false;}
+                    if (mode == PCA9956_LED_ON && c != PROTOCOL::table.excitation[k].source % 16) {return false;}
+                }
+                if (on != 1) {return false;}
+                if (step.sinkBank * 16 + step.sinkChannel != PROTOCOL::table.excitation[k].sink) {return false;}
+            }
+            return true;
+        }
+
+        static constexpr Schedule schedule = buildSchedule();
+        static_assert(scheduleValid(), "Each step must drive exactly its source channel and ground its sink");
+
+        /*! @brief Adds a byte to an FNV-1a hash
+        * @param hash the hash so far
+        * @param byte the byte to add
+        * @return the new hash
+        */
+        static constexpr uint32_t hashByte(uint32_t hash, uint8_t byte)
+        {
+            return (hash ^ byte) * 16777619UL;
+        }
+
+        /*! @brief Hashes the drive and measurement pairs of the protocol
+        * @return the signature of the protocol
+        */
+        static constexpr uint32_t buildSignature(void)
+        {
+            uint32_t hash = hashByte(2166136261UL, electrodes);
+            for (uint8_t k=0;k<electrodes;k++)
+            {
+                const EITExcitation& exc = PROTOCOL::table.excitation[k];
+                hash = hashByte(hashByte(hashByte(hash, exc.sink), exc.source), exc.count);
+                for (uint8_t i=0;i<exc.count;i++)
+                {
+                    hash = hashByte(hash, PROTOCOL::table.measurement[exc.first + i].plus);
+                    hash = hashByte(hash, PROTOCOL::table.measurement[exc.first + i].minus);
+                }
+            }
+            return hash;
+        }
+
+        AdcRead adcRead[adcCount];
+        TWIJob triggerJob[adcCount]; // Starts the conversions of one ADC each
+        TWIJob readJob[adcCount];   // Polls and reads one ADC each
+        TWIJob switchJob;           // Switches to the step of the current excitation
+
+        uint32_t settleTime[electrodes]; // Required settle time after switching to each excitation in microseconds
+        bool resetBanks;        // The next switch turns off the sources of every other bank
+        uint8_t excitation;     // Excitation state currently applied to the electrodes
+        int64_t switchedAt;     // esp_timer_get_time() timestamp of the last excitation switch
+        int64_t frameStart;     // esp_timer_get_time() timestamp of the start of the current frame
+        esp_timer_handle_t settleTimer; // Wakes the reading task shortly before a settle time is over
+        TaskHandle_t reader;    // The task calling step()
+        volatile bool settled;  // Set by the settle timer
+        uint32_t maxJitter;     // Latest start of a step in the current frame
+        uint32_t late;          // Steps of the current frame which were due before their wait started
+        uint32_t polls;         // Busy status reads of the current frame which found an ADC converting
+        uint32_t readTotal;     // Sum of readUs over the current frame
+        bool interleaved;       // Read each ADC as soon as its own round is due
+        bool switchFailed;      // The last switch failed, so the next step makes it again
+        bool frameFailed;       // A read of the current frame failed, so it is dropped
+        uint8_t oversampling[electrodes]; // Each excitation sums 2^oversampling rounds of conversions
+        uint8_t fractionBits;   // Extra bits of resolution kept by the decimation
+        float baseScale;        // Calibrated volts per code of a single conversion
+        uint32_t rounds;        // Rounds of conversions of the current frame
+        float noiseSum;         // Sum of the variances of the decimated codes of the current frame
+        uint32_t noiseCount;    // Electrodes in noiseSum
+        bool noiseKnown;        // Every excitation of the current frame so far was oversampled
+        uint32_t sum[electrodes];    // Accumulated codes of one excitation
+        uint32_t sumSq[electrodes];  // Accumulated squared codes of one excitation
+
+        uint16_t adcCodes[adcCount][8]; // Raw ADC codes of each ADC, in channel order
+        uint16_t codes[electrodes]; // ADC codes of all electrodes for one excitation state, with fractionBits extra bits
+        Frame measure;              // Voltage differences for one complete frame
+        EITStats stats;
+
+    public:
+        static constexpr uint32_t signature = buildSignature(); ///< Identifies the protocol calibrations were made for
+
+    private:
+        static_assert(adcCount <= TWI_QUEUE_LENGTH, "The jobs of all ADCs must fit in the bus queue");
+
+        template <size_t... A, size_t... B>
+        EITAcquire(std::index_sequence<A...>,
+            std::index_sequence<B...>,
+            TWIBus* bus,
+            const uint8_t* adcAddresses,
+            const uint8_t* pcaAddresses,
+            const uint8_t* selectPins,
+            const uint8_t* enablePins)
+            : adc{ADC128D818Bulk(bus->getWire(), adcAddresses[A])...},
+              mux{CD74HC4067SM(selectPins[0], selectPins[1], selectPins[2], selectPins[3], enablePins[B])...},
+              currCtrl{PCA9956Bulk(bus->getWire(), pcaAddresses[B])...}
+        {
+            pcaAddress = pcaAddresses;
+            twi = bus;
+            for (uint8_t a=0;a<adcCount;a++)
+            {
+                adcRead[a] = {&adc[a], adcCodes[a], &readJob[a], 0x00, false, 0};
+                initJob(triggerJob[a], adcAddresses[a], 0, runTrigger, &adcRead[a]);
+                initJob(readJob[a], adcAddresses[a], 0, runRead, &adcRead[a]);
+            }
+            initJob(switchJob, pcaAddresses[0], 0, runSwitch, this);
+            setSettleTime(EIT_DEFAULT_SETTLE_US);
+            resetBanks = false;
+            excitation = 0;
+            switchedAt = 0;
+            frameStart = 0;
+            settleTimer = NULL;
+            reader = NULL;
+            settled = true;
+            maxJitter = 0;
+            late = 0;
+            polls = 0;
+            readTotal = 0;
+            interleaved = false;
+            switchFailed = false;
+            frameFailed = false;
+            memset(oversampling, 0, sizeof(oversampling));
+            fractionBits = 0;
+            rounds = 0;
+            noiseSum = 0;
+            noiseCount = 0;
+            noiseKnown = true;
+            memset(adcCodes, 0, sizeof(adcCodes));
+            memset(codes, 0, sizeof(codes));
+            memset(&measure, 0, sizeof(measure));
+            baseScale = ADC128D818_INTERNAL_REF_V / 4096.0f;
+            measure.scale = baseScale;
+            memset(&stats, 0, sizeof(stats));
+        }
+
+    public:
+        /**
+         * @brief Creates an acquisition engine and the EIT devices it drives.
+         *
+         * @param bus manager of the TWI bus the ADCs and PCA9956s are connected to
+         * @param adcAddresses TWI addresses of the adcCount ADCs, in electrode order
+         * @param pcaAddresses TWI addresses of the bankCount PCA9956s, in electrode order
+         * @param selectPins the four select pins s0-s3 shared by all multiplexers
+         * @param enablePins the bankCount multiplexer enable pins, in electrode order; a single
+         *        bank may pass CD74HC4067SM_NO_ENABLE if no output pin reaches its nE
+         */
+        EITAcquire(TWIBus* bus,
+            const uint8_t* adcAddresses,
+            const uint8_t* pcaAddresses,
+            const uint8_t* selectPins,
+            const uint8_t* enablePins)
+            : EITAcquire(std::make_index_sequence<adcCount>(), std::make_index_sequence<bankCount>(),
+                bus, adcAddresses, pcaAddresses, selectPins, enablePins)
+        {
+        }
+
+        /*! @brief Initializes the ADCs and current controllers and applies the first excitation
+        * @details Must succeed before step() is called, and be called from the task which
+        * calls step(), as the settle timer wakes that task through its task notification.
+        * May simply be retried if it fails.
+        * @return true if the devices were initialized
+        */
+        bool begin(void)
+        {
+            reader = xTaskGetCurrentTaskHandle();
+            if (settleTimer == NULL)
+            {
+                esp_timer_create_args_t timerArgs = {};
+                timerArgs.callback = onSettled;
+                timerArgs.arg = this;
+                timerArgs.dispatch_method = ESP_TIMER_TASK;
+                timerArgs.name = "EIT Settle";
+                if (esp_timer_create(&timerArgs, &settleTimer) != ESP_OK) {return false;}
+            }
+            if (twi->run(TWI_CLIENT_EIT, TWI_PRIORITY_LOW, TWI_ANY_DEVICE, 0, runBegin, this) != TWI_JOB_DONE) {return false;}
+
+            clearCounters();
+            switchFailed = false;
+            frameFailed = false;
+            frameStart = switchedAt;
+            return true;
+        }
+
+        /*! @brief Performs one excitation state of the frame
+        * @details Waits out the remaining settle time of the current excitation, converts
+        * and reads the channels it needs on all ADCs, switches to the next step of the
+        * schedule and then computes the voltage differences of the state just read while
+        * the next one settles. Failures on the bus are counted in the statistics.
+        * @return true if this step completed a full frame whose reads all succeeded
+        */
+        bool step(void)
+        {
+            // The electrodes must be in this excitation before they settle
+            if (switchFailed)
+            {
+                switchFailed = !switchTo(excitation, true);
+                if (switchFailed) {stats.failedSteps++; return false;}
+            }
+
+            uint32_t start = micros();
+            waitSettled();
+            stats.settleUs = micros() - start;
+
+            start = micros();
+            bool read = sample(schedule.step[excitation], oversampling[excitation]);
+            stats.readUs = micros() - start;
+            readTotal += stats.readUs;
+
+            // The switch to the next excitation is made before any processing is done,
+            // so it starts settling straight away
+            uint8_t done = excitation;
+            switchFailed = !switchTo(excitation + 1 == electrodes ? 0 : excitation + 1, false);
+            if (!read || switchFailed) {stats.failedSteps++;}
+
+            // Codes which were not read are still those of an earlier step
+            start = micros();
+            if (read) {process(done);}
+            else {frameFailed = true;}
+            stats.processUs = micros() - start;
+
+            if (excitation == 0)
+            {
+                stats.frameUs = (uint32_t)(switchedAt - frameStart);
+                stats.maxJitterUs = maxJitter;
+                stats.lateSteps = late;
+                maxJitter = 0;
+                late = 0;
+                stats.adcTransactions = 0;
+                stats.adcBytes = 0;
+                stats.adcConversions = 0;
+                for (uint8_t a=0;a<adcCount;a++)
+                {
+                    stats.adcTransactions += adc[a].getTransactions();
+                    stats.adcBytes += adc[a].getBytes();
+                    stats.adcConversions += adc[a].getConversions();
+                }
+                stats.busyPolls = polls;
+                polls = 0;
+                stats.frameReadUs = readTotal;
+                readTotal = 0;
+                stats.adcRounds = rounds;
+                stats.noiseFloorUv = noiseKnown && noiseCount ? sqrtf(noiseSum / noiseCount) * baseScale * 1e6f : 0.0f;
+                rounds = 0;
+                noiseSum = 0;
+                noiseCount = 0;
+                noiseKnown = true;
+                stats.pcaTransactions = 0;
+                stats.pcaBytes = 0;
+                for (uint8_t b=0;b<bankCount;b++)
+                {
+                    stats.pcaTransactions += currCtrl[b].getTransactions();
+                    stats.pcaBytes += currCtrl[b].getBytes();
+                }
+                clearCounters();
+                frameStart = switchedAt;
+                if (frameFailed)
+                {
+                    frameFailed = false;
+                    stats.droppedFrames++;
+                    return false;
+                }
+                stats.frames++;
+                measure.sequence = stats.frames;
+                measure.timestamp = millis();
+                return true;
+            }
+            return false;
+        }
+
+        /*! @brief Sets the time allowed for settling after every excitation switch
+        * @param us settle time in microseconds
+        */
+        void setSettleTime(uint32_t us)
+        {
+            for (uint8_t k=0;k<electrodes;k++) {settleTime[k] = us;}
+        }
+
+        /*! @brief Sets the time allowed for settling after switching to one excitation
+        * @param index the excitation
+        * @param us settle time in microseconds
+        */
+        void setSettleTime(uint8_t index, uint32_t us) {settleTime[index] = us;}
+
+        /*! @brief Sets the settle times of all excitations, such as those stored by a calibration
+        * @param us electrodes settle times in microseconds, in excitation order
+        */
+        void setSettleTimes(const uint32_t* us) {memcpy(settleTime, us, sizeof(settleTime));}
+
+        /*! @brief Finds the shortest settle time of every excitation
+        * @details For each excitation the electrodes are settled for maxUs in the excitation
+        * before it, then switched to it exactly as during a frame, and read after maxUs as
+        * a settled reference. The same switch is then repeated with settle times growing by
+        * stepUs until every electrode the excitation measures reads within tolerance of the
+        * reference. That time, or maxUs if none was close enough, becomes the excitation's
+        * settle time. Frames restart from the first excitation afterwards.
+        * @param tolerance ADC codes a settled reading may differ from the reference by
+        * @param stepUs increment of the settle times tried
+        * @param maxUs longest settle time tried
+        * @return false if switching or reading failed, leaving the settle times unchanged
+        */
+        bool calibrateSettling(uint16_t tolerance = EIT_SETTLE_TOLERANCE,
+                               uint32_t stepUs = EIT_SETTLE_STEP_US,
+                               uint32_t maxUs = EIT_SETTLE_MAX_US)
+        {
+            uint32_t found[electrodes];
+            uint16_t reference[electrodes];
+            for (uint8_t k=0;k<electrodes;k++)
+            {
+                if (!trial(k, maxUs, maxUs)) {return false;}
+                memcpy(reference, codes, sizeof(codes));
+
+                found[k] = maxUs;
+                for (uint32_t us=stepUs;us<maxUs;us+=stepUs)
+                {
+                    if (!trial(k, us, maxUs)) {return false;}
+                    if (settledTo(k, reference, tolerance)) {found[k] = us; break;}
+                }
+            }
+            memcpy(settleTime, found, sizeof(settleTime));
+            return restart();
+        }
+
+        /*! @brief Selects how the ADCs are read after they have been triggered
+        * @param enable true to read each ADC as soon as its own round is due, while the
+        * others may still be converting, false to read them all once the longest is due
+        */
+        void setInterleavedReads(bool enable) {interleaved = enable;}
+
+        /*! @brief Gets how the ADCs are read after they have been triggered
+        * @return true if each ADC is read as soon as its own round is due
+        */
+        bool getInterleavedReads(void) {return interleaved;}
+
+        /*! @brief Gets the time allowed for settling after switching to one excitation
+        * @param index the excitation
+        * @return settle time in microseconds
+        */
+        uint32_t getSettleTime(uint8_t index) {return settleTime[index];}
+
+        /*! @brief Gets the settle times of all excitations, such as for storing a calibration
+        * @return electrodes settle times in microseconds, in excitation order
+        */
+        const uint32_t* getSettleTimes(void) {return settleTime;}
+
+        /*! @brief Sets the calibrated conversion from ADC codes to volts
+        * @param voltsPerCode volts represented by one ADC code
+        */
+        void setScale(float voltsPerCode)
+        {
+            baseScale = voltsPerCode;
+            measure.scale = baseScale / (1 << fractionBits);
+        }
+
+        /*! @brief Sets how many rounds of conversions every excitation averages
+        * @param shift each excitation sums 2^shift rounds, up to EIT_MAX_OVERSAMPLING_SHIFT
+        */
+        void setOversampling(uint8_t shift)
+        {
+            for (uint8_t k=0;k<electrodes;k++) {oversampling[k] = min(shift, (uint8_t)EIT_MAX_OVERSAMPLING_SHIFT);}
+            updateResolution();
+        }
+
+        /*! @brief Sets how many rounds of conversions one excitation averages
+        * @param index the excitation
+        * @param shift the excitation sums 2^shift rounds, up to EIT_MAX_OVERSAMPLING_SHIFT
+        */
+        void setOversampling(uint8_t index, uint8_t shift)
+        {
+            oversampling[index] = min(shift, (uint8_t)EIT_MAX_OVERSAMPLING_SHIFT);
+            updateResolution();
+        }
+
+        /*! @brief Gets how many rounds of conversions one excitation averages
+        * @param index the excitation
+        * @return the shift, the excitation summing 2^shift rounds
+        */
+        uint8_t getOversampling(uint8_t index) {return oversampling[index];}
+
+        /*! @brief Gets the voltage differences of the last complete frame
+        * @details Only consistent directly after step() has returned true.
+        * @return reference to the frame holding all measurements
+        */
+        const Frame& frame(void) {return measure;}
+
+        /*! @brief Gets the timing of the latest step and frame
+        * @return reference to the engine's statistics
+        */
+        const EITStats& getStats(void) {return stats;}
+
+    private:
+        /*! @brief Fills in the fixed parts of one of the engine's bus jobs
+        * @param job the job
+        * @param address the device the job talks to, which selects its clock
+        * @param bytes bytes the job puts on the bus, or 0 if unknown
+        * @param function the job function
+        * @param context passed to function
+        */
+        static void initJob(TWIJob& job, uint8_t address, uint16_t bytes, TWIJobFunction function, void* context)
+        {
+            job.function = function;
+            job.context = context;
+            job.client = TWI_CLIENT_EIT;
+            job.priority = TWI_PRIORITY_LOW;
+            job.address = address;
+            job.bytes = bytes;
+            job.deadline = portMAX_DELAY;
+            job.status = TWI_JOB_DONE;
+        }
+
+        /*! @brief Bus job initializing every device and applying the first excitation
+        * @param context the engine
+        * @return true if every ADC and current controller initialized and the excitation was applied
+        */
+        static bool runBegin(void* context)
+        {
+            EITAcquire* engine = (EITAcquire*)context;
+
+            // All ADCs read voltages on channels 0-7, converting only when triggered
+            for (uint8_t a=0;a<adcCount;a++)
+            {
+                if (!engine->adc[a].begin(true)) {return false;}
+            }
+            for (uint8_t b=0;b<bankCount;b++)
+            {
+                if (!engine->currCtrl[b].begin(0xFF)) {return false;} // All outputs off at the maximum current
+            }
+
+            engine->excitation = 0;
+            return engine->applyStep(engine->schedule.step[0], true);
+        }
+
+        /*! @brief Bus job starting one round of conversions of the channels one ADC needs
+        * @param context the AdcRead to start
+        * @return true if the ADC accepted the channel mask and the trigger
+        */
+        static bool runTrigger(void* context)
+        {
+            AdcRead* read = (AdcRead*)context;
+            if (!read->adc->setDisabledChannels(read->disabled)) {return false;}
+            read->triggeredAt = esp_timer_get_time();
+            return read->adc->startOneShot();
+        }
+
+        /*! @brief Bus job reading every channel of one ADC once it has finished converting
+        * @details Leaves ready clear if the ADC is still busy, so the job can be run again.
+        * @param context the AdcRead to perform
+        * @return true if the status and any results were received
+        */
+        static bool runRead(void* context)
+        {
+            AdcRead* read = (AdcRead*)context;
+            bool busy;
+            read->job->bytes = ADC128D818_BUSY_BYTES;
+            if (!read->adc->readBusy(busy)) {return false;}
+            if (busy) {return true;}
+
+            read->job->bytes += ADC128D818_READ_ALL_BYTES;
+            read->ready = read->adc->readAll(read->codes);
+            return read->ready;
+        }
+
+        /*! @brief Bus job switching to the step of the current excitation
+        * @param context the engine
+        * @return true if every current controller took its new outputs
+        */
+        static bool runSwitch(void* context)
+        {
+            EITAcquire* engine = (EITAcquire*)context;
+            uint32_t start = micros();
+            bool switched = engine->applyStep(engine->schedule.step[engine->excitation], engine->resetBanks);
+            engine->stats.switchUs = micros() - start;
+            return switched;
+        }
+
+        /*! @brief Switches the electrodes to a step of the schedule
+        * @details The sink electrode of the excitation is grounded through the multiplexer
+        * of its bank and its source electrode is supplied with current by the PCA9956 of
+        * its bank. The sink is moved first, then the precomputed register image of the
+        * step is written to the PCA9956. Must only be called from a bus job.
+        * @param step the step to apply
+        * @param allBanks true to turn off the sources of every other bank, rather than only
+        * that of the step before
+        * @return true if every current controller took its new outputs
+        */
+        bool applyStep(const Step& step, bool allBanks)
+        {
+            static const uint8_t off[PCA9956_BANK_LEDOUT_BYTES] = {0};
+
+            // Use multiplexer to ground the appropriate pin, gated if its nE is driven
+            if (bankCount > 1)
+            {
+                // Only the multiplexer of the sink's bank may pass the ground through
+                for (uint8_t b=0;b<bankCount;b++) {mux[b].disable();}
+                mux[step.sinkBank].switchPin(step.sinkChannel);
+                mux[step.sinkBank].enable();
+            }
+            else {mux[0].switchPin(step.sinkChannel, true);}
+            // Stop producing current in the old bank
+            bool switched = true;
+            for (uint8_t b=0;b<bankCount;b++)
+            {
+                if (b != step.sourceBank && (allBanks || b == step.previousBank)) {switched = currCtrl[b].writeLedOut(off) && switched;}
+            }
+            switched = currCtrl[step.sourceBank].writeLedOut(step.ledout) && switched; // Only the new source produces current
+            switchedAt = esp_timer_get_time();
+            return switched;
+        }
+
+        /*! @brief Called by esp_timer shortly before the settle time is over
+        * @param arg the engine
+        */
+        static void onSettled(void* arg)
+        {
+            EITAcquire* engine = (EITAcquire*)arg;
+            engine->settled = true;
+            xTaskNotify(engine->reader, EIT_NOTIFY_SETTLED, eSetBits);
+        }
+
+        /*! @brief Blocks until an esp_timer_get_time() timestamp
+        * @details The task sleeps on the settle timer, which wakes it EIT_WAKE_LEAD_US
+        * early, and busy waits the rest so it returns on time. The flag rather than
+        * the notification is what ends the wait, as the bus may also notify this task.
+        * @param due the timestamp to wait for
+        * @return the time it returned at
+        */
+        int64_t sleepUntil(int64_t due)
+        {
+            int64_t remaining = due - esp_timer_get_time();
+            if (remaining > EIT_WAKE_LEAD_US)
+            {
+                settled = false;
+                if (esp_timer_start_once(settleTimer, remaining - EIT_WAKE_LEAD_US) == ESP_OK)
+                {
+                    while (!settled) {xTaskNotifyWait(0, EIT_NOTIFY_SETTLED, NULL, portMAX_DELAY);}
+                }
+            }
+
+            int64_t now;
+            while ((now = esp_timer_get_time()) < due) {}
+            return now;
+        }
+
+        /*! @brief Blocks until the settle time since the last switch has elapsed
+        */
+        void waitSettled(void)
+        {
+            int64_t due = switchedAt + settleTime[excitation];
+            if (due <= esp_timer_get_time()) {late++;}
+            stats.jitterUs = (uint32_t)(sleepUntil(due) - due);
+            if (stats.jitterUs > maxJitter) {maxJitter = stats.jitterUs;}
+        }
+
+        /*! @brief Converts and reads the channels a step measures on every ADC
+        * @details All ADCs are triggered back to back and convert in parallel. The task
+        * then either sleeps for the expected length of the longest round and reads them all,
+        * or reads each one as soon as its own round is due, in the order they finish.
+        * @param step the step applied to the electrodes
+        * @return true if every ADC was triggered and read
+        */
+        bool convert(const Step& step)
+        {
+            for (uint8_t a=0;a<adcCount;a++)
+            {
+                adcRead[a].disabled = step.adcDisabled[a];
+                adcRead[a].ready = false;
+                triggerJob[a].bytes = (adc[a].getDisabledChannels() == step.adcDisabled[a] ? 1 : 2) * ADC128D818_WRITE_BYTES;
+                twi->submit(triggerJob[a]);
+            }
+            bool triggered = true;
+            for (uint8_t a=0;a<adcCount;a++) {triggered = twi->wait(triggerJob[a]) == TWI_JOB_DONE && triggered;}
+            if (!triggered) {return false;} // Reading a round which never started would give the last results
+
+            bool pending[adcCount];
+            if (!interleaved)
+            {
+                sleepUntil(esp_timer_get_time() + step.conversionUs);
+                for (uint8_t a=0;a<adcCount;a++) {pending[a] = true;}
+                return readWhenIdle(pending);
+            }
+
+            // Order the ADCs by when their rounds are due to finish
+            uint8_t order[adcCount];
+            int64_t due[adcCount];
+            for (uint8_t a=0;a<adcCount;a++)
+            {
+                due[a] = adcRead[a].triggeredAt + step.adcConversionUs[a];
+                uint8_t i = a;
+                for (;i>0 && due[order[i - 1]] > due[a];i--) {order[i] = order[i - 1];}
+                order[i] = a;
+            }
+            for (uint8_t i=0;i<adcCount;i++)
+            {
+                for (uint8_t a=0;a<adcCount;a++) {pending[a] = a == order[i];}
+                sleepUntil(due[order[i]]);
+                if (!readWhenIdle(pending)) {return false;}
+            }
+            return true;
+        }
+
+        /*! @brief Polls ADCs until they are idle and their results have been read
+        * @details A failed job or an ADC which stays busy keeps its previous results
+        * rather than stalling the frame.
+        * @param pending true for each ADC to read, cleared as they are read
+        * @return true if every ADC was read
+        */
+        bool readWhenIdle(bool (&pending)[adcCount])
+        {
+            bool read = true;
+            for (uint8_t poll=0;poll<EIT_MAX_BUSY_POLLS;poll++)
+            {
+                for (uint8_t a=0;a<adcCount;a++)
+                {
+                    if (pending[a]) {twi->submit(readJob[a]);}
+                }
+                bool busy = false;
+                for (uint8_t a=0;a<adcCount;a++)
+                {
+                    if (!pending[a]) {continue;}
+                    // A failed read is not retried
+                    bool done = twi->wait(readJob[a]) == TWI_JOB_DONE;
+                    if (!done) {read = false;}
+                    pending[a] = done && !adcRead[a].ready;
+                    if (pending[a]) {busy = true; polls++;}
+                }
+                if (!busy) {return read;}
+            }
+            return false; // Still converting
+        }
+
+        /*! @brief Switches the electrodes to an excitation and waits for the switch
+        * @param index the excitation to apply
+        * @param allBanks true to turn off the sources of every other bank, when the
+        * excitation applied is not the one before index
+        * @return true if the switch was made
+        */
+        bool switchTo(uint8_t index, bool allBanks)
+        {
+            const Step& step = schedule.step[index];
+            excitation = index;
+            resetBanks = allBanks;
+            switchJob.address = pcaAddress[step.sourceBank];
+            switchJob.bytes = allBanks ? bankCount * PCA9956_LEDOUT_WRITE_BYTES : step.switchBytes;
+            twi->submit(switchJob);
+            return twi->wait(switchJob) == TWI_JOB_DONE;
+        }
+
+        /*! @brief Starts a new frame from the first excitation, discarding the current one
+        * @return true if the first excitation was applied
+        */
+        bool restart(void)
+        {
+            if (!switchTo(0, true)) {return false;}
+            clearCounters();
+            switchFailed = false;
+            frameFailed = false;
+            maxJitter = 0;
+            late = 0;
+            polls = 0;
+            readTotal = 0;
+            rounds = 0;
+            noiseSum = 0;
+            noiseCount = 0;
+            noiseKnown = true;
+            frameStart = switchedAt;
+            return true;
+        }
+
+        /*! @brief Keeps the extra resolution every excitation's oversampling supports
+        * @details Frames are only restarted by the caller, so a frame in progress while
+        * this changes mixes two scales once.
+        */
+        void updateResolution(void)
+        {
+            uint8_t least = EIT_MAX_OVERSAMPLING_SHIFT;
+            for (uint8_t k=0;k<electrodes;k++) {least = min(least, oversampling[k]);}
+            fractionBits = least / 2;
+            measure.scale = baseScale / (1 << fractionBits);
+        }
+
+        /*! @brief Converts and reads every electrode 2^shift times and decimates the sums
+        * @details Leaves the decimated codes, with fractionBits extra bits, in codes and
+        * adds the variance of the decimated codes of every converted electrode to the
+        * noise floor of the frame.
+        * @param step the step applied to the electrodes
+        * @param shift log2 of the rounds of conversions to sum
+        * @return true if every round was read, otherwise codes are not those of this step
+        */
+        bool sample(const Step& step, uint8_t shift)
+        {
+            uint16_t count = 1 << shift;
+            memset(sum, 0, sizeof(sum));
+            memset(sumSq, 0, sizeof(sumSq));
+            for (uint16_t r=0;r<count;r++)
+            {
+                if (!convert(step)) {return false;}
+                gatherCodes();
+                for (uint8_t e=0;e<electrodes;e++)
+                {
+                    sum[e] += codes[e];
+                    sumSq[e] += (uint32_t)codes[e] * codes[e];
+                }
+            }
+            rounds += count;
+
+            uint32_t half = shift > 0 ? 1UL << (shift - 1) : 0;
+            for (uint8_t e=0;e<electrodes;e++)
+            {
+                codes[e] = ((sum[e] << fractionBits) + half) >> shift;
+            }
+
+            if (shift == 0) {noiseKnown = false; return true;} // A single read has no spread
+            for (uint8_t e=0;e<electrodes;e++)
+            {
+                if (step.adcDisabled[e / 8] & (1 << (7 - e % 8))) {continue;} // Not converted
+                // Exact in integers, as the two terms nearly cancel; only the quotient is rounded
+                int64_t spread = (int64_t)count * sumSq[e] - (int64_t)sum[e] * sum[e];
+                noiseSum += (float)spread / ((uint32_t)count * count * (count - 1)); // Variance of the mean of count reads
+                noiseCount++;
+            }
+            return true;
+        }
+
+        /*! @brief Reads all electrodes after one settle time of an excitation
+        * @details Settles for maxUs in the excitation before, so every trial starts alike.
+        * @param index the excitation
+        * @param us settle time to read after
+        * @param maxUs time the excitation before is settled for
+        * @return true if both switches were made and the electrodes read
+        */
+        bool trial(uint8_t index, uint32_t us, uint32_t maxUs)
+        {
+            if (!switchTo((index + electrodes - 1) % electrodes, true)) {return false;}
+            sleepUntil(switchedAt + maxUs);
+            if (!switchTo(index, false)) {return false;}
+            sleepUntil(switchedAt + us);
+            if (!convert(schedule.step[index])) {return false;}
+            gatherCodes();
+            return true;
+        }
+
+        /*! @brief Checks whether every electrode an excitation measures reads close to a reference
+        * @param index the excitation
+        * @param reference codes of all electrodes when settled
+        * @param tolerance ADC codes a reading may differ from the reference by
+        * @return true if the latest reading is settled
+        */
+        bool settledTo(uint8_t index, const uint16_t* reference, uint16_t tolerance)
+        {
+            const EITExcitation& exc = PROTOCOL::table.excitation[index];
+            for (uint8_t i=0;i<exc.count;i++)
+            {
+                const EITMeasurement& pair = PROTOCOL::table.measurement[exc.first + i];
+                if (abs((int16_t)codes[pair.plus] - (int16_t)reference[pair.plus]) > tolerance) {return false;}
+                if (abs((int16_t)codes[pair.minus] - (int16_t)reference[pair.minus]) > tolerance) {return false;}
+            }
+            return true;
+        }
+
+        /*! @brief Collects the codes of all electrodes from the results of every ADC
+        */
+        void gatherCodes(void)
+        {
+            // Each ADC records its 8 electrodes in order on channels 7-0
+            for (uint8_t e=0;e<electrodes;e++) {codes[e] = adcCodes[e / 8][7 - e % 8];}
+        }
+
+        /*! @brief Finds the voltage differences for one excitation state
+        * @details Walks the measurement pairs the protocol table lists for the excitation,
+        * which already leave out the grounded and current pins and are stored in frame order.
+        * @param index the excitation state the codes belong to
+        */
+        void process(uint8_t index)
+        {
+            const EITExcitation& exc = PROTOCOL::table.excitation[index];
+            const EITMeasurement* pair = &PROTOCOL::table.measurement[exc.first];
+            int16_t* out = &measure.values[exc.first];
+            for (uint8_t i=0;i<exc.count;i++)
+            {
+                out[i] = (int16_t)codes[pair[i].plus] - (int16_t)codes[pair[i].minus];
+            }
+        }
+
+        /*! @brief Clears the transaction and byte counters of every ADC and current controller
+        */
+        void clearCounters(void)
+        {
+            for (uint8_t a=0;a<adcCount;a++) {adc[a].clearCounters();}
+            for (uint8_t b=0;b<bankCount;b++) {currCtrl[b].clearCounters();}
+        }
+};
+
+#endif //__EITACQUIRE_H__
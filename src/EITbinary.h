@@ -0,0 +1,206 @@
+/*!
+ * @file EITbinary.h
+ * @author Setting-Dawn
+ * @brief Fixed little-endian binary encoding of an EIT frame, with a matching decoder.
+ * @details Only depends on the C++ standard library, so the same header is used by the
+ * ESP32 to encode frames and by host programs to decode them.
+ *
+ * Layout, all fields little-endian:
+ * | offset | size | field                                         |
+ * |--------|------|-----------------------------------------------|
+ * | 0      | 4    | magic, the bytes "EITF"                       |
+ * | 4      | 2    | version                                       |
+ * | 6      | 2    | header size in bytes                          |
+ * | 8      | 4    | frame sequence number                         |
+ * | 12     | 4    | frame timestamp, ms since startup             |
+ * | 16     | 1    | electrode count                               |
+ * | 17     | 1    | flags                                         |
+ * | 18     | 2    | value count                                   |
+ * | 20     | 4    | volts per ADC code, float32                   |
+ * | 24     | ...  | values, int16 ADC codes or float32 volts      |
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __EITBINARY_H__
+#define __EITBINARY_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define EIT_BINARY_MAGIC       0x46544945UL // "EITF" read as a little-endian uint32
+#define EIT_BINARY_VERSION     1
+#define EIT_BINARY_HEADER_SIZE 24
+
+#define EIT_BINARY_FLAG_FLOAT32    0x01 ///< Values are float32 volts instead of int16 codes
+#define EIT_BINARY_FLAG_INITIALIZE 0x02 ///< initializeFLG was set when the frame was sent
+#define EIT_BINARY_FLAG_READ       0x04 ///< readFLG was set when the frame was sent
+
+/**
+ * @struct EITBinaryHeader
+ * @brief Decoded header of a binary EIT frame.
+ */
+struct EITBinaryHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t sequence;
+    uint32_t timestamp;
+    uint8_t electrodes;
+    uint8_t flags;
+    uint16_t count;
+    float scale;
+};
+
+/*! @brief Gets the encoded size of a frame
+* @param count number of values in the frame
+* @param flags the flags the frame is encoded with
+* @return the size of header and payload in bytes
+*/
+inline size_t EITbinary_size(uint16_t count, uint8_t flags)
+{
+    return EIT_BINARY_HEADER_SIZE + (size_t)count * ((flags & EIT_BINARY_FLAG_FLOAT32) ? 4 : 2);
+}
+
+/*! @brief Stores a 16 bit value little-endian
+* @param p where to store the value
+* @param v the value
+*/
+inline void EITbinary_put16(uint8_t* p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+/*! @brief Stores a 32 bit value little-endian
+* @param p where to store the value
+* @param v the value
+*/
+inline void EITbinary_put32(uint8_t* p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+}
+
+/*! @brief Loads a little-endian 16 bit value
+* @param p where the value is stored
+* @return the value
+*/
+inline uint16_t EITbinary_get16(const uint8_t* p) {return (uint16_t)(p[0] | p[1] << 8);}
+
+/*! @brief Loads a little-endian 32 bit value
+* @param p where the value is stored
+* @return the value
+*/
+inline uint32_t EITbinary_get32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/*! @brief Encodes a frame into a caller supplied buffer
+* @param frame an EITFrame
+* @param flags EIT_BINARY_FLAG_* bits; EIT_BINARY_FLAG_FLOAT32 selects volts instead of codes
+* @param buf the buffer receiving the encoded frame
+* @param len size of buf in bytes
+* @return the number of bytes written, 0 if buf is too small
+*/
+template <typename FRAME>
+size_t EITbinary_encode(const FRAME& frame, uint8_t flags, uint8_t* buf, size_t len)
+{
+    size_t size = EITbinary_size(FRAME::measurements, flags);
+    if (len < size) {return 0;}
+
+    uint32_t scaleBits;
+    memcpy(&scaleBits, &frame.scale, 4);
+
+    EITbinary_put32(buf, EIT_BINARY_MAGIC);
+    EITbinary_put16(buf + 4, EIT_BINARY_VERSION);
+    EITbinary_put16(buf + 6, EIT_BINARY_HEADER_SIZE);
+    EITbinary_put32(buf + 8, frame.sequence);
+    EITbinary_put32(buf + 12, frame.timestamp);
+    buf[16] = FRAME::electrodes;
+    buf[17] = flags;
+    EITbinary_put16(buf + 18, FRAME::measurements);
+    EITbinary_put32(buf + 20, scaleBits);
+
+    uint8_t* p = buf + EIT_BINARY_HEADER_SIZE;
+    for (uint16_t n = 0; n < FRAME::measurements; n++)
+    {
+        if (flags & EIT_BINARY_FLAG_FLOAT32)
+        {
+            float v = frame.volts(n);
+            uint32_t bits;
+            memcpy(&bits, &v, 4);
+            EITbinary_put32(p, bits);
+            p += 4;
+        }
+        else
+        {
+            EITbinary_put16(p, (uint16_t)frame.values[n]);
+            p += 2;
+        }
+    }
+    return size;
+}
+
+/*! @brief Decodes and validates the header of an encoded frame
+* @param buf the received bytes
+* @param len number of received bytes
+* @param header receives the decoded header
+* @return true if the magic and version are recognized and the whole frame was received
+*/
+inline bool EITbinary_decodeHeader(const uint8_t* buf, size_t len, EITBinaryHeader& header)
+{
+    if (len < EIT_BINARY_HEADER_SIZE) {return false;}
+
+    uint32_t scaleBits = EITbinary_get32(buf + 20);
+    header.magic = EITbinary_get32(buf);
+    header.version = EITbinary_get16(buf + 4);
+    header.headerSize = EITbinary_get16(buf + 6);
+    header.sequence = EITbinary_get32(buf + 8);
+    header.timestamp = EITbinary_get32(buf + 12);
+    header.electrodes = buf[16];
+    header.flags = buf[17];
+    header.count = EITbinary_get16(buf + 18);
+    memcpy(&header.scale, &scaleBits, 4);
+
+    return header.magic == EIT_BINARY_MAGIC
+        && header.version == EIT_BINARY_VERSION
+        && header.headerSize >= EIT_BINARY_HEADER_SIZE
+        && len >= header.headerSize + EITbinary_size(header.count, header.flags) - EIT_BINARY_HEADER_SIZE;
+}
+
+/*! @brief Decodes an encoded frame into volts
+* @param buf the received bytes
+* @param len number of received bytes
+* @param header receives the decoded header
+* @param volts receives up to maxValues voltage differences
+* @param maxValues capacity of volts
+* @return the number of values decoded, 0 if the frame is invalid or does not fit
+*/
+inline size_t EITbinary_decode(const uint8_t* buf, size_t len, EITBinaryHeader& header, float* volts, size_t maxValues)
+{
+    if (!EITbinary_decodeHeader(buf, len, header) || header.count > maxValues) {return 0;}
+
+    const uint8_t* p = buf + header.headerSize;
+    for (uint16_t n = 0; n < header.count; n++)
+    {
+        if (header.flags & EIT_BINARY_FLAG_FLOAT32)
+        {
+            uint32_t bits = EITbinary_get32(p);
+            memcpy(&volts[n], &bits, 4);
+            p += 4;
+        }
+        else
+        {
+            volts[n] = (int16_t)EITbinary_get16(p) * header.scale;
+            p += 2;
+        }
+    }
+    return header.count;
+}
+
+#endif //__EITBINARY_H__
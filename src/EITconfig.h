@@ -0,0 +1,47 @@
+/*!
+ * @file EITconfig.h
+ * @author Setting-Dawn
+ * @brief Compile-time selection of the EIT electrode count and excitation pattern.
+ * @details Override EIT_ELECTRODES (8, 16 or 32), EIT_PATTERN (and EIT_SKIP for the skip-n pattern) with build flags,
+ * for example -DEIT_PATTERN=EIT_PATTERN_OPPOSITE. Opposite and skip-n patterns take fewer
+ * measurements per excitation, so frames are smaller. ExternalInterpret.py must use the
+ * matching dist_exc.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __EITCONFIG_H__
+#define __EITCONFIG_H__
+
+#include "EITprotocol.h"
+#include "EITacquire.h"
+
+#ifndef EIT_ELECTRODES
+#define EIT_ELECTRODES 16
+#endif
+
+#define EIT_PATTERN_ADJACENT 0
+#define EIT_PATTERN_OPPOSITE 1
+#define EIT_PATTERN_SKIP     2
+
+#ifndef EIT_PATTERN
+#define EIT_PATTERN EIT_PATTERN_ADJACENT
+#endif
+
+#ifndef EIT_SKIP
+#define EIT_SKIP 2
+#endif
+
+/// The protocol the acquisition engine runs
+using EITActiveProtocol = EITProtocolOf<EIT_ELECTRODES, (EITPattern)EIT_PATTERN, EIT_SKIP>;
+/// The frame the acquisition engine produces and the web host serves
+using EITActiveFrame = EITFrame<EITActiveProtocol>;
+/// The acquisition engine for the configured sheet
+using EITActiveAcquire = EITAcquire<EITActiveProtocol>;
+
+static_assert(EIT_ELECTRODES % 8 == 0 && EIT_ELECTRODES <= 32, "Electrodes come in groups of 8 per ADC, up to two banks of 16");
+static_assert(sizeof(EITFrame<EITProtocolOf<8, EITPattern::Adjacent>>::values) == 80, "8 electrode frame size");
+static_assert(sizeof(EITFrame<EITProtocolOf<16, EITPattern::Adjacent>>::values) == 416, "16 electrode frame size");
+static_assert(sizeof(EITFrame<EITProtocolOf<32, EITPattern::Adjacent>>::values) == 1856, "32 electrode frame size");
+
+#endif //__EITCONFIG_H__
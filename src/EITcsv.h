@@ -0,0 +1,199 @@
+/*!
+ * @file EITcsv.h
+ * @author Setting-Dawn
+ * @brief Streaming CSV encoding of an EIT frame without heap allocation.
+ * @details The text is identical to the page /data has always served:
+ *
+ *     Voltage Readings,<v0>,<v1>,...,<vN-1>,
+ *     initializeFLG,<0|1>
+ *     readFLG,<0|1>
+ *
+ * with every voltage printed to 8 decimal places as String(value, 8) does. Voltages
+ * are formatted with integer arithmetic on the exact value of the float, and the
+ * text is produced a field at a time into whatever buffer the caller provides.
+ * Only depends on the C++ standard library, like EITbinary.h.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __EITCSV_H__
+#define __EITCSV_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define EIT_CSV_FIELD_MAX 64 ///< Longest single field, including its separators
+
+/**
+ * @struct EITCsvState
+ * @brief Progress of one CSV encoding, kept by the caller between calls to EITcsv_write().
+ */
+struct EITCsvState {
+    uint16_t field;  ///< Next field to format: the label, each value, then the two flag lines
+    uint8_t length;  ///< Length of the formatted field
+    uint8_t sent;    ///< Characters of the formatted field already written out
+    char text[EIT_CSV_FIELD_MAX]; ///< The formatted field
+};
+
+/*! @brief Prints a value to 8 decimal places exactly as the Arduino dtostrf() does
+* @details Adds half of the last digit and walks the digits in double precision. The
+* rounding errors of that walk decide how exact halves come out, so it is kept for
+* them and for values outside the range of EITcsv_formatVolts().
+* @param number the value
+* @param out buffer of at least EIT_CSV_FIELD_MAX characters, not terminated
+* @return number of characters written
+*/
+inline size_t EITcsv_formatDouble(double number, char* out)
+{
+    if (number != number) {memcpy(out, "nan", 3); return 3;}
+    if (number - number != 0.0) {memcpy(out, "inf", 3); return 3;}
+
+    char* p = out;
+    if (number < 0.0) {*p++ = '-'; number = -number;}
+    number += 1.0 / 200000000.0;
+
+    double tenpow = 1.0;
+    int8_t digits = 1;
+    while (number >= 10.0 * tenpow) {tenpow *= 10.0; digits++;}
+    number /= tenpow;
+
+    digits += 8;
+    while (digits-- > 0)
+    {
+        int8_t digit = (int8_t)number;
+        if (digit > 9) {digit = 9;}
+        *p++ = '0' + digit;
+        if (digits == 8) {*p++ = '.';}
+        number -= digit;
+        number *= 10.0;
+    }
+    return p - out;
+}
+
+/*! @brief Prints a voltage to 8 decimal places
+* @details Gives the same text as the Arduino dtostrf() used by String(value, 8),
+* including a sign on negative values which round to zero. Values below 16 V,
+* which covers every ADC reading, are formatted by scaling the float's mantissa
+* by 10^8 in 64-bit integers and rounding once. Only exact halves and larger
+* values take the double precision path of EITcsv_formatDouble().
+* @param value the voltage
+* @param out buffer of at least EIT_CSV_FIELD_MAX characters, not terminated
+* @return number of characters written
+*/
+inline size_t EITcsv_formatVolts(float value, char* out)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent >= 127 + 4) {return EITcsv_formatDouble(value, out);}
+
+    // value = mantissa * 2^-shift, with shift >= 20 in this range
+    if (exponent == 0) {exponent = 1;} else {mantissa |= 0x800000;}
+    int shift = 150 - exponent;
+    uint32_t fixed = 0; // |value| * 10^8, rounded
+    if (shift < 64)
+    {
+        uint64_t scaled = (uint64_t)mantissa * 100000000ULL; // Below 2^51
+        uint64_t half = 1ULL << (shift - 1);
+        if ((scaled & (2 * half - 1)) == half) {return EITcsv_formatDouble(value, out);}
+        fixed = (uint32_t)((scaled + half) >> shift);
+    }
+
+    char* p = out;
+    if (value < 0.0f) {*p++ = '-';}
+    uint32_t whole = fixed / 100000000UL;
+    uint32_t fraction = fixed % 100000000UL;
+    if (whole >= 10) {*p++ = '0' + whole / 10;}
+    *p++ = '0' + whole % 10;
+    *p++ = '.';
+    for (int8_t d = 7; d >= 0; d--)
+    {
+        p[d] = '0' + fraction % 10;
+        fraction /= 10;
+    }
+    return p + 8 - out;
+}
+
+/*! @brief Prepares a state to encode a new frame from its start
+* @param state the state to reset
+*/
+inline void EITcsv_begin(EITCsvState& state)
+{
+    state.field = 0;
+    state.length = 0;
+    state.sent = 0;
+}
+
+/*! @brief Formats the next field of the CSV text
+* @param frame the frame being encoded
+* @param initialize value of initializeFLG
+* @param read value of readFLG
+* @param state progress of the encoding, receives the formatted field
+* @return false once every field has been formatted
+*/
+template <typename FRAME>
+bool EITcsv_nextField(const FRAME& frame, bool initialize, bool read, EITCsvState& state)
+{
+    uint16_t field = state.field;
+    size_t length;
+    if (field == 0)
+    {
+        length = strlen("Voltage Readings,");
+        memcpy(state.text, "Voltage Readings,", length);
+    }
+    else if (field <= FRAME::measurements)
+    {
+        length = EITcsv_formatVolts(frame.volts(field - 1), state.text);
+        state.text[length++] = ',';
+    }
+    else if (field == FRAME::measurements + 1)
+    {
+        length = strlen("\ninitializeFLG,0\n");
+        memcpy(state.text, "\ninitializeFLG,0\n", length);
+        state.text[length - 2] = initialize ? '1' : '0';
+    }
+    else if (field == FRAME::measurements + 2)
+    {
+        length = strlen("readFLG,0\n");
+        memcpy(state.text, "readFLG,0\n", length);
+        state.text[length - 2] = read ? '1' : '0';
+    }
+    else {return false;}
+
+    state.field++;
+    state.length = length;
+    state.sent = 0;
+    return true;
+}
+
+/*! @brief Writes as much of the CSV text of a frame as fits in a buffer
+* @details Call repeatedly with the same state until it returns 0. A field which
+* does not fit is continued by the next call, so any buffer size works.
+* @param frame the frame to encode
+* @param initialize value of initializeFLG
+* @param read value of readFLG
+* @param state progress of the encoding, started with EITcsv_begin()
+* @param buf buffer the text is written to, not terminated
+* @param len size of buf in bytes
+* @return number of bytes written, 0 once the whole text has been written
+*/
+template <typename FRAME>
+size_t EITcsv_write(const FRAME& frame, bool initialize, bool read, EITCsvState& state, uint8_t* buf, size_t len)
+{
+    size_t written = 0;
+    while (written < len)
+    {
+        if (state.sent == state.length && !EITcsv_nextField(frame, initialize, read, state)) {break;}
+
+        size_t n = state.length - state.sent;
+        if (n > len - written) {n = len - written;}
+        memcpy(buf + written, state.text + state.sent, n);
+        state.sent += n;
+        written += n;
+    }
+    return written;
+}
+
+#endif //__EITCSV_H__
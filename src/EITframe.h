@@ -0,0 +1,39 @@
+/*!
+ * @file EITframe.h
+ * @author Setting-Dawn
+ * @brief Integer representation of one complete EIT measurement.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __EITFRAME_H__
+#define __EITFRAME_H__
+
+#include <Arduino.h>
+
+/**
+ * @struct EITFrame
+ * @brief The voltage differences of one frame kept as signed ADC code differences.
+ *
+ * @details Values stay integers from the ADC all the way to the consumer. A single
+ * scale factor converts them to volts, which is only done where a consumer asks for it.
+ * @tparam PROTOCOL the EITProtocol the frame was measured with, which sets its size
+ */
+template <typename PROTOCOL>
+struct EITFrame {
+    static constexpr uint8_t electrodes = PROTOCOL::electrodes;      ///< Electrodes around the sheet
+    static constexpr uint16_t measurements = PROTOCOL::measurements; ///< Values in the frame
+
+    int16_t values[measurements]; ///< Voltage differences in ADC codes, with extra fractional bits when oversampled
+    uint32_t sequence;   ///< Number of the frame since startup
+    uint32_t timestamp;  ///< millis() when the frame was completed
+    float scale;         ///< Volts per unit of values
+
+    /*! @brief Converts one voltage difference to volts
+    * @param n index of the measurement
+    * @return the voltage difference in volts
+    */
+    float volts(uint16_t n) const {return values[n] * scale;}
+};
+
+#endif //__EITFRAME_H__
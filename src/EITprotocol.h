@@ -0,0 +1,106 @@
+/*!
+ * @file EITprotocol.h
+ * @author Setting-Dawn
+ * @brief Compile-time tables of the drive and measurement pairs of an EIT protocol.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __EITPROTOCOL_H__
+#define __EITPROTOCOL_H__
+
+#include <stdint.h>
+
+/// Excitation patterns, named after the distance between the sink and source electrodes
+enum class EITPattern : uint8_t {
+    Adjacent, ///< Current is sourced into the electrode after the grounded one
+    Opposite, ///< Current is sourced into the electrode across from the grounded one
+    SkipN     ///< Current is sourced n electrodes past the one after the grounded one
+};
+
+/**
+ * @struct EITExcitation
+ * @brief The drive pair of one excitation and where its measurements sit in the frame.
+ */
+struct EITExcitation {
+    uint8_t sink;   ///< Electrode grounded through the multiplexer
+    uint8_t source; ///< Electrode the current controller sources current into
+    uint16_t first; ///< Index of the first measurement of this excitation in the frame
+    uint8_t count;  ///< Number of measurements taken during this excitation
+};
+
+/**
+ * @struct EITMeasurement
+ * @brief One differential measurement, V(plus) - V(minus).
+ */
+struct EITMeasurement {
+    uint8_t plus;  ///< Electrode whose voltage is added
+    uint8_t minus; ///< Electrode whose voltage is subtracted
+};
+
+/**
+ * @struct EITProtocol
+ * @brief Drive and measurement pairs for every excitation, generated at compile time.
+ *
+ * @details Excitation k grounds electrode k and sources current into electrode
+ * k + DISTANCE. Neighbouring electrodes are then measured pairwise starting after the
+ * source electrode, skipping every pair that touches either drive electrode. With
+ * DISTANCE = 1 this is the adjacent protocol pyEIT creates with dist_exc=1, step_meas=1.
+ * @tparam ELECTRODES number of electrodes around the sheet
+ * @tparam DISTANCE electrodes between the sink and the source
+ */
+template <uint8_t ELECTRODES, uint8_t DISTANCE>
+struct EITProtocol {
+    static_assert(DISTANCE > 0 && DISTANCE < ELECTRODES, "Source and sink must be different electrodes");
+
+    static constexpr uint8_t electrodes = ELECTRODES;
+    static constexpr uint8_t distance = DISTANCE;
+    /// Adjacent drive electrodes share one excluded pair, others exclude two pairs each
+    static constexpr uint8_t perExcitation =
+        (DISTANCE == 1 || DISTANCE == ELECTRODES - 1) ? ELECTRODES - 3 : ELECTRODES - 4;
+    static constexpr uint16_t measurements = (uint16_t)ELECTRODES * perExcitation;
+
+    /// All excitations and measurements of one frame in the order they are taken
+    struct Table {
+        EITExcitation excitation[ELECTRODES];
+        EITMeasurement measurement[measurements];
+    };
+
+    /*! @brief Generates the protocol table
+    * @return the table of every excitation and measurement
+    */
+    static constexpr Table build(void)
+    {
+        Table t {};
+        uint16_t n = 0;
+        for (uint8_t k = 0; k < ELECTRODES; k++)
+        {
+            uint8_t source = (k + DISTANCE) % ELECTRODES;
+            t.excitation[k] = {k, source, n, perExcitation};
+            for (uint8_t i = 0; i < ELECTRODES; i++)
+            {
+                uint8_t minus = (source + 1 + i) % ELECTRODES;
+                uint8_t plus = (minus + 1) % ELECTRODES;
+                if (minus == k || minus == source || plus == k || plus == source) {continue;}
+                t.measurement[n++] = {plus, minus};
+            }
+        }
+        return t;
+    }
+
+    static constexpr Table table = build();
+};
+
+/// Selects the protocol of a pattern; skip is only used by EITPattern::SkipN
+template <uint8_t ELECTRODES, EITPattern PATTERN, uint8_t SKIP = 0>
+using EITProtocolOf = EITProtocol<ELECTRODES,
+    PATTERN == EITPattern::Adjacent ? 1 :
+    PATTERN == EITPattern::Opposite ? ELECTRODES / 2 : SKIP + 1>;
+
+static_assert(EITProtocolOf<16, EITPattern::Adjacent>::measurements == 208, "Adjacent protocol must give 208 values");
+static_assert(EITProtocolOf<16, EITPattern::Opposite>::measurements == 192, "Opposite protocol must give 192 values");
+static_assert(EITProtocolOf<16, EITPattern::Adjacent>::table.measurement[0].plus == 3
+    && EITProtocolOf<16, EITPattern::Adjacent>::table.measurement[0].minus == 2,
+    "Adjacent protocol must start measuring after the source electrode");
+
+#endif //__EITPROTOCOL_H__
@@ -0,0 +1,54 @@
+/*!
+ * @file EITsettle.cpp
+ * @author Setting-Dawn
+ * @brief Keeps calibrated per-excitation settle times in NVS.
+ * @details The times are stored with the signature of the protocol they were measured
+ * for, so a build running a different protocol recalibrates instead of using them.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Preferences.h>
+#include "EITsettle.h"
+
+/// NVS namespace of the EIT settings
+#define EIT_SETTLE_NAMESPACE "eit"
+/// Key of the protocol signature the settle times belong to
+#define EIT_SETTLE_SIGNATURE_KEY "settleSig"
+/// Key of the settle times, one uint32_t per excitation in microseconds
+#define EIT_SETTLE_TIMES_KEY "settleUs"
+
+/*! @brief Loads the settle times calibrated for a protocol
+* @param signature signature of the protocol being run
+* @param settleUs receives count settle times in microseconds, only written on success
+* @param count number of excitations of the protocol
+* @return true if times for this protocol were stored
+*/
+bool EITsettle_load(uint32_t signature, uint32_t* settleUs, uint8_t count)
+{
+    Preferences prefs;
+    if (!prefs.begin(EIT_SETTLE_NAMESPACE, true)) {return false;}
+
+    bool found = prefs.getULong(EIT_SETTLE_SIGNATURE_KEY, 0) == signature
+        && prefs.getBytesLength(EIT_SETTLE_TIMES_KEY) == count * sizeof(uint32_t)
+        && prefs.getBytes(EIT_SETTLE_TIMES_KEY, settleUs, count * sizeof(uint32_t)) == count * sizeof(uint32_t);
+    prefs.end();
+    return found;
+}
+
+/*! @brief Stores the settle times calibrated for a protocol
+* @param signature signature of the protocol they were measured for
+* @param settleUs count settle times in microseconds
+* @param count number of excitations of the protocol
+* @return true if they were written
+*/
+bool EITsettle_save(uint32_t signature, const uint32_t* settleUs, uint8_t count)
+{
+    Preferences prefs;
+    if (!prefs.begin(EIT_SETTLE_NAMESPACE, false)) {return false;}
+
+    bool written = prefs.putBytes(EIT_SETTLE_TIMES_KEY, settleUs, count * sizeof(uint32_t)) == count * sizeof(uint32_t)
+        && prefs.putULong(EIT_SETTLE_SIGNATURE_KEY, signature) == sizeof(uint32_t);
+    prefs.end();
+    return written;
+}
@@ -0,0 +1,17 @@
+/*!
+ * @file EITsettle.h
+ * @author Setting-Dawn
+ * @brief Header file for keeping calibrated per-excitation settle times in NVS.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __EITSETTLE_H__
+#define __EITSETTLE_H__
+
+#include <Arduino.h>
+
+bool EITsettle_load(uint32_t signature, uint32_t* settleUs, uint8_t count);
+bool EITsettle_save(uint32_t signature, const uint32_t* settleUs, uint8_t count);
+
+#endif //__EITSETTLE_H__
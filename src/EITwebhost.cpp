@@ -1,5 +1,7 @@
 #include "EITwebhost.h"
 #include "shares.h"
+#include "EITbinary.h"
+#include "EITcsv.h"
 /*!
 * @file EITwebhost.cpp
 * @brief This library allows the Softkeyboard project to host values and communicate
@@ -11,10 +13,11 @@
 * subsequently based on an examples by A. Sinha at 
 * @c https://github.com/hippyaki/WebServers-on-ESP32-Codes
 * @author A. Sinha
-* @version 1.0.0
+* @version 1.1.0
 * @date 2022-Mar-28 Original stuff by Sinha
 * @date 2022-Nov-04 Modified for ME507 use by Ridgely
 * @date 2025-Dec-03 Modified for Softkeyboard project by Setting-Dawn
+* @date 2026-Oct-16 Ported to the event-driven ESPAsyncWebServer by Setting-Dawn
 * @copyright 2022 by the authors, released under the MIT License.
 */
 
@@ -29,14 +32,91 @@ IPAddress subnet (255, 255, 255, 0); // Network mask; just leave this as is
 
 /** @brief   The web server object for this project.
  *  @details This server is responsible for responding to HTTP requests from
- *           other computers, replying with useful information.
+ *           other computers, replying with useful information. It is event
+ *           driven: requests are parsed and answered by the AsyncTCP task as
+ *           soon as their sockets are ready, so several clients may be served
+ *           at once and no task has to poll for them.
  *
  *           It's kind of clumsy to have this object as a global, but that's
  *           the way Arduino keeps things simple to program, without the user
  *           having to write custom classes or other intermediate-level 
  *           structures. 
 */
-WebServer server (80);
+AsyncWebServer server (80);
+
+/** @brief   The WebSocket server for this project.
+ *  @details Streaming clients connect to /ws on the web server's port and are pushed
+ *           every frame as soon as it is measured, and may send setpoints back on the
+ *           same connection.
+ */
+AsyncWebSocket webSocket ("/ws");
+
+/// Number of binary frame requests which may be answered at the same time
+#define EIT_BINARY_SLOTS 4
+
+/** @brief   Buffer holding one encoded binary frame until it has been sent.
+ *  @details The asynchronous server sends a response long after its handler has
+ *           returned, so each request in flight owns a slot until its connection
+ *           closes. Slots are only touched by the AsyncTCP task.
+ */
+struct BinarySlot {
+    bool busy;
+    uint8_t data[EIT_BINARY_HEADER_SIZE + EITActiveFrame::measurements * 4];
+};
+
+/// Encoded binary frames of requests in flight are built here so serving them needs no heap
+static BinarySlot binarySlots[EIT_BINARY_SLOTS];
+
+/// Number of CSV requests which may be answered at the same time
+#define EIT_CSV_SLOTS 4
+
+/** @brief   Frame being sent as CSV text to one client.
+ *  @details The text is formatted a chunk at a time as the connection takes it,
+ *           from a copy of the frame taken when the request arrived. Like the
+ *           binary slots, a slot is owned by its request until the connection closes.
+ */
+struct CsvSlot {
+    bool busy;
+    EITActiveFrame frame;
+    bool initialize;     ///< initializeFLG when the request arrived
+    bool read;           ///< readFLG when the request arrived
+    EITCsvState state;
+    uint32_t formatUs;   ///< Time spent formatting this response so far
+};
+
+/// Frames of CSV requests in flight are kept here so serving them needs no heap
+static CsvSlot csvSlots[EIT_CSV_SLOTS];
+
+/// Time spent formatting the last complete CSV response, in microseconds
+static uint32_t csvFormatUs = 0;
+
+/// Encoded binary frames are built here before being pushed to streaming clients
+static uint8_t streamFrame[EIT_BINARY_HEADER_SIZE + EITActiveFrame::measurements * 4];
+
+/// Sequence number of the last frame pushed to streaming clients, also read by the AsyncTCP task
+static volatile uint32_t streamedSequence = 0;
+/// Puts of eitFrame completed up to the frame last pushed to streaming clients
+static uint32_t streamedPuts = 0;
+/// millis() timestamp of the last frame pushed to streaming clients, also read by the AsyncTCP task
+static volatile uint32_t streamedTimestamp = 0;
+/// Number of frames pushed to streaming clients
+static uint32_t streamedFrames = 0;
+/// Time from the end of a frame's measurement to its acknowledgement by a client, in ms
+static uint32_t streamLatencyMs = 0;
+
+/** @brief   Find a response slot which is not owned by any request.
+ *  @param   slots the pool of slots to search
+ *  @return  a free slot, or NULL if every slot is in use
+ */
+template <typename SLOT, size_t COUNT>
+static SLOT* take_slot (SLOT (&slots)[COUNT])
+{
+    for (size_t n = 0;n<COUNT;n++)
+    {
+        if (!slots[n].busy) {return &slots[n];}
+    }
+    return NULL;
+}
 
 /** @brief   Get the WiFi running so we can serve some web pages.
  */
@@ -77,18 +157,19 @@ void HTML_header (String& a_string, const char* page_title)
  *           callback function is run. It sends the main web page's text to the
  *           requesting machine.
  */
-void handle_DocumentRoot ()
+void handle_DocumentRoot (AsyncWebServerRequest* request)
 {
-    Serial << "HTTP request from client #" << server.client () << endl;
+    Serial << "HTTP request for the home page" << endl;
 
     String a_str;
     HTML_header (a_str, "ESP32 Web Server Test");
     a_str += "<body>\n<div id=\"webpage\">\n";
     a_str += "<h1>ESP32 EIT Reading Home Page</h1>\n";
     a_str += "<p><p> <a href=\"/data\">Show some data in CSV format</a>\n";
+    a_str += "<p><p> <a href=\"/data.bin\">Download the latest frame in binary format</a>\n";
     a_str += "</div>\n</body>\n</html>\n";
 
-    server.send (200, "text/html", a_str); 
+    request->send (200, "text/html", a_str); 
 }
 
 /** @brief   Respond to a webpage request with arguments for the x,y setpoints
@@ -97,16 +178,16 @@ void handle_DocumentRoot ()
  *           callback function is run. It provides the ESP32 with the requested float values. the main web page's text to the
  *           requesting machine.
  */
-void handleSetValues() {
+void handleSetValues(AsyncWebServerRequest* request) {
     // Expecting: /set?val1=123&val2=456
 
-    if (!server.hasArg("x") || !server.hasArg("y")) {
-        server.send(400, "text/plain", "Missing x or y");
+    if (!request->hasParam("x") || !request->hasParam("y")) {
+        request->send(400, "text/plain", "Missing x or y");
         return;
     }
 
-    String val1Str = server.arg("x");
-    String val2Str = server.arg("y");
+    String val1Str = request->getParam("x")->value();
+    String val2Str = request->getParam("y")->value();
 
     float value1 = val1Str.toFloat();
     float value2 = val2Str.toFloat();
@@ -118,7 +199,7 @@ void handleSetValues() {
 
     // Respond to the client
     String response = "OK. Received x=" + String(value1) + " y=" + String(value2);
-    server.send(200, "text/plain", response);
+    request->send(200, "text/plain", response);
 }
 
 /** @brief   Respond to a webpage request with arguments for communication via flags
@@ -126,23 +207,32 @@ void handleSetValues() {
  *           with a url requesting /flag? arguments, this
  *           callback function is run. This allows the client PC to communicate about what information has been received.
  */
-void handleFlags() {
+void handleFlags(AsyncWebServerRequest* request) {
     bool value;
 
-    if (server.hasArg("initializeFLG")) {
-        String val = server.arg("initializeFLG");
+    if (request->hasParam("initializeFLG")) {
+        String val = request->getParam("initializeFLG")->value();
         Serial << "Got arg: " << "initializeFLG";
         Serial << "with val: " << val << endl;
         value = bool(val);
 
         // Respond to the client
-        String response = "OK. Received initializeFLG=" + value;
-        server.send(200, "text/plain", response);
+        String response = "OK. Received initializeFLG=" + String(value);
+        request->send(200, "text/plain", response);
         initializeVFLG.put(false);
         readVFLG.put(true);
     }
-    if (server.hasArg("readFLG")) {
-        server.send(400, "text/plain", "Flag is Read-Only");
+    else if (request->hasParam("readFLG")) {
+        request->send(400, "text/plain", "Flag is Read-Only");
+    }
+    else if (request->hasParam("calibrateFLG")) {
+        // Frames stop while the material reading task measures the settle times
+        calibrateFLG.put(true);
+        request->send(200, "text/plain", "OK. Calibrating settle times");
+    }
+    else {
+        // Every asynchronous request must be answered or its connection stays open
+        request->send(400, "text/plain", "Missing flag");
     }
 
 }
@@ -150,56 +240,325 @@ void handleFlags() {
 /** @brief   Respond to a request for an HTTP page that doesn't exist.
  *  @details This function produces the Error 404, Page Not Found error. 
  */
-void handle_NotFound (void)
+void handle_NotFound (AsyncWebServerRequest* request)
 {
-    server.send (404, "text/plain", "Not found");
+    request->send (404, "text/plain", "Not found");
 }
 
 /** @brief   Return data when requested.
  *  @details The measured data is sent in comma seperated value (CSV) format 
  *           which is easily read by Matlab(tm), Python, and spreadsheets.
  */
-void handle_data (void)
+void handle_data (AsyncWebServerRequest* request)
 {
-    Serial << "trying to publish" << endl;
-    // Page will consist of one line of comma separated voltage values
-    String csv_str = "Voltage Readings,";
-    double data[208] = {0};
-
-    if (dataAvailable.get())
+    CsvSlot* slot = take_slot (csvSlots);
+    if (slot == NULL)
     {
-        dataAvailable.put(false);
-        for (uint8_t n = 0;n<208;n++) 
-        {
-            data[n] = publish[n];
-        }
-        dataAvailable.put(true);
+        request->send (503, "text/plain", "Busy");
+        return;
+    }
+
+    eitFrame.get(slot->frame); // Always a complete frame, the reading task never waits for this copy
+    slot->initialize = initializeVFLG.get();
+    slot->read = readVFLG.get();
+    EITcsv_begin(slot->state);
+    slot->formatUs = 0;
 
-        for (uint8_t n = 0;n<208;n++)
+    // Page will consist of one line of comma separated voltage values followed by
+    // lines of comma separated flag labels and bool values. Values are only converted
+    // to volts where they are formatted, straight into the buffer of the connection.
+    slot->busy = true;
+    request->onDisconnect ([slot] () {slot->busy = false;});
+    AsyncWebServerResponse* response = request->beginChunkedResponse ("text/plain",
+        [slot] (uint8_t* buffer, size_t maxLen, size_t index) -> size_t
         {
-            csv_str += String(data[n],8);
-            csv_str += ",";
-        }
-        csv_str += "\n";
-        // // Create some fake data and put it into a String object.
-        // //PLACEHOLDER FOR PULLING FROM QUEUE
-        // for (uint8_t index = 0; index < 208; index++)
-        // {
-        //     csv_str += index;
-        //     csv_str += ",";
-        //     csv_str += String (sin (index / 5.4321), 3); // 3 decimal places
-        // }
-        // csv_str += "\n";
-
-        // Page will also consist of lines of comma separated flag labels and bool values
-        csv_str += "initializeFLG,";
-        csv_str += String(initializeVFLG.get()); // PLACEHOLDER FOR PULLING FROM SHARE
+            uint32_t start = micros();
+            size_t len = EITcsv_write(slot->frame, slot->initialize, slot->read, slot->state, buffer, maxLen);
+            slot->formatUs += micros() - start;
+            if (len == 0) {csvFormatUs = slot->formatUs;}
+            return len;
+        });
+
+    // Send the CSV file as plain text so it can be easily interpretted
+    request->send (response);
+}
+
+
+/** @brief   Return the latest frame in binary form when requested.
+ *  @details The frame is sent in the little-endian layout described in
+ *           EITbinary.h, as int16 ADC codes or, with the argument format=float,
+ *           as float32 volts. The flags byte carries initializeFLG and readFLG.
+ */
+void handle_data_bin (AsyncWebServerRequest* request)
+{
+    BinarySlot* slot = take_slot (binarySlots);
+    if (slot == NULL)
+    {
+        request->send (503, "text/plain", "Busy");
+        return;
+    }
+
+    EITActiveFrame data;
+    eitFrame.get(data);
+
+    uint8_t flags = 0;
+    if (request->hasParam("format") && request->getParam("format")->value() == "float") {flags |= EIT_BINARY_FLAG_FLOAT32;}
+    if (initializeVFLG.get()) {flags |= EIT_BINARY_FLAG_INITIALIZE;}
+    if (readVFLG.get()) {flags |= EIT_BINARY_FLAG_READ;}
+
+    size_t len = EITbinary_encode(data, flags, slot->data, sizeof(slot->data));
+
+    // The response is sent straight from the slot, which is released with the connection
+    slot->busy = true;
+    request->onDisconnect ([slot] () {slot->busy = false;});
+    request->send (200, "application/octet-stream", slot->data, len);
+}
+
+/** @brief   Append the timing of the cycles of a periodic task to a CSV page.
+ *  @param   csv_str the page to add to
+ *  @param   prefix name of the task, put in front of every field
+ *  @param   cycle the executor timing the task
+ */
+static void add_cycle_stats (String& csv_str, const char* prefix, Periodic& cycle)
+{
+    PeriodicStats stats;
+    cycle.getStats(stats);
+    const char* const names[] = {"Cycles,", "Overruns,", "Skipped,", "DtUs,", "MinDtUs,", "MaxDtUs,", "WorkUs,", "MaxWorkUs,"};
+    const uint32_t values[] = {stats.cycles, stats.overruns, stats.skipped, stats.dtUs, stats.minDtUs,
+                               stats.maxDtUs, stats.workUs, stats.maxWorkUs};
+    for (uint8_t f = 0;f<sizeof(values)/sizeof(values[0]);f++)
+    {
         csv_str += "\n";
-        csv_str += "readFLG,";
-        csv_str += String(readVFLG.get()); // PLACEHOLDER FOR PULLING FROM SHARE
+        csv_str += prefix;
+        csv_str += names[f];
+        csv_str += String(values[f]);
+    }
+    for (uint8_t b = 0;b<PERIODIC_JITTER_BINS;b++)
+    {
+        // Each bin is named by the jitter it starts at, the last one holds everything beyond
         csv_str += "\n";
+        csv_str += prefix;
+        csv_str += "Jitter";
+        csv_str += String(b*stats.binUs);
+        csv_str += b == PERIODIC_JITTER_BINS - 1 ? "UsAndOver," : "Us,";
+        csv_str += String(stats.jitter[b]);
+    }
+}
+
+/** @brief   Return the timing of the EIT acquisition when requested.
+ *  @details The per-stage times of the latest excitation step, the frame time
+ *           and the resulting frame rate are sent as label,value lines.
+ */
+void handle_stats (AsyncWebServerRequest* request)
+{
+    EITStats stats = eitStats.get();
+
+    String csv_str = "frames,";
+    csv_str += String(stats.frames);
+    csv_str += "\nframeUs,";
+    csv_str += String(stats.frameUs);
+    csv_str += "\nframesPerSecond,";
+    csv_str += String(stats.frameUs ? 1.0e6 / stats.frameUs : 0.0, 2);
+    csv_str += "\nfailedSteps,";
+    csv_str += String(stats.failedSteps);
+    csv_str += "\ndroppedFrames,";
+    csv_str += String(stats.droppedFrames);
+    csv_str += "\nstreamedFrames,";
+    csv_str += String(streamedFrames);
+    csv_str += "\nstreamLatencyMs,";
+    csv_str += String(streamLatencyMs);
+    csv_str += "\ncsvFormatUs,";
+    csv_str += String(csvFormatUs);
+    csv_str += "\nadcTransactions,";
+    csv_str += String(stats.adcTransactions);
+    csv_str += "\nadcBytes,";
+    csv_str += String(stats.adcBytes);
+    csv_str += "\nadcConversions,";
+    csv_str += String(stats.adcConversions);
+    csv_str += "\nbusyPolls,";
+    csv_str += String(stats.busyPolls);
+    csv_str += "\npcaTransactions,";
+    csv_str += String(stats.pcaTransactions);
+    csv_str += "\npcaBytes,";
+    csv_str += String(stats.pcaBytes);
+    csv_str += "\nswitchUs,";
+    csv_str += String(stats.switchUs);
+    csv_str += "\nsettleUs,";
+    csv_str += String(stats.settleUs);
+    csv_str += "\njitterUs,";
+    csv_str += String(stats.jitterUs);
+    csv_str += "\nmaxJitterUs,";
+    csv_str += String(stats.maxJitterUs);
+    csv_str += "\nlateSteps,";
+    csv_str += String(stats.lateSteps);
+    csv_str += "\nreadUs,";
+    csv_str += String(stats.readUs);
+    csv_str += "\nframeReadUs,";
+    csv_str += String(stats.frameReadUs);
+    csv_str += "\nadcRounds,";
+    csv_str += String(stats.adcRounds);
+    csv_str += "\nnoiseFloorUv,";
+    csv_str += String(stats.noiseFloorUv);
+    csv_str += "\nprocessUs,";
+    csv_str += String(stats.processUs);
 
-        // Send the CSV file as plain text so it can be easily interpretted
-        server.send (200, "text/plain", csv_str);
+    // Period of the motor control cycles, and of the servo cycles inside them, and how far each was from it
+    add_cycle_stats(csv_str, "control", controlCycle);
+    add_cycle_stats(csv_str, "servo", servoCycle);
+
+    // Freshness of the IMU samples the control cycles used, and the timing of the sampling task
+    IMUStats imu;
+    imuStats.get(imu);
+    csv_str += "\nimuSamples,";
+    csv_str += String(imu.samples);
+    csv_str += "\nimuDropped,";
+    csv_str += String(imu.dropped);
+    csv_str += "\nimuAgeUs,";
+    csv_str += String(imu.ageUs);
+    csv_str += "\nimuMaxAgeUs,";
+    csv_str += String(imu.maxAgeUs);
+    csv_str += "\nimuReusedCycles,";
+    csv_str += String(imu.reused);
+    csv_str += "\nimuStaleCycles,";
+    csv_str += String(imu.stale);
+    // Calibration levels of the system, gyroscope, accelerometer and magnetometer, 3 when fully calibrated
+    csv_str += "\nimuCalibration,";
+    csv_str += String(imu.calibration >> 6);
+    csv_str += String((imu.calibration >> 4) & 3);
+    csv_str += String((imu.calibration >> 2) & 3);
+    csv_str += String(imu.calibration & 3);
+    add_cycle_stats(csv_str, "imu", imuCycle);
+
+    // Occupancy of its TWI bus and the time jobs waited for it, per client
+    static const char* const clients[TWI_CLIENT_COUNT] = {"EIT", "IMU"};
+    TWIBus* const buses[TWI_CLIENT_COUNT] = {&eitBus, &imuBus};
+    for (uint8_t c = 0;c<TWI_CLIENT_COUNT;c++)
+    {
+        TWIStats bus;
+        buses[c]->getStats(bus);
+        float elapsedUs = (float)(esp_timer_get_time() - bus.startedAt);
+        const TWIClientStats& client = bus.client[c];
+        csv_str += "\ntwi";
+        csv_str += clients[c];
+        csv_str += "Jobs,";
+        csv_str += String(client.jobs);
+        csv_str += "\ntwi";
+        csv_str += clients[c];
+        csv_str += "BusyPercent,";
+        csv_str += String(elapsedUs > 0 ? 100.0f * client.busyUs / elapsedUs : 0.0f, 2);
+        csv_str += "\ntwi";
+        csv_str += clients[c];
+        csv_str += "MeanWaitUs,";
+        csv_str += String(client.jobs ? (uint32_t)(client.waitUs / client.jobs) : 0);
+        csv_str += "\ntwi";
+        csv_str += clients[c];
+        csv_str += "MaxWaitUs,";
+        csv_str += String(client.maxWaitUs);
+        csv_str += "\ntwi";
+        csv_str += clients[c];
+        csv_str += "Expired,";
+        csv_str += String(client.expired);
+        csv_str += "\ntwi";
+        csv_str += clients[c];
+        csv_str += "Failed,";
+        csv_str += String(client.failed);
     }
+
+    // Clock and achieved throughput of every device in the clock tables
+    for (uint8_t b = 0;b<TWI_CLIENT_COUNT;b++)
+    {
+        if (b > 0 && buses[b] == buses[0]) {continue;} // Both clients share one bus
+        TWIStats bus;
+        buses[b]->getStats(bus);
+        for (uint8_t d = 0;d<bus.devices;d++)
+        {
+            const TWIDeviceStats& device = bus.device[d];
+            char label[8];
+            snprintf(label, sizeof(label), "twi%02X", device.address);
+            csv_str += "\n";
+            csv_str += label;
+            csv_str += "ClockHz,";
+            csv_str += String(device.frequency);
+            csv_str += "\n";
+            csv_str += label;
+            csv_str += "BytesPerSecond,";
+            csv_str += String(device.busyUs ? (uint32_t)(device.bytes * 1000000ULL / device.busyUs) : 0);
+        }
+        csv_str += "\ntwi";
+        csv_str += clients[b];
+        csv_str += "BusClockChanges,";
+        csv_str += String(bus.clockChanges);
+    }
+    csv_str += "\n";
+
+    request->send (200, "text/plain", csv_str);
+}
+
+
+/** @brief   Respond to events of the WebSocket frame stream.
+ *  @details Text messages from a client are either setpoints in the same form as
+ *           the /set arguments, x=0.25&y=-0.5, or ack=n acknowledging frame n so
+ *           the frame-to-client latency can be measured.
+ *  @param   ws the WebSocket server the event belongs to
+ *  @param   client the client the event came from
+ *  @param   type the type of the event
+ *  @param   arg information about the received frame for data events
+ *  @param   payload the message received, if any
+ *  @param   length the length of the message
+ */
+void handle_ws_event (AsyncWebSocket* ws, AsyncWebSocketClient* client, AwsEventType type,
+                      void* arg, uint8_t* payload, size_t length)
+{
+    if (type == WS_EVT_CONNECT)
+    {
+        Serial << "Stream client #" << client->id() << " connected" << endl;
+        return;
+    }
+    if (type != WS_EVT_DATA) {return;}
+
+    // Only short text messages which arrived in a single frame are commands
+    AwsFrameInfo* info = (AwsFrameInfo*)arg;
+    if (!info->final || info->index != 0 || info->len != length || info->opcode != WS_TEXT) {return;}
+
+    // Copy the message so it is terminated no matter how it arrived
+    char message[48];
+    length = min(length, sizeof(message) - 1);
+    memcpy(message, payload, length);
+    message[length] = '\0';
+
+    float x, y;
+    unsigned long sequence;
+    if (sscanf(message, "x=%f&y=%f", &x, &y) == 2)
+    {
+        xBar.put(constrain(x, -1.0f, 1.0f));
+        yBar.put(constrain(y, -1.0f, 1.0f));
+    }
+    else if (sscanf(message, "ack=%lu", &sequence) == 1 && sequence == streamedSequence)
+    {
+        streamLatencyMs = millis() - streamedTimestamp;
+    }
+}
+
+/** @brief   Push the latest frame to every streaming client if it is new.
+ *  @details Frames are sent as binary WebSocket messages in the EITbinary.h layout.
+ */
+void stream_frame (void)
+{
+    // The share counts completed puts only, so a frame still being written is not taken
+    // for a new one; the count wraps, so it is only compared for equality
+    if (eitFrame.sequence() == streamedPuts || webSocket.count() == 0) {return;}
+
+    EITActiveFrame data;
+    streamedPuts = eitFrame.get(data);
+
+    uint8_t flags = 0;
+    if (initializeVFLG.get()) {flags |= EIT_BINARY_FLAG_INITIALIZE;}
+    if (readVFLG.get()) {flags |= EIT_BINARY_FLAG_READ;}
+
+    size_t len = EITbinary_encode(data, flags, streamFrame, sizeof(streamFrame));
+    webSocket.binaryAll(streamFrame, len);
+
+    streamedSequence = data.sequence;
+    streamedTimestamp = data.timestamp;
+    streamedFrames++;
 }
@@ -11,21 +11,24 @@
 * subsequently based on an examples by A. Sinha at 
 * @c https://github.com/hippyaki/WebServers-on-ESP32-Codes
 * @author A. Sinha
-* @version 1.0.0
+* @version 1.1.0
 * @date 2022-Mar-28 Original stuff by Sinha
 * @date 2022-Nov-04 Modified for ME507 use by Ridgely
 * @date 2025-Dec-03 Modified for Softkeyboard project by Setting-Dawn
+* @date 2026-Oct-16 Ported to the event-driven ESPAsyncWebServer by Setting-Dawn
 * @copyright 2022 by the authors, released under the MIT License.
 */
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
 #include "PrintStream.h"
 
 // The web server object is defined in EITwebhost.cpp; declare it here so
 // other translation units (for example `main.cpp`) can reference it.
-extern WebServer server;
+extern AsyncWebServer server;
+// The WebSocket handler pushing frames to streaming clients, also defined in EITwebhost.cpp
+extern AsyncWebSocket webSocket;
 
 /** @brief   Get the WiFi running so we can serve some web pages.
  */
@@ -48,7 +51,7 @@ void HTML_header (String& a_string, const char* page_title);
  *           callback function is run. It sends the main web page's text to the
  *           requesting machine.
  */
-void handle_DocumentRoot ();
+void handle_DocumentRoot (AsyncWebServerRequest* request);
 
 /** @brief   Respond to a webpage request with arguments for the x,y setpoints
  *  @details When another computer contacts this ESP32 through TCP/IP port 80
@@ -56,24 +59,56 @@ void handle_DocumentRoot ();
  *           callback function is run. It provides the ESP32 with the requested float values. the main web page's text to the
  *           requesting machine.
  */
-void handleSetValues();
+void handleSetValues(AsyncWebServerRequest* request);
 
 /** @brief   Respond to a webpage request with arguments for communication via flags
  *  @details When another computer contacts this ESP32 through TCP/IP port 80
  *           with a url requesting /flag? arguments, this
  *           callback function is run. This allows the client PC to communicate about what information has been received.
  */
-void handleFlags();
+void handleFlags(AsyncWebServerRequest* request);
 
 /** @brief   Respond to a request for an HTTP page that doesn't exist.
  *  @details This function produces the Error 404, Page Not Found error. 
  */
-void handle_NotFound (void);
+void handle_NotFound (AsyncWebServerRequest* request);
 
 /** @brief   Return data when requested.
  *  @details The measured data is sent in comma seperated value (CSV) format 
  *           which is easily read by Matlab(tm), Python, and spreadsheets.
  */
-void handle_data (void);
+void handle_data (AsyncWebServerRequest* request);
+
+/** @brief   Return the latest frame in binary form when requested.
+ *  @details The frame is sent in the little-endian layout described in
+ *           EITbinary.h, as int16 ADC codes or, with the argument format=float,
+ *           as float32 volts. The flags byte carries initializeFLG and readFLG.
+ */
+void handle_data_bin (AsyncWebServerRequest* request);
+
+/** @brief   Return the timing of the EIT acquisition when requested.
+ *  @details The per-stage times of the latest excitation step, the frame time
+ *           and the resulting frame rate are sent as label,value lines.
+ */
+void handle_stats (AsyncWebServerRequest* request);
+
+/** @brief   Respond to events of the WebSocket frame stream.
+ *  @details Text messages from a client are either setpoints in the same form as
+ *           the /set arguments, x=0.25&y=-0.5, or ack=n acknowledging frame n so
+ *           the frame-to-client latency can be measured.
+ *  @param   ws the WebSocket server the event belongs to
+ *  @param   client the client the event came from
+ *  @param   type the type of the event
+ *  @param   arg information about the received frame for data events
+ *  @param   payload the message received, if any
+ *  @param   length the length of the message
+ */
+void handle_ws_event (AsyncWebSocket* ws, AsyncWebSocketClient* client, AwsEventType type,
+                      void* arg, uint8_t* payload, size_t length);
+
+/** @brief   Push the latest frame to every streaming client if it is new.
+ *  @details Frames are sent as binary WebSocket messages in the EITbinary.h layout.
+ */
+void stream_frame (void);
 
 #endif //__EITWEBHOST_H__
\ No newline at end of file
@@ -25,7 +25,9 @@ import pyeit.mesh as mesh
 from pyeit.mesh.shape import thorax
 from pyeit.mesh.wrapper import PyEITAnomaly_Circle
 import time
+import struct
 import requests
+import websocket
 
 # Specify which electrodes i = 0:15 are hooked up to which clip
 ADC1Map = [] # List of clips in order from electrode 1 to 16
@@ -36,6 +38,7 @@ currCtrlMap = []
 ESP32_IP = "192.168.5.1"
 
 n_el = 16  # nb of electrodes
+dist_exc = 1  # sink to source distance, must match EIT_PATTERN in the firmware (opposite is n_el//2)
 b0 = [-1.0,-1.0] # Bottom left corner of mesh
 b1 = [1.0,1.0] # Top right corner of mesh
 
@@ -63,7 +66,7 @@ def setup(n_el,BL_corner,TR_corner):
     mesh_obj = mesh.create(n_el, h0=0.1, fd= lambda pts: mesh.shape.rectangle(pts,BL_corner,TR_corner))
     
     # create EIT conditions
-    protocol_obj = protocol.create(n_el, dist_exc=1, step_meas=1, parser_meas="std")
+    protocol_obj = protocol.create(n_el, dist_exc=dist_exc, step_meas=1, parser_meas="std")
     return mesh_obj, protocol_obj
 
 def simEIT(mesh_obj, protocol_obj,anomalyList:list):
@@ -201,6 +204,80 @@ def read_data_from_esp():
 
     return values,flags
 
+def decode_frame(data):
+    """!
+    decode a frame in the binary format described in EITbinary.h
+    
+    Parameters
+    ----------
+    @param data : bytes
+        the encoded frame
+    
+    Returns
+    -------
+    @return values:
+        list of all voltages recorded by esp32
+    @return flags:
+        dictionary of the initializeFLG and readFLG flags
+    @return sequence:
+        sequence number of the frame
+    """
+    magic, version, header_size, sequence, timestamp, electrodes, flag_bits, count, scale = \
+        struct.unpack_from("<4sHHIIBBHf", data)
+    if magic != b"EITF" or version != 1:
+        raise ValueError("Not an EIT frame")
+
+    if flag_bits & 0x01:
+        values = list(struct.unpack_from(f"<{count}f", data, header_size))
+    else:
+        values = [code * scale for code in struct.unpack_from(f"<{count}h", data, header_size)]
+
+    flags = {"initializeFLG": bool(flag_bits & 0x02), "readFLG": bool(flag_bits & 0x04)}
+    return values,flags,sequence
+
+def read_binary_from_esp():
+    """!
+    read data from the ESP in the binary format described in EITbinary.h
+    
+    Parameters
+    ----------
+    none
+    
+    Returns
+    -------
+    @return values:
+        list of all voltages recorded by esp32
+    @return flags:
+        dictionary of the initializeFLG and readFLG flags
+    """
+    url = f"http://{ESP32_IP}/data.bin"
+    resp = requests.get(url, timeout=1)
+    resp.raise_for_status()  # raise if error
+
+    values,flags,sequence = decode_frame(resp.content)
+    return values,flags
+
+def stream_from_esp(ws):
+    """!
+    wait for the next frame pushed by the ESP over the WebSocket stream
+    
+    Parameters
+    ----------
+    @param ws : websocket.WebSocket
+        connection to the ESP's stream at /ws
+    
+    Returns
+    -------
+    @return values:
+        list of all voltages recorded by esp32
+    @return flags:
+        dictionary of the initializeFLG and readFLG flags
+    """
+    values,flags,sequence = decode_frame(ws.recv())
+    # Acknowledging the frame lets the ESP measure frame-to-client latency
+    ws.send(f"ack={sequence}")
+    return values,flags
+
 def findCentroid(x, y, ds_n):
     """!
     finds centroid of any major anomalies detected in the analysis
@@ -270,6 +347,25 @@ def send_values(xbar, ybar):
     except requests.exceptions.RequestException as e:
         print("Error talking to ESP32:", e)
 
+def stream_values(ws, xbar, ybar):
+    """!
+    sends the centroid as the new setpoint over the WebSocket stream
+    
+    Parameters
+    ----------
+    @param ws : websocket.WebSocket
+        connection to the ESP's stream at /ws
+    @param xbar
+        x values
+    @param ybar
+        y values
+    
+    Returns
+    -------
+    none
+    """
+    ws.send(f"x={xbar}&y={ybar}")
+
 def send_flg(params: dict):
     """!
     sends flags
@@ -363,11 +459,16 @@ figure1, figure2 = plotEITGraphs(mesh_obj, tri, x, y, ds_n)
 voltages = []
 oldV = []
 
-# Main Loop
+ws = None
+
+# Main Loop, frames are pushed by the ESP as soon as they are measured
 while True:
     try:
-        readValues,flags = read_data_from_esp()
+        if ws is None:
+            ws = websocket.create_connection(f"ws://{ESP32_IP}/ws", timeout=2)
+        readValues,flags = stream_from_esp(ws)
     except:
+        ws = None
         time.sleep(0.25)
         continue
 
@@ -388,7 +489,10 @@ while True:
         ds_n = analyze(pts, tri, V0, voltages, eit)
 
         xbar,ybar = findCentroid(x, y, ds_n)
-        send_values(xbar,ybar)
+        try:
+            stream_values(ws,xbar,ybar)
+        except (websocket.WebSocketException, OSError):
+            ws = None # Reconnect while waiting for the next frame
 
         figure1, figure2 = plotEITGraphs(mesh_obj, tri, x, y, ds_n,figure1,figure2)
         continue
@@ -401,5 +505,5 @@ while True:
     #     send_flg(params=param)
 
     else:
-        time.sleep(0.1)
+        pass # No sleep needed, the next frame is pushed as soon as it is measured
     continue
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*!
+ * @file Fixed.h
+ * @author Setting-Dawn
+ * @brief A saturating fixed point number type for control laws.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __FIXED_H__
+#define __FIXED_H__
+
+#include <Arduino.h>
+
+/**
+ * @struct Fixed
+ * @brief A signed number with BITS fractional bits held in 32 bits.
+ *
+ * @details Products and quotients are formed in 64 bits and rounded, and every result
+ * saturates at the ends of the range instead of wrapping, so an overflowing control term
+ * pins at its limit rather than changing sign. Constants are converted from float at
+ * compile time with from().
+ * @tparam BITS fractional bits, so the range is +-2^(31-BITS) and the resolution 2^-BITS
+ */
+template <uint8_t BITS>
+struct Fixed {
+    static_assert(BITS > 0 && BITS < 31, "A fixed point number needs integer and fractional bits");
+    static constexpr int32_t one = (int32_t)1 << BITS;
+
+    int32_t raw;
+
+    /*! @brief Converts a float, rounding to the nearest step and saturating at the range
+    * @param value the number to convert
+    * @return its fixed point value
+    */
+    static constexpr Fixed from(float value)
+    {
+        return fromRaw(saturate((int64_t)(value * one + (value >= 0 ? 0.5f : -0.5f))));
+    }
+
+    /*! @brief Wraps a raw value
+    * @param value the number times 2^BITS
+    * @return the fixed point value
+    */
+    static constexpr Fixed fromRaw(int32_t value) {return Fixed {value};}
+
+    /*! @brief Limits a wide intermediate to the range of the type
+    * @param value the raw value to limit
+    * @return the nearest representable raw value
+    */
+    static constexpr int32_t saturate(int64_t value)
+    {
+        return value > INT32_MAX ? INT32_MAX : value < INT32_MIN ? INT32_MIN : (int32_t)value;
+    }
+
+    /*! @brief Converts to float
+    * @return the value as a float
+    */
+    constexpr float toFloat(void) const {return (float)raw / one;}
+
+    constexpr Fixed operator+(Fixed other) const {return fromRaw(saturate((int64_t)raw + other.raw));}
+    constexpr Fixed operator-(Fixed other) const {return fromRaw(saturate((int64_t)raw - other.raw));}
+    constexpr Fixed operator-(void) const {return fromRaw(saturate(-(int64_t)raw));}
+    constexpr Fixed operator*(Fixed other) const
+    {
+        return fromRaw(saturate(((int64_t)raw * other.raw + (one >> 1)) >> BITS));
+    }
+    /// Divides, saturating towards the sign of the dividend when dividing by zero
+    constexpr Fixed operator/(Fixed other) const
+    {
+        return other.raw == 0 ? fromRaw(raw >= 0 ? INT32_MAX : INT32_MIN)
+                              : fromRaw(saturate(((int64_t)raw << BITS) / other.raw));
+    }
+    constexpr bool operator<(Fixed other) const {return raw < other.raw;}
+    constexpr bool operator>(Fixed other) const {return raw > other.raw;}
+    constexpr bool operator<=(Fixed other) const {return raw <= other.raw;}
+    constexpr bool operator>=(Fixed other) const {return raw >= other.raw;}
+};
+
+/// 16.16 fixed point, +-32768 with a resolution of 1.5e-5
+typedef Fixed<16> Q16;
+/// 17.15 fixed point, +-65536 with a resolution of 3.1e-5
+typedef Fixed<15> Q15;
+
+/**
+ * @struct FixedValue
+ * @brief Converts between float and a number type which may be float or Fixed.
+ * @tparam T float or a Fixed type
+ */
+template <typename T>
+struct FixedValue {
+    static constexpr T from(float value) {return value;}
+    static constexpr float toFloat(T value) {return value;}
+};
+
+template <uint8_t BITS>
+struct FixedValue<Fixed<BITS>> {
+    static constexpr Fixed<BITS> from(float value) {return Fixed<BITS>::from(value);}
+    static constexpr float toFloat(Fixed<BITS> value) {return value.toFloat();}
+};
+
+#endif //__FIXED_H__
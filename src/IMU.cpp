@@ -8,9 +8,12 @@
 #include <Arduino.h>
 #include "IMU.h"
 
-// Global/static BNO055 instance
-static Adafruit_BNO055 bno = Adafruit_BNO055(55, 0x28);
+// Global/static BNO055 instance, created by IMU_init() on the bus it is given
+static Adafruit_BNO055* bno = NULL;
+static TwoWire* imuWire = NULL;
 static bool imuCalibrated = false;
+// TWI address of the sensor, ADR pin low
+static const uint8_t IMU_ADDRESS = 0x28;
 
 /**
  * @brief Internal helper function that performs blocking auto-calibration with timeout.
@@ -29,7 +32,7 @@ static void IMU_runAutoCalibration(unsigned long timeoutMs) {
     unsigned long start = millis();
 
     // Poll calibration until fully calibrated or timeout
-    while (!bno.isFullyCalibrated()) {
+    while (!bno->isFullyCalibrated()) {
         // If timeoutMs == 0, don't block at all
         if (timeoutMs > 0 && (millis() - start >= timeoutMs)) {
             break;
@@ -37,7 +40,7 @@ static void IMU_runAutoCalibration(unsigned long timeoutMs) {
 
         // Optional: you could add Serial prints here for debug, e.g.:
         // uint8_t sys, gyro, accel, mag;
-        // bno.getCalibration(&sys, &gyro, &accel, &mag);
+        // bno->getCalibration(&sys, &gyro, &accel, &mag);
         // Serial.print("Calib: SYS=");
         // Serial.print(sys);
         // Serial.print(" G=");
@@ -50,7 +53,7 @@ static void IMU_runAutoCalibration(unsigned long timeoutMs) {
         delay(100);
     }
 
-    imuCalibrated = bno.isFullyCalibrated();
+    imuCalibrated = bno->isFullyCalibrated();
 }
 
 /**
@@ -62,12 +65,14 @@ static void IMU_runAutoCalibration(unsigned long timeoutMs) {
  * @return bool True if the sensor is found and successfully initialized (even if
  *         not fully calibrated yet), false if sensor initialization fails.
  * 
- * @see IMU_init(unsigned long calibrationTimeoutMs)
+ * @param bus The TWI bus the sensor is connected to.
+ * 
+ * @see IMU_init(TwoWire* bus, unsigned long calibrationTimeoutMs)
  */
-bool IMU_init() {
+bool IMU_init(TwoWire* bus) {
     // Default: wait up to 30 seconds for calibration
     const unsigned long defaultTimeoutMs = 30000;
-    return IMU_init(defaultTimeoutMs);
+    return IMU_init(bus, defaultTimeoutMs);
 }
 
 /**
@@ -77,6 +82,8 @@ bool IMU_init() {
  * mode, configures the external crystal, and runs auto-calibration with the
  * specified timeout duration.
  * 
+ * @param bus The TWI bus the sensor is connected to. The sensor stays on the
+ *            bus given the first time this is called.
  * @param calibrationTimeoutMs Timeout duration for calibration in milliseconds.
  *                              Pass 0 to skip blocking for calibration.
  * 
@@ -89,15 +96,19 @@ bool IMU_init() {
  *   3. Enables external crystal use for better accuracy
  *   4. Runs auto-calibration with the specified timeout
  */
-bool IMU_init(unsigned long calibrationTimeoutMs) {
-    if (!bno.begin(OPERATION_MODE_NDOF)) {
+bool IMU_init(TwoWire* bus, unsigned long calibrationTimeoutMs) {
+    if (bno == NULL) {
+        bno = new Adafruit_BNO055(55, IMU_ADDRESS, bus);
+        imuWire = bus;
+    }
+    if (!bno->begin(OPERATION_MODE_NDOF)) {
         // Sensor not found
         imuCalibrated = false;
         return false;
     }
 
     delay(100);
-    bno.setExtCrystalUse(true);
+    bno->setExtCrystalUse(true);
 
     // Run auto calibration (blocking until calibrated or timeout)
     IMU_runAutoCalibration(calibrationTimeoutMs);
@@ -126,7 +137,12 @@ bool IMU_init(unsigned long calibrationTimeoutMs) {
  * @note Ensure IMU_init() has been called before using this function.
  */
 void IMU_getAngles(float &x_angle, float &y_angle) {
-    imu::Vector<3> euler = bno.getVector(Adafruit_BNO055::VECTOR_EULER);
+    if (bno == NULL) {
+        x_angle = 0.0f;
+        y_angle = 0.0f;
+        return;
+    }
+    imu::Vector<3> euler = bno->getVector(Adafruit_BNO055::VECTOR_EULER);
 
     // BNO055 Euler format:
     //   euler.x = heading (yaw)
@@ -154,7 +170,78 @@ void IMU_getAngles(float &x_angle, float &y_angle) {
  */
 bool IMU_isCalibrated() {
     // Keep our cached value in sync with sensor status
-    imuCalibrated = bno.isFullyCalibrated();
+    imuCalibrated = bno != NULL && bno->isFullyCalibrated();
     return imuCalibrated;
 }
 
+/**
+ * @brief Read the gyroscope rates, Euler angles and calibration status in one transaction.
+ *
+ * Reads every register from the gyroscope data (0x14) to CALIB_STAT (0x35) in a single
+ * auto-incrementing burst and decodes the parts used for control into integer counts,
+ * without the floating point vectors of the Adafruit driver.
+ *
+ * @param[out] burst Filled with the rates, angles and calibration status.
+ *
+ * @return bool True if the whole burst was read, false if the sensor was not
+ *         initialized or did not answer.
+ *
+ * @details The sensor must be on register page 0, where IMU_init() leaves it. The
+ * quaternion, linear acceleration, gravity and temperature registers between the Euler
+ * angles and CALIB_STAT are read too, as skipping them would take a second transaction.
+ *
+ * @note Ensure IMU_init() has been called before using this function.
+ */
+bool IMU_readBurst(IMUBurst &burst) {
+    if (imuWire == NULL) {
+        return false;
+    }
+    imuWire->beginTransmission(IMU_ADDRESS);
+    imuWire->write(BNO055_BURST_FIRST_REG);
+    if (imuWire->endTransmission(false) != 0) {  // repeated start
+        return false;
+    }
+    if (imuWire->requestFrom(IMU_ADDRESS, (uint8_t)BNO055_BURST_BYTES) != BNO055_BURST_BYTES) {
+        return false;
+    }
+    uint8_t bytes[BNO055_BURST_BYTES];
+    for (uint8_t i = 0; i < BNO055_BURST_BYTES; i++) {
+        bytes[i] = imuWire->read();
+    }
+    IMU_decodeBurst(bytes, burst);
+    return true;
+}
+
+/**
+ * @brief Decode the data bytes of a burst read.
+ *
+ * @param bytes The BNO055_BURST_BYTES bytes read from register 0x14 onwards.
+ * @param[out] burst Filled with the rates, angles and calibration status.
+ *
+ * @details Every value is a little-endian two's complement pair of registers:
+ *   - 0x14-0x19 gyroscope X, Y and Z
+ *   - 0x1A-0x1F Euler heading, roll and pitch
+ *   - 0x35 CALIB_STAT
+ */
+void IMU_decodeBurst(const uint8_t* bytes, IMUBurst &burst) {
+    int16_t* const values[] = {&burst.gyro.x, &burst.gyro.y, &burst.gyro.z,
+                               &burst.euler.x, &burst.euler.y, &burst.euler.z};
+    for (uint8_t v = 0; v < 6; v++) {
+        *values[v] = (int16_t)(bytes[2*v] | (bytes[2*v + 1] << 8));
+    }
+    burst.calibration = bytes[BNO055_CALIB_STAT_REG - BNO055_BURST_FIRST_REG];
+}
+
+/**
+ * @brief Check whether a CALIB_STAT value reports full calibration.
+ *
+ * @param calibration CALIB_STAT as read by IMU_readBurst().
+ *
+ * @return bool True if the system, gyroscope, accelerometer and magnetometer
+ *         are all at calibration level 3.
+ *
+ * @details Unlike IMU_isCalibrated(), this costs no transaction.
+ */
+bool IMU_isCalibrated(uint8_t calibration) {
+    return calibration == 0xFF;
+}
@@ -7,14 +7,60 @@
 
 #include <Adafruit_BNO055.h>
 #include <utility/imumaths.h>
+#include <Wire.h>
 
-// Initialize IMU with default calibration timeout (ms).
+// First register of the burst read, the gyroscope X rate LSB
+#define BNO055_BURST_FIRST_REG 0x14
+// Last register of the burst read, CALIB_STAT
+#define BNO055_CALIB_STAT_REG 0x35
+// Data bytes in one burst read: gyroscope, Euler angles, quaternion, linear acceleration, gravity, temperature and CALIB_STAT
+#define BNO055_BURST_BYTES (BNO055_CALIB_STAT_REG - BNO055_BURST_FIRST_REG + 1)
+// Counts per degree of the Euler angles and per degree per second of the gyroscope, in the default units
+#define BNO055_LSB_PER_DEGREE 16
+
+// Three axes of a BNO055 reading in its raw counts
+struct IMUVector {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+// The parts of one burst read used for control, in raw counts
+struct IMUBurst {
+    IMUVector gyro;      // X, Y and Z rates in 1/16 degree per second
+    IMUVector euler;     // Heading, roll and pitch in 1/16 degree
+    uint8_t calibration; // CALIB_STAT: system, gyroscope, accelerometer and magnetometer, 2 bits each from the top
+};
+
+// One reading of the platform's roll and pitch, published by the IMU sampling task
+struct IMUSample {
+    int16_t x;           // Roll in 1/16 degree
+    int16_t y;           // Pitch in 1/16 degree
+    int16_t xRate;       // Rate of change of roll in 1/16 degree per second
+    int16_t yRate;       // Rate of change of pitch in 1/16 degree per second
+    uint8_t calibration; // CALIB_STAT of the read
+    int64_t readAt;      // esp_timer_get_time() when the read started, close to when the IMU latched the angles
+    uint32_t dropped;    // Reads which failed or missed their deadline before this sample
+};
+
+// How fresh the IMU samples used by the motor control task were
+struct IMUStats {
+    uint32_t samples;   // Samples published by the IMU sampling task
+    uint32_t dropped;   // Reads which failed or missed their deadline
+    uint32_t ageUs;     // Age of the sample used by the latest control cycle
+    uint32_t maxAgeUs;  // Oldest sample used by a control cycle
+    uint32_t reused;    // Control cycles which found no new sample and kept the last one
+    uint32_t stale;     // Control cycles whose sample was older than IMU_STALE_US
+    uint8_t calibration; // CALIB_STAT of the latest sample
+};
+
+// Initialize IMU on the given bus with default calibration timeout (ms).
 // Returns true if sensor is found and initialized (even if not fully calibrated yet).
-bool IMU_init();
+bool IMU_init(TwoWire* bus);
 
 // Initialize IMU with a specific calibration timeout (ms).
 // Pass 0 to skip blocking for calibration.
-bool IMU_init(unsigned long calibrationTimeoutMs);
+bool IMU_init(TwoWire* bus, unsigned long calibrationTimeoutMs);
 
 // Get roll (X) and pitch (Y) in degrees.
 void IMU_getAngles(float &x_angle, float &y_angle);
@@ -22,4 +68,14 @@ void IMU_getAngles(float &x_angle, float &y_angle);
 // Check if the BNO055 reports "fully calibrated".
 bool IMU_isCalibrated();
 
+// Read the gyroscope, Euler angles and calibration status in one transaction.
+// Returns false if the sensor was not initialized or did not answer.
+bool IMU_readBurst(IMUBurst &burst);
+
+// Decode the BNO055_BURST_BYTES data bytes of a burst read.
+void IMU_decodeBurst(const uint8_t* bytes, IMUBurst &burst);
+
+// Check whether a CALIB_STAT value reports every part fully calibrated.
+bool IMU_isCalibrated(uint8_t calibration);
+
 #endif
@@ -0,0 +1,93 @@
+/*!
+ * @file MotorServo.cpp
+ * @author Setting-Dawn
+ * @brief A position and velocity servo of one motor, closed on its encoder.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include "MotorServo.h"
+#include "ENCODER.h"
+#include "MOTOR.h"
+
+/*! @brief Creates a servo for a motor and its encoder
+* @details The motor and encoder must already be initialized. The motor is not driven until
+* begin() is called.
+* @param motorEncoder the encoder on the motor's shaft
+* @param motorPin1 first pin of the motor driver
+* @param motorPin2 second pin of the motor driver
+* @param motorChannel1 PWM channel driving the motor forward
+* @param motorChannel2 PWM channel driving the motor in reverse
+* @param servoGains gains of the position and velocity loops
+*/
+MotorServo::MotorServo(ESP32Encoder* motorEncoder, uint8_t motorPin1, uint8_t motorPin2,
+                       uint8_t motorChannel1, uint8_t motorChannel2, const MotorServoGains& servoGains)
+{
+    encoder = motorEncoder;
+    pin1 = motorPin1;
+    pin2 = motorPin2;
+    channel1 = motorChannel1;
+    channel2 = motorChannel2;
+    gains = servoGains;
+    reference = 0;
+    lastCount = 0;
+    integral = 0.0f;
+    memset(&state, 0, sizeof(state));
+}
+
+/*! @brief Holds the motor where it is now, which becomes position 0
+*/
+void MotorServo::begin(void)
+{
+    reference = ENCODER_getCount(*encoder);
+    lastCount = reference;
+    integral = 0.0f;
+    memset(&state, 0, sizeof(state));
+}
+
+/*! @brief Runs one update of the servo and drives the motor
+* @param target position to drive towards, in counts from where the motor was when the servo began
+* @param dt time in seconds since the previous update; if not positive, as when a cycle is timed
+* before the clock moves, the filtered velocity is kept and nothing is integrated
+* @return the signed PWM duty applied
+*/
+int16_t MotorServo::update(int32_t target, float dt)
+{
+    int64_t count = ENCODER_getCount(*encoder);
+    if (dt > 0.0f)
+    {
+        float measured = (float)(count - lastCount) / dt;
+        lastCount = count;
+        state.velocity += gains.velocityFilter * (measured - state.velocity);
+    }
+    else {dt = 0.0f;} // Counts turned since the last update are measured over the next one instead
+    state.position = (int32_t)(count - reference);
+    state.target = target;
+
+    // The position loop sets the velocity and the velocity loop the duty
+    float velocity = constrain(gains.positionGain * (target - state.position), -gains.maxVelocity, gains.maxVelocity);
+    float error = velocity - state.velocity;
+    float effort = gains.velocityGain * error + gains.velocityIntegralGain * (integral + error * dt);
+    if (effort > MOTOR_SERVO_MAX_EFFORT) {effort = MOTOR_SERVO_MAX_EFFORT;}
+    else if (effort < -MOTOR_SERVO_MAX_EFFORT) {effort = -MOTOR_SERVO_MAX_EFFORT;}
+    else {integral += error * dt;} // Only integrate while the output can still follow
+    state.effort = (int16_t)effort;
+
+    if (state.effort > 0) {MOTOR_forward(pin1, pin2, channel1, channel2, state.effort);}
+    else if (state.effort < 0) {MOTOR_reverse(pin1, pin2, channel1, channel2, -state.effort);}
+    else {MOTOR_brake(pin1, pin2, channel1, channel2);}
+    return state.effort;
+}
+
+/*! @brief Stops the motor
+*/
+void MotorServo::brake(void)
+{
+    state.effort = 0;
+    MOTOR_brake(pin1, pin2, channel1, channel2);
+}
+
+/*! @brief Gets the latest update of the servo
+* @return its position, target, velocity and effort
+*/
+const MotorServoState& MotorServo::getState(void) {return state;}
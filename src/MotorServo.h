@@ -0,0 +1,78 @@
+/*!
+ * @file MotorServo.h
+ * @author Setting-Dawn
+ * @brief Header file for a position and velocity servo of one motor, closed on its encoder.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __MOTORSERVO_H__
+#define __MOTORSERVO_H__
+
+#include <Arduino.h>
+#include <ESP32Encoder.h>
+
+/// Largest PWM duty cycle a servo drives its motor with
+#define MOTOR_SERVO_MAX_EFFORT 255
+
+/**
+ * @struct MotorServoGains
+ * @brief Gains of the position loop and the velocity loop inside it.
+ */
+struct MotorServoGains {
+    float positionGain;   ///< Velocity commanded per count of position error, in 1/s
+    float maxVelocity;    ///< Largest velocity the position loop commands, in counts/s
+    float velocityGain;   ///< PWM duty per count/s of velocity error
+    float velocityIntegralGain; ///< PWM duty per count of accumulated velocity error
+    float velocityFilter; ///< Weight of each new velocity measurement, from 0 to 1
+};
+
+/**
+ * @struct MotorServoState
+ * @brief The latest update of a servo.
+ */
+struct MotorServoState {
+    int32_t position;     ///< Encoder counts from where the motor was when the servo began
+    int32_t target;       ///< Position it was driven towards
+    float velocity;       ///< Filtered velocity in counts/s
+    int16_t effort;       ///< Signed PWM duty applied, positive driving the motor forward
+};
+
+/**
+ * @struct MotorServoTargets
+ * @brief Positions to drive the servos of both axes to, in counts from where each motor was when its servo began.
+ */
+struct MotorServoTargets {
+    int32_t x;
+    int32_t y;
+};
+
+/**
+ * @class MotorServo
+ * @brief Drives a motor to an encoder position through a velocity loop.
+ *
+ * @details The position error sets a velocity, limited to a safe speed, and a PI loop on the
+ * velocity measured from the encoder sets the PWM duty. The encoder is counted by the PCNT
+ * peripheral, so reading it costs nothing on the bus and the servo can run at a kilohertz or
+ * more, far faster than the IMU can be read. The integral stops accumulating while the output
+ * is saturated in the same direction. Driving the motor forward must count its encoder up.
+ */
+class MotorServo {
+    private:
+        ESP32Encoder* encoder;
+        uint8_t pin1, pin2, channel1, channel2;
+        MotorServoGains gains;
+        int64_t reference;  // Encoder count positions are measured from
+        int64_t lastCount;
+        float integral;     // Accumulated velocity error in counts
+        MotorServoState state;
+    public:
+        MotorServo(ESP32Encoder* motorEncoder, uint8_t motorPin1, uint8_t motorPin2,
+                   uint8_t motorChannel1, uint8_t motorChannel2, const MotorServoGains& servoGains);
+        void begin(void);
+        int16_t update(int32_t target, float dt);
+        void brake(void);
+        const MotorServoState& getState(void);
+};
+
+#endif //__MOTORSERVO_H__
@@ -0,0 +1,85 @@
+/*!
+ * @file PCA9956Bulk.cpp
+ * @author Setting-Dawn
+ * @brief Implementation of a register-level PCA9956B driver which sets all outputs in one write.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include "PCA9956Bulk.h"
+
+/**
+ * @brief Creates a driver for one PCA9956B on the given bus.
+ *
+ * @param bus the TWI bus the PCA9956B is connected to
+ * @param PCAaddress the TWI address of the PCA9956B
+ */
+PCA9956Bulk::PCA9956Bulk(TwoWire* bus, uint8_t PCAaddress)
+{
+    wire = bus;
+    address = PCAaddress;
+    transactions = 0;
+    bytes = 0;
+}
+
+/*! @brief Wakes the PCA9956B with every output off and sets the output current
+* @details Outputs are set to change on STOP, so each writeLedOut() takes effect at once.
+* @param current IREF value of every channel, 0xFF for the maximum current
+* @return true if the PCA9956B acknowledged the configuration
+*/
+bool PCA9956Bulk::begin(uint8_t current)
+{
+    static const uint8_t off[PCA9956_BANK_LEDOUT_BYTES] = {0};
+
+    return writeRegister(PCA9956_MODE1_REG, 0x00) // Normal mode, no sub-addresses
+        && writeRegister(PCA9956_MODE2_REG, PCA9956_MODE2_DEFAULT)
+        && writeRegister(PCA9956_IREFALL_REG, current)
+        && writeLedOut(off);
+}
+
+/*! @brief Sets the state of channels 0-15 in a single auto-increment write
+* @param image LEDOUT0-LEDOUT3, two bits per channel with channel 0 in the lowest bits
+* @return true if the PCA9956B acknowledged the write
+*/
+bool PCA9956Bulk::writeLedOut(const uint8_t image[PCA9956_BANK_LEDOUT_BYTES])
+{
+    wire->beginTransmission(address);
+    wire->write(PCA9956_LEDOUT0_REG | PCA9956_AUTO_INCREMENT);
+    wire->write(image, PCA9956_BANK_LEDOUT_BYTES);
+    transactions++;
+    bytes += PCA9956_LEDOUT_WRITE_BYTES;
+    return wire->endTransmission() == 0;
+}
+
+/*! @brief Gets the number of TWI transactions issued since the counters were cleared
+* @return transaction count
+*/
+uint32_t PCA9956Bulk::getTransactions(void) {return transactions;}
+
+/*! @brief Gets the number of bytes put on the bus since the counters were cleared
+* @return byte count, including address bytes
+*/
+uint32_t PCA9956Bulk::getBytes(void) {return bytes;}
+
+/*! @brief Clears the transaction and byte counters
+*/
+void PCA9956Bulk::clearCounters(void)
+{
+    transactions = 0;
+    bytes = 0;
+}
+
+/*! @brief Writes one register
+* @param reg the register address
+* @param value the value to write
+* @return true if the PCA9956B acknowledged the write
+*/
+bool PCA9956Bulk::writeRegister(uint8_t reg, uint8_t value)
+{
+    wire->beginTransmission(address);
+    wire->write(reg);
+    wire->write(value);
+    transactions++;
+    bytes += 3;
+    return wire->endTransmission() == 0;
+}
@@ -0,0 +1,58 @@
+/*!
+ * @file PCA9956Bulk.h
+ * @author Setting-Dawn
+ * @brief Header file for a register-level PCA9956B driver which sets all outputs in one write.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __PCA9956BULK_H__
+#define __PCA9956BULK_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// PCA9956B register map
+#define PCA9956_MODE1_REG    0x00
+#define PCA9956_MODE2_REG    0x01
+#define PCA9956_LEDOUT0_REG  0x02
+#define PCA9956_IREFALL_REG  0x40
+
+/// Set in the control byte to auto-increment the register address after every data byte
+#define PCA9956_AUTO_INCREMENT 0x80
+/// MODE2 at reset, with OCH clear so outputs change on the STOP condition
+#define PCA9956_MODE2_DEFAULT  0x05
+/// LEDOUT value of a channel driven fully on at its IREF current
+#define PCA9956_LED_ON         0x01
+/// LEDOUT registers covering channels 0-15, the channels of one electrode bank
+#define PCA9956_BANK_LEDOUT_BYTES 4
+/// Bytes on the bus for one writeLedOut() of a bank, including the address byte
+#define PCA9956_LEDOUT_WRITE_BYTES (2 + PCA9956_BANK_LEDOUT_BYTES)
+
+/**
+ * @class PCA9956Bulk
+ * @brief Drives a PCA9956B as an on/off current source, switching channels with one burst.
+ *
+ * @details The LEDOUT registers of channels 0-15 are contiguous, so writing a complete
+ * register image with auto-increment turns one channel off and another on in a single
+ * transaction. The outputs only take the new values at the STOP condition, so the switch
+ * is atomic. The driver counts the transactions and bytes it puts on the bus.
+ */
+class PCA9956Bulk {
+    private:
+        TwoWire* wire;
+        uint8_t address;
+        uint32_t transactions; // TWI transactions issued since the counters were cleared
+        uint32_t bytes;        // Bytes on the bus, including address bytes, since the counters were cleared
+
+        bool writeRegister(uint8_t reg, uint8_t value);
+    public:
+        PCA9956Bulk(TwoWire* bus, uint8_t PCAaddress);
+        bool begin(uint8_t current);
+        bool writeLedOut(const uint8_t image[PCA9956_BANK_LEDOUT_BYTES]);
+        uint32_t getTransactions(void);
+        uint32_t getBytes(void);
+        void clearCounters(void);
+};
+
+#endif //__PCA9956BULK_H__
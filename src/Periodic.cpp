@@ -0,0 +1,85 @@
+/*!
+ * @file Periodic.cpp
+ * @author Setting-Dawn
+ * @brief A fixed-rate executor which times the cycles of a periodic task.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include "Periodic.h"
+
+/*! @brief Creates an executor for a task with a fixed period
+* @details No cycles are timed until begin() is called.
+* @param period time between cycle starts in us, a whole number of scheduler ticks
+* @param bin width in us of each bin of the period jitter histogram
+*/
+Periodic::Periodic(uint32_t period, uint32_t bin) : published("Periodic Stats")
+{
+    periodUs = period;
+    periodTicks = period / 1000 / portTICK_PERIOD_MS;
+    if (periodTicks == 0) {periodTicks = 1;}
+    lastWake = 0;
+    lastStart = 0;
+    memset(&stats, 0, sizeof(stats));
+    stats.periodUs = period;
+    stats.binUs = bin;
+}
+
+/*! @brief Starts the first cycle now and clears the statistics
+* @details Called by the task running the cycles, again whenever it resumes them after a pause,
+* so the pause is not counted as an overrun.
+*/
+void Periodic::begin(void)
+{
+    uint32_t bin = stats.binUs;
+    memset(&stats, 0, sizeof(stats));
+    stats.periodUs = periodUs;
+    stats.binUs = bin;
+    lastWake = xTaskGetTickCount();
+    lastStart = esp_timer_get_time();
+    published.put(stats);
+}
+
+/*! @brief Ends the current cycle and blocks until the next one is due
+* @details If the next cycle was already due when this is called, the cycle is counted as
+* an overrun and every wakeup before the current tick is skipped; one due on the current
+* tick starts right away.
+* @return measured time in seconds between the start of the cycle that just ended and
+* the start of the new one
+*/
+float Periodic::wait(void)
+{
+    int64_t end = esp_timer_get_time();
+    stats.workUs = (uint32_t)(end - lastStart);
+    if (stats.workUs > stats.maxWorkUs) {stats.maxWorkUs = stats.workUs;}
+
+    TickType_t late = xTaskGetTickCount() - lastWake;
+    if (late >= periodTicks)
+    {
+        TickType_t missed = (late - 1) / periodTicks;
+        stats.overruns++;
+        stats.skipped += missed;
+        lastWake += missed * periodTicks;
+    }
+    vTaskDelayUntil(&lastWake, periodTicks);
+
+    int64_t start = esp_timer_get_time();
+    uint32_t dt = (uint32_t)(start - lastStart);
+    lastStart = start;
+
+    stats.cycles++;
+    stats.dtUs = dt;
+    if (stats.cycles == 1 || dt < stats.minDtUs) {stats.minDtUs = dt;}
+    if (dt > stats.maxDtUs) {stats.maxDtUs = dt;}
+    uint32_t jitter = dt > periodUs ? dt - periodUs : periodUs - dt;
+    uint32_t bin = stats.binUs ? jitter / stats.binUs : 0;
+    stats.jitter[bin < PERIODIC_JITTER_BINS ? bin : PERIODIC_JITTER_BINS - 1]++;
+    published.put(stats);
+
+    return dt * 1.0e-6f;
+}
+
+/*! @brief Copies the cycle statistics
+* @param copy receives the timing of every cycle since begin()
+*/
+void Periodic::getStats(PeriodicStats& copy) {published.get(copy);}
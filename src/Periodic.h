@@ -0,0 +1,64 @@
+/*!
+ * @file Periodic.h
+ * @author Setting-Dawn
+ * @brief Header file for a fixed-rate executor which times the cycles of a periodic task.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __PERIODIC_H__
+#define __PERIODIC_H__
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "SeqShare.h"
+
+/// Bins of the period jitter histogram; the last one counts every cycle beyond the others
+#define PERIODIC_JITTER_BINS 8
+
+/**
+ * @struct PeriodicStats
+ * @brief Timing of the cycles of a periodic task since it was last started.
+ */
+struct PeriodicStats {
+    uint32_t periodUs;     ///< Nominal period
+    uint32_t binUs;        ///< Width of each jitter bin
+    uint32_t cycles;       ///< Cycles run
+    uint32_t overruns;     ///< Cycles whose work was still running when the next one was due
+    uint32_t skipped;      ///< Wakeups dropped to get back in phase after overruns
+    uint32_t dtUs;         ///< Measured time between the starts of the last two cycles
+    uint32_t minDtUs;      ///< Shortest time between cycle starts
+    uint32_t maxDtUs;      ///< Longest time between cycle starts
+    uint32_t workUs;       ///< Time the last cycle ran before waiting again
+    uint32_t maxWorkUs;    ///< Longest time a cycle ran
+    uint32_t jitter[PERIODIC_JITTER_BINS]; ///< Cycles by how far their dt was from the period, binUs per bin
+};
+
+/**
+ * @class Periodic
+ * @brief Wakes a task at absolute multiples of its period and measures when it actually ran.
+ *
+ * @details The task calls wait() once per cycle. Wakeups are kept on a grid of scheduler
+ * ticks by vTaskDelayUntil, so the time a cycle's work takes does not add to its period.
+ * A cycle still running when the next one is due is counted as an overrun, and the missed
+ * wakeups are dropped rather than run back to back, so the task keeps its phase. wait()
+ * returns the time since the previous cycle started, measured with esp_timer, for use by
+ * control laws that integrate or differentiate over time. Only the task running the cycles
+ * may call begin() and wait(); the statistics can be read by any task.
+ */
+class Periodic {
+    private:
+        uint32_t periodUs;
+        TickType_t periodTicks;
+        TickType_t lastWake;    // Tick the current cycle was due at
+        int64_t lastStart;      // esp_timer_get_time() when the current cycle started
+        PeriodicStats stats;    // Only changed by the task running the cycles
+        SeqShare<PeriodicStats> published;
+    public:
+        Periodic(uint32_t period, uint32_t bin);
+        void begin(void);
+        float wait(void);
+        void getStats(PeriodicStats& copy);
+};
+
+#endif //__PERIODIC_H__
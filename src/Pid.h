@@ -0,0 +1,151 @@
+/*!
+ * @file Pid.h
+ * @author Setting-Dawn
+ * @brief A PID controller for several axes with gains fixed at compile time, in float or fixed point.
+ * @version 1.1.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __PID_H__
+#define __PID_H__
+
+#include <Arduino.h>
+#include "Fixed.h"
+
+/**
+ * @class Pid
+ * @brief Runs the same PID law on every axis of a controller in one step.
+ *
+ * @details The gains come from the Config type, so they are converted to the number type
+ * once at compile time and the update compiles to straight-line arithmetic. Config provides
+ * as static constexpr members:
+ * - axes, the number of axes controlled together
+ * - kp, output per unit of error
+ * - ki, output per unit of error per second
+ * - kd, output per unit per second of change in the measurement
+ * - derivativeFilter, weight from 0 to 1 of each new rate in the filtered derivative, 1 for none
+ * - outputLimit, the largest output magnitude
+ *
+ * The derivative acts on the measurement rather than the error, so setpoint changes do not
+ * kick the output, and is low pass filtered against sensor quantization. It is either taken
+ * from successive measurements or, when the sensor measures the rate itself, passed in.
+ * The integral is only advanced when doing so does not push a saturated output further into
+ * saturation, so it never winds up. The state of all axes is kept as one array per term.
+ * @tparam T float, or a Fixed type such as Q16
+ * @tparam Config the gains and limits
+ */
+template <typename T, typename Config>
+class Pid {
+    public:
+        static constexpr uint8_t axes = Config::axes;
+    private:
+        static constexpr T zero = FixedValue<T>::from(0.0f);
+        static constexpr T kp = FixedValue<T>::from(Config::kp);
+        static constexpr T ki = FixedValue<T>::from(Config::ki);
+        static constexpr T kd = FixedValue<T>::from(Config::kd);
+        static constexpr T filter = FixedValue<T>::from(Config::derivativeFilter);
+        static constexpr T limit = FixedValue<T>::from(Config::outputLimit);
+        static_assert(Config::derivativeFilter > 0.0f && Config::derivativeFilter <= 1.0f, "The derivative filter weight must be in (0, 1]");
+        static_assert(Config::outputLimit > 0.0f, "The output limit must be positive");
+
+        T integral[axes];        // Integral term, in output units
+        T rate[axes];            // Filtered rate of change of the measurement per second
+        T lastMeasurement[axes];
+        T output[axes];
+        bool primed;             // Whether lastMeasurement holds a measurement yet
+
+        /*! @brief Sets the output of every axis from its error and filtered rate
+        * @param setpoint the value each axis should reach
+        * @param measurement the latest measurement of each axis
+        * @param dt time in seconds since the previous update
+        * @return the output of each axis
+        */
+        const T* drive(const T (&setpoint)[axes], const T (&measurement)[axes], T dt)
+        {
+            for (uint8_t a=0;a<axes;a++)
+            {
+                T error = setpoint[a] - measurement[a];
+                T fixedPart = kp * error - kd * rate[a];
+                T advanced = integral[a] + ki * error * dt;
+                T value = fixedPart + advanced;
+                // Keep the integral where it was if advancing it would drive the output further past its limit
+                if ((value > limit && error > zero) || (value < -limit && error < zero))
+                {
+                    value = fixedPart + integral[a];
+                }
+                else
+                {
+                    integral[a] = advanced;
+                }
+                output[a] = value > limit ? limit : value < -limit ? -limit : value;
+            }
+            return output;
+        }
+    public:
+        /*! @brief Creates a controller with no accumulated state
+        */
+        Pid(void) {reset();}
+
+        /*! @brief Clears the integral and derivative of every axis
+        * @details The next update takes its measurement as the reference for the derivative.
+        */
+        void reset(void)
+        {
+            for (uint8_t a=0;a<axes;a++)
+            {
+                integral[a] = zero;
+                rate[a] = zero;
+                lastMeasurement[a] = zero;
+                output[a] = zero;
+            }
+            primed = false;
+        }
+
+        /*! @brief Runs one update of every axis, differentiating the measurements
+        * @param setpoint the value each axis should reach
+        * @param measurement the latest measurement of each axis
+        * @param dt time in seconds since the previous update, over which the error is integrated
+        * @param sampleDt time in seconds between this measurement and the previous one, or 0 if the
+        * measurement is not new, which keeps the previous rate
+        * @return the output of each axis, limited to +-outputLimit
+        */
+        const T* update(const T (&setpoint)[axes], const T (&measurement)[axes], T dt, T sampleDt)
+        {
+            if (sampleDt > zero)
+            {
+                for (uint8_t a=0;a<axes;a++)
+                {
+                    T measured = primed ? (measurement[a] - lastMeasurement[a]) / sampleDt : zero;
+                    rate[a] = rate[a] + filter * (measured - rate[a]);
+                    lastMeasurement[a] = measurement[a];
+                }
+                primed = true;
+            }
+            return drive(setpoint, measurement, dt);
+        }
+
+        /*! @brief Runs one update of every axis with rates measured by the sensor
+        * @param setpoint the value each axis should reach
+        * @param measurement the latest measurement of each axis
+        * @param measuredRate the rate of change of each measurement per second
+        * @param dt time in seconds since the previous update, over which the error is integrated
+        * @return the output of each axis, limited to +-outputLimit
+        */
+        const T* update(const T (&setpoint)[axes], const T (&measurement)[axes], const T (&measuredRate)[axes], T dt)
+        {
+            for (uint8_t a=0;a<axes;a++)
+            {
+                rate[a] = rate[a] + filter * (measuredRate[a] - rate[a]);
+                lastMeasurement[a] = measurement[a];
+            }
+            primed = true;
+            return drive(setpoint, measurement, dt);
+        }
+
+        /*! @brief Gets the outputs of the latest update
+        * @return the output of each axis
+        */
+        const T* getOutput(void) {return output;}
+};
+
+#endif //__PID_H__
@@ -0,0 +1,78 @@
+/*!
+ * @file SeqShare.h
+ * @author Setting-Dawn
+ * @brief A lock-free share for large values, built on a sequence lock.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __SEQSHARE_H__
+#define __SEQSHARE_H__
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * @class SeqShare
+ * @brief Passes the latest value of a large type from one writer task to any number of readers.
+ *
+ * @details Unlike Share, the writer never waits: it bumps the sequence counter to an odd
+ * value, copies the data in and bumps it to the next even value. Readers copy the data out
+ * and retry whenever the counter was odd or changed during the copy, so they always get a
+ * complete, untorn value. Only one task may put values.
+ * @tparam T a trivially copyable type
+ */
+template <typename T>
+class SeqShare {
+    protected:
+        std::atomic<uint32_t> seq; // Twice the number of completed puts, odd while a put is running
+        T data;
+        const char* name;
+    public:
+        /*! @brief Creates a share holding a value initialized to zero
+        * @param p_name a name for the share, used only for debugging
+        */
+        SeqShare(const char* p_name = NULL) : seq(0), data(), name(p_name) {}
+
+        /*! @brief Publishes a new value without blocking
+        * @param value the value to copy into the share
+        */
+        void put(const T& value)
+        {
+            uint32_t s = seq.load(std::memory_order_relaxed);
+            seq.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            memcpy((void*)&data, &value, sizeof(T));
+            seq.store(s + 2, std::memory_order_release);
+        }
+
+        /*! @brief Copies the latest complete value out of the share
+        * @details Retries until a copy was made with no put running. If the writer
+        * was preempted in the middle of a put, the reader sleeps a tick to let it finish.
+        * @param value reference receiving the value
+        * @return the number of values put up to and including the one copied, 0 if nothing was put yet
+        */
+        uint32_t get(T& value)
+        {
+            for (uint8_t attempt = 0; ; attempt++)
+            {
+                uint32_t before = seq.load(std::memory_order_acquire);
+                if ((before & 1) == 0)
+                {
+                    memcpy(&value, (const void*)&data, sizeof(T));
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (seq.load(std::memory_order_relaxed) == before) {return before / 2;}
+                }
+                if (attempt >= 3) {vTaskDelay(1);}
+            }
+        }
+
+        /*! @brief Gets the number of values put so far without copying
+        * @details Only completed puts are counted, so a put still running never shows as a
+        * new value. The count wraps to 0 after 2^31 puts; compare counts for equality only.
+        * @return the number of completed puts
+        */
+        uint32_t sequence(void) {return seq.load(std::memory_order_acquire) / 2;}
+};
+
+#endif //__SEQSHARE_H__
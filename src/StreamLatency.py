@@ -0,0 +1,140 @@
+###
+# @author Setting-Dawn
+# @date 2026-Oct-16
+# @file StreamLatency.py
+# @brief Measures how long frames take to reach a client of the ESP32's WebSocket stream.
+# @details A stand-in for ExternalInterpret.py which acknowledges every frame as soon as it
+# arrives, so the latency measured is that of the firmware and the network alone rather
+# than of the reconstruction. Two measurements are reported:
+# - the latency the ESP32 measures from the end of a frame to its acknowledgement, read
+#   from /stats as streamLatencyMs every few frames
+# - the latency of each frame on arrival, from the ESP32's millis() timestamp in its header,
+#   relative to the fastest frame as the two clocks are not synchronized
+# Frames which were measured but never arrived show as gaps in the sequence numbers.
+###
+from __future__ import absolute_import, division, print_function
+
+import math
+import struct
+import time
+import requests
+import websocket
+
+# Replace with the ESP32's IP address from Serial Monitor
+ESP32_IP = "192.168.5.1"
+
+# Frames to measure, and how often the ESP32's own latency measurement is read
+FRAMES = 500
+STATS_EVERY = 10
+
+def decode_header(data):
+    """!
+    decode the header of a frame in the binary format described in EITbinary.h
+
+    Parameters
+    ----------
+    @param data : bytes
+        the encoded frame
+
+    Returns
+    -------
+    @return sequence:
+        sequence number of the frame
+    @return timestamp:
+        millis() on the ESP32 when the frame was measured
+    """
+    magic, version, header_size, sequence, timestamp = struct.unpack_from("<4sHHII", data)
+    if magic != b"EITF" or version != 1:
+        raise ValueError("Not an EIT frame")
+    return sequence,timestamp
+
+def read_stat(name):
+    """!
+    read one value from the ESP's /stats page
+
+    Parameters
+    ----------
+    @param name : str
+        label of the value
+
+    Returns
+    -------
+    @return the value, or None if it is not served
+    """
+    resp = requests.get(f"http://{ESP32_IP}/stats", timeout=1)
+    resp.raise_for_status()
+    for line in resp.text.splitlines():
+        label, _, value = line.partition(",")
+        if label == name:
+            return float(value)
+    return None
+
+def percentile(values, p):
+    """!
+    find a percentile of a list of values by the nearest rank
+
+    Parameters
+    ----------
+    @param values : list
+        the values, not empty
+    @param p : float
+        the percentile, from 0 to 100
+
+    Returns
+    -------
+    @return the value at that rank
+    """
+    ordered = sorted(values)
+    rank = max(1, math.ceil(p / 100.0 * len(ordered)))
+    return ordered[rank - 1]
+
+def report(label, values):
+    """!
+    print the median, 99th percentile and largest of a list of latencies
+
+    Parameters
+    ----------
+    @param label : str
+        what was measured
+    @param values : list
+        the latencies in ms
+
+    Returns
+    -------
+    none
+    """
+    if not values:
+        print(f"{label}: no measurements")
+        return
+    print(f"{label}: median {percentile(values, 50):.1f} ms, p99 {percentile(values, 99):.1f} ms, "
+          f"max {max(values):.1f} ms over {len(values)} frames")
+
+ws = websocket.create_connection(f"ws://{ESP32_IP}/ws", timeout=2)
+
+offsets = []    # Arrival on this clock minus the ESP32's timestamp, in ms
+espLatency = [] # streamLatencyMs read from /stats
+gaps = 0
+lastSequence = None
+while len(offsets) < FRAMES:
+    data = ws.recv()
+    arrived = time.monotonic() * 1000.0
+    sequence,timestamp = decode_header(data)
+    # Acknowledge straight away, before anything else is done with the frame
+    ws.send(f"ack={sequence}")
+
+    offsets.append(arrived - timestamp)
+    if lastSequence is not None and sequence > lastSequence + 1:
+        gaps += sequence - lastSequence - 1
+    lastSequence = sequence
+
+    if len(offsets) % STATS_EVERY == 0:
+        latency = read_stat("streamLatencyMs")
+        if latency is not None:
+            espLatency.append(latency)
+
+ws.close()
+
+fastest = min(offsets)
+report("Frame to acknowledgement, measured by the ESP32", espLatency)
+report("Arrival relative to the fastest frame", [offset - fastest for offset in offsets])
+print(f"Frames measured but not received: {gaps}")
@@ -0,0 +1,234 @@
+/*!
+ * @file TWIbus.cpp
+ * @author Setting-Dawn
+ * @brief A task which owns a TWI bus and runs prioritized, queued transactions on it.
+ * @version 1.1.0
+ * @date 2026-Oct-16
+ */
+
+#include "TWIbus.h"
+
+/*! @brief Creates a bus manager for a TWI bus
+* @details No transactions can be run until begin() has started the bus task.
+* @param bus the bus to manage; no other code may use it directly once begin() is called
+*/
+TWIBus::TWIBus(TwoWire* bus) : published("TWI Stats")
+{
+    wire = bus;
+    queue[TWI_PRIORITY_HIGH] = NULL;
+    queue[TWI_PRIORITY_LOW] = NULL;
+    task = NULL;
+    frequency = 100000;
+    clock = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+/*! @brief Gives a device its own bus clock
+* @details Must be called before begin().
+* @param address TWI address of the device
+* @param deviceFrequency clock its jobs run at, in Hz
+* @return false if the clock table is full
+*/
+bool TWIBus::addDevice(uint8_t address, uint32_t deviceFrequency)
+{
+    TWIDeviceStats* device = findDevice(address);
+    if (device == NULL)
+    {
+        if (stats.devices == TWI_MAX_DEVICES) {return false;}
+        device = &stats.device[stats.devices++];
+        device->address = address;
+    }
+    device->frequency = deviceFrequency;
+    return true;
+}
+
+/*! @brief Starts the bus controller, creates the job queues and starts the bus task
+* @details Drivers which begin the bus again later keep these pins and this clock.
+* @param name name of the bus task
+* @param priority priority of the bus task, which should be above that of every client
+* so that queued work starts immediately
+* @param sdaPin the data pin of the bus
+* @param sclPin the clock pin of the bus
+* @param busFrequency the clock in Hz of jobs for devices not in the clock table
+* @return true if the bus task is running
+*/
+bool TWIBus::begin(const char* name, UBaseType_t priority, int sdaPin, int sclPin, uint32_t busFrequency)
+{
+    frequency = busFrequency;
+    clock = busFrequency;
+    if (!wire->begin(sdaPin, sclPin, busFrequency)) {return false;}
+
+    queue[TWI_PRIORITY_HIGH] = xQueueCreate(TWI_QUEUE_LENGTH, sizeof(TWIJob*));
+    queue[TWI_PRIORITY_LOW] = xQueueCreate(TWI_QUEUE_LENGTH, sizeof(TWIJob*));
+    if (queue[TWI_PRIORITY_HIGH] == NULL || queue[TWI_PRIORITY_LOW] == NULL) {return false;}
+
+    stats.startedAt = esp_timer_get_time();
+    published.put(stats);
+    return xTaskCreate(taskFunction, name, 4096, this, priority, &task) == pdPASS;
+}
+
+/*! @brief Gets the bus this manager owns
+* @details Only for use by job functions, which run with exclusive use of the bus, or while
+* no task has queued any jobs yet.
+* @return the managed bus
+*/
+TwoWire* TWIBus::getWire(void) {return wire;}
+
+/*! @brief Queues a job without waiting for it
+* @details The job's function, context, client, priority and deadline must be set.
+* The calling task becomes the job's owner and is notified when it completes.
+* @param job the job to queue, which must stay alive until wait() returns for it
+* @return true if the job was queued, otherwise its status is TWI_JOB_FAILED
+*/
+bool TWIBus::submit(TWIJob& job)
+{
+    job.owner = xTaskGetCurrentTaskHandle();
+    job.submittedAt = micros();
+    job.status = TWI_JOB_PENDING;
+
+    TWIJob* pointer = &job;
+    if (xQueueSend(queue[job.priority], &pointer, 0) != pdTRUE)
+    {
+        job.status = TWI_JOB_FAILED;
+        return false;
+    }
+    // Every queued job gives the bus task one notification
+    xTaskNotifyGive(task);
+    return true;
+}
+
+/*! @brief Blocks until a submitted job has completed
+* @details Jobs always complete, as those which cannot start before their deadline are
+* dropped. The caller waits on its task notification, of which the bus owns only the
+* TWI_NOTIFY_DONE bit: the bus task sets it when a job completes and this clears it.
+* Clients may notify the task with other bits (eSetBits), which are left set. They wake
+* the wait but do not end it, and the wake is used up, so a client waiting for its own
+* bit must check a flag of its own before blocking. Counting notifications
+* (xTaskNotifyGive) would overwrite the bits, so they must not be sent to a client task.
+* @param job a job submitted by the calling task
+* @return how the job completed
+*/
+TWIJobStatus TWIBus::wait(TWIJob& job)
+{
+    while (job.status == TWI_JOB_PENDING)
+    {
+        xTaskNotifyWait(0, TWI_NOTIFY_DONE, NULL, portMAX_DELAY);
+    }
+    return job.status;
+}
+
+/*! @brief Queues a job and waits for it to complete
+* @param client the task the job is run for
+* @param priority the queue to put the job in
+* @param address the device the job talks to, or TWI_ANY_DEVICE
+* @param bytes bytes the job puts on the bus, or 0 if unknown
+* @param function called by the bus task with exclusive use of the bus
+* @param context passed to function
+* @param startWithin ticks after which the job is dropped if it has not started,
+* or portMAX_DELAY to wait for as long as it takes
+* @return how the job completed
+*/
+TWIJobStatus TWIBus::run(TWIClient client, TWIPriority priority, uint8_t address, uint16_t bytes,
+                         TWIJobFunction function, void* context, TickType_t startWithin)
+{
+    TWIJob job;
+    job.function = function;
+    job.context = context;
+    job.client = client;
+    job.priority = priority;
+    job.address = address;
+    job.bytes = bytes;
+    job.deadline = startWithin == portMAX_DELAY ? portMAX_DELAY : xTaskGetTickCount() + startWithin;
+    if (!submit(job)) {return TWI_JOB_FAILED;}
+    return wait(job);
+}
+
+/*! @brief Copies the bus use statistics
+* @param copy receives the statistics of every client
+*/
+void TWIBus::getStats(TWIStats& copy) {published.get(copy);}
+
+/*! @brief Entry point of the bus task
+* @param p_params the TWIBus the task serves
+*/
+void TWIBus::taskFunction(void* p_params) {((TWIBus*)p_params)->serve();}
+
+/*! @brief Runs queued jobs forever, high priority ones first
+* @details A job is checked against its deadline just before it would start and
+* dropped if it is late, and otherwise run at the clock of its device. The time
+* each job waited and ran is added to its client, and its bytes to its device.
+*/
+void TWIBus::serve(void)
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+        TWIJob* job;
+        if (xQueueReceive(queue[TWI_PRIORITY_HIGH], &job, 0) != pdTRUE
+            && xQueueReceive(queue[TWI_PRIORITY_LOW], &job, 0) != pdTRUE) {continue;}
+
+        TWIClientStats& client = stats.client[job->client];
+        if (job->deadline != portMAX_DELAY && (int32_t)(xTaskGetTickCount() - job->deadline) > 0)
+        {
+            client.expired++;
+            published.put(stats);
+            complete(job, TWI_JOB_EXPIRED);
+            continue;
+        }
+
+        TWIDeviceStats* device = job->address == TWI_ANY_DEVICE ? NULL : findDevice(job->address);
+        uint32_t jobClock = device ? device->frequency : frequency;
+        if (jobClock != clock)
+        {
+            wire->setClock(jobClock);
+            clock = jobClock;
+            stats.clockChanges++;
+        }
+
+        uint32_t start = micros();
+        uint32_t waited = start - job->submittedAt;
+        bool success = job->function(job->context);
+        uint32_t busy = micros() - start;
+
+        if (device && success && job->bytes > 0)
+        {
+            device->jobs++;
+            device->bytes += job->bytes;
+            device->busyUs += busy;
+        }
+
+        client.jobs++;
+        if (!success) {client.failed++;}
+        client.busyUs += busy;
+        client.waitUs += waited;
+        if (waited > client.maxWaitUs) {client.maxWaitUs = waited;}
+        published.put(stats);
+        complete(job, success ? TWI_JOB_DONE : TWI_JOB_FAILED);
+    }
+}
+
+/*! @brief Hands a finished job back to its owner
+* @param job the job
+* @param status how the job completed
+*/
+void TWIBus::complete(TWIJob* job, TWIJobStatus status)
+{
+    // The owner may release the job as soon as its status changes
+    TaskHandle_t owner = job->owner;
+    job->status = status;
+    xTaskNotify(owner, TWI_NOTIFY_DONE, eSetBits);
+}
+
+/*! @brief Finds a device in the clock table
+* @param address TWI address of the device
+* @return its entry, or NULL if it has none
+*/
+TWIDeviceStats* TWIBus::findDevice(uint8_t address)
+{
+    for (uint8_t d=0;d<stats.devices;d++)
+    {
+        if (stats.device[d].address == address) {return &stats.device[d];}
+    }
+    return NULL;
+}
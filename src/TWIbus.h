@@ -0,0 +1,147 @@
+/*!
+ * @file TWIbus.h
+ * @author Setting-Dawn
+ * @brief Header file for a task which owns a TWI bus and runs queued transactions on it.
+ * @version 1.1.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __TWIBUS_H__
+#define __TWIBUS_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <esp_timer.h>
+#include "SeqShare.h"
+
+/// Jobs which may wait in each priority queue at the same time
+#define TWI_QUEUE_LENGTH 16
+/// Devices which may have their own clock on one bus
+#define TWI_MAX_DEVICES 8
+/// Address of jobs which talk to several devices, or none in the clock table; run at the bus clock
+#define TWI_ANY_DEVICE 0x00
+/// Bit of a client task's notification value the bus task sets when one of its jobs completes;
+/// the other bits are free for the client's own use, see TWIBus::wait()
+#define TWI_NOTIFY_DONE 0x01
+
+/// Tasks which use a TWI bus, for reporting its occupancy
+enum TWIClient : uint8_t {
+    TWI_CLIENT_EIT,   ///< The material reading task
+    TWI_CLIENT_IMU,   ///< The IMU sampling task
+    TWI_CLIENT_COUNT
+};
+
+/// Order in which queued jobs are run. High priority jobs always run before waiting low priority ones.
+enum TWIPriority : uint8_t {
+    TWI_PRIORITY_HIGH,
+    TWI_PRIORITY_LOW
+};
+
+/// Progress of a job
+enum TWIJobStatus : uint8_t {
+    TWI_JOB_PENDING,  ///< Queued or running
+    TWI_JOB_DONE,     ///< Ran and succeeded
+    TWI_JOB_FAILED,   ///< Ran and failed, or could not be queued
+    TWI_JOB_EXPIRED   ///< Its deadline passed before it could start, so it never ran
+};
+
+/// A transaction, or short sequence of transactions, run with exclusive use of the bus
+typedef bool (*TWIJobFunction)(void* context);
+
+/**
+ * @struct TWIJob
+ * @brief One unit of work for a TWI bus, owned by the submitting task until it completes.
+ * @details A job must stay alive until TWIBus::wait() has returned for it, as the bus
+ * task writes its status when it is done.
+ */
+struct TWIJob {
+    TWIJobFunction function; ///< Called by the bus task with exclusive use of the bus
+    void* context;           ///< Passed to function
+    TWIClient client;
+    TWIPriority priority;
+    uint8_t address;         ///< Device the job talks to, which selects the clock it runs at
+    uint16_t bytes;          ///< Bytes the job puts on the bus, or 0 to leave it out of the throughput
+    TickType_t deadline;     ///< Tick count by which the job must start, portMAX_DELAY if none
+    TaskHandle_t owner;      ///< Task notified on completion, set by TWIBus::submit()
+    uint32_t submittedAt;    ///< micros() when the job was queued
+    volatile TWIJobStatus status;
+};
+
+/**
+ * @struct TWIClientStats
+ * @brief Use of a bus by one client since the bus was started.
+ */
+struct TWIClientStats {
+    uint32_t jobs;       ///< Jobs run
+    uint32_t failed;     ///< Jobs which ran and failed
+    uint32_t expired;    ///< Jobs dropped because their deadline had passed
+    uint64_t busyUs;     ///< Time the bus spent running this client's jobs
+    uint64_t waitUs;     ///< Total time this client's jobs waited in the queues
+    uint32_t maxWaitUs;  ///< Longest time one of this client's jobs waited
+};
+
+/**
+ * @struct TWIDeviceStats
+ * @brief Clock and achieved throughput of one device in a bus's clock table.
+ */
+struct TWIDeviceStats {
+    uint8_t address;     ///< TWI address of the device
+    uint32_t frequency;  ///< Clock its jobs run at, in Hz
+    uint32_t jobs;       ///< Jobs run which reported their byte count
+    uint64_t bytes;      ///< Bytes put on the bus by those jobs
+    uint64_t busyUs;     ///< Time those jobs took, so bytes per second is bytes / busyUs
+};
+
+/**
+ * @struct TWIStats
+ * @brief Use of a bus by all of its clients and devices.
+ */
+struct TWIStats {
+    int64_t startedAt;   ///< esp_timer_get_time() when the bus task started, for computing occupancy
+    uint32_t clockChanges; ///< Times the bus clock was switched between jobs
+    uint8_t devices;     ///< Entries used in device
+    TWIClientStats client[TWI_CLIENT_COUNT];
+    TWIDeviceStats device[TWI_MAX_DEVICES];
+};
+
+/**
+ * @class TWIBus
+ * @brief Serializes every transaction on a TWI bus through a single owner task.
+ *
+ * @details Clients queue jobs instead of taking a mutex. The bus task always runs queued
+ * high priority jobs before low priority ones, so a task that breaks a long transfer into
+ * several jobs lets time-critical reads in between them. A job whose deadline has passed
+ * before it could start is dropped rather than delaying the client further. The submitting
+ * task is notified through its task notification when each of its jobs completes.
+ *
+ * Each device may be given its own clock in a table, so every part runs at the fastest
+ * speed it supports. The bus clock is only switched when consecutive jobs need different
+ * speeds, and jobs for devices not in the table run at the bus clock set by begin().
+ */
+class TWIBus {
+    private:
+        TwoWire* wire;
+        QueueHandle_t queue[2];  // Jobs waiting, one queue per priority
+        TaskHandle_t task;
+        uint32_t frequency;      // Clock of devices not in the table
+        uint32_t clock;          // Clock the bus is currently running at
+        TWIStats stats;          // Only changed by the bus task, which also owns the clock table in it
+        SeqShare<TWIStats> published;
+
+        static void taskFunction(void* p_params);
+        void serve(void);
+        void complete(TWIJob* job, TWIJobStatus status);
+        TWIDeviceStats* findDevice(uint8_t address);
+    public:
+        TWIBus(TwoWire* bus);
+        bool addDevice(uint8_t address, uint32_t deviceFrequency);
+        bool begin(const char* name, UBaseType_t priority, int sdaPin, int sclPin, uint32_t busFrequency);
+        TwoWire* getWire(void);
+        bool submit(TWIJob& job);
+        TWIJobStatus wait(TWIJob& job);
+        TWIJobStatus run(TWIClient client, TWIPriority priority, uint8_t address, uint16_t bytes,
+                         TWIJobFunction function, void* context, TickType_t startWithin = portMAX_DELAY);
+        void getStats(TWIStats& copy);
+};
+
+#endif //__TWIBUS_H__
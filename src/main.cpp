@@ -14,10 +14,8 @@
 #include <Adafruit_Sensor.h>
 #include <Adafruit_BNO055.h>
 #include <cmath>
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
 
-#include "ADC128D818.h"
-#include "PCA9956.h"
 #include "PrintStream.h"
 
 #include "IMU.h"
@@ -25,6 +23,12 @@
 #include "ENCODER.h"
 #include "EITwebhost.h"
 #include "CD74HC4067SM.h"
+#include "EITconfig.h"
+#include "EITsettle.h"
+#include "TWIbus.h"
+#include "Periodic.h"
+#include "MotorServo.h"
+#include "Pid.h"
 #include "shares.h"
 
 #undef DEBUG_MOTOR
@@ -39,20 +43,73 @@
 #define DEBUG_WEB
 #endif
 
-// Multiplexer control pins
+// Multiplexer control pins, the select pins are shared by every bank of 16 electrodes
 const uint8_t s0_PIN = 26;
 const uint8_t s1_PIN = 25;
 const uint8_t s2_PIN = 33;
 const uint8_t s3_PIN = 32;
-const uint8_t MultiEnable_PIN = 35;
-
-// ADC TWI Addresses
-const uint8_t ADC_1ADDRESS = 0x1D;
-const uint8_t ADC_2ADDRESS = 0x1F;
+const uint8_t MultiSelect_PINS[] = {s0_PIN, s1_PIN, s2_PIN, s3_PIN};
+// Multiplexer enable pins, one per bank of 16 electrodes. On this board ~Multi is routed to
+// GPI35, which has no output driver, so the multiplexer cannot be gated. Define
+// MUX_ENABLE_DRIVES_NE only once a board rework puts ~Multi on an output pin listed here.
+const uint8_t MultiEnable_PINS[] = {35, 23};
+#ifdef MUX_ENABLE_DRIVES_NE
+const uint8_t* const MultiGate_PINS = MultiEnable_PINS;
+#else
+const uint8_t MultiGate_PINS[] = {CD74HC4067SM_NO_ENABLE};
+#endif
 
-// PCA9956BTWY Address
+// Time allowed for the electrodes to settle after each excitation switch
+const uint32_t EIT_SETTLE_US = EIT_DEFAULT_SETTLE_US;
+// Read each ADC as soon as its own conversions are due, rather than all once the longest is
+const bool EIT_INTERLEAVED_READS = true;
+// Each excitation averages 2^n rounds of conversions, trading frame rate for a lower noise floor
+const uint8_t EIT_OVERSAMPLING_SHIFT = 0;
+// Calibrated conversion from ADC codes to volts
+const float EIT_VOLTS_PER_CODE = ADC128D818_INTERNAL_REF_V / 4096.0f;
+// Consecutive failed steps after which the EIT devices are initialized again, and the pause before it
+const uint8_t EIT_FAILED_STEP_LIMIT = 8;
+const uint32_t EIT_FAILURE_BACKOFF_MS = 50;
+
+// ADC TWI Addresses, one per 8 electrodes
+const uint8_t ADC_ADDRESSES[] = {0x1D, 0x1F, 0x2D, 0x2F};
+
+// PCA9956BTWY Addresses, one per bank of 16 electrodes
 const uint8_t PCA9956_ADDRESS = 0x01;
-PCA9956 CurrCtrl (&Wire);
+const uint8_t PCA9956_ADDRESSES[] = {PCA9956_ADDRESS, 0x02};
+
+// Bus topology. On this board the BNO055 connector J2 is wired to the EIT bus (SDA 21, SCL 22),
+// so the IMU and the EIT devices share one bus task. Define TWI_SPLIT_BUS only on a board reworked
+// to wire J2 to the IMU pins below, so the IMU runs on the second TWI controller; as built, GPIO4
+// is the DRV8833 nFAULT line and GPIO5 is not connected.
+const uint8_t EIT_SDA_PIN = 21;
+const uint8_t EIT_SCL_PIN = 22;
+const uint32_t EIT_TWI_HZ = 400000;
+const uint8_t IMU_SDA_PIN = 4;
+const uint8_t IMU_SCL_PIN = 5;
+const uint32_t IMU_TWI_HZ = 100000;
+
+// Clock of each device in the bus tasks' clock tables. The PCA9956 supports Fast-mode Plus;
+// the ADC128D818 is limited to Fast-mode, as its Hs-mode needs a master code the ESP32 cannot
+// send. The BNO055 is rated for Fast-mode but runs at 100 kHz: it stretches SCL while it
+// prepares a read, for longer than the ESP32 controller's clock stretch timeout at 400 kHz,
+// so its reads fail at that clock.
+const uint32_t ADC128D818_TWI_HZ = 400000;
+const uint32_t PCA9956_TWI_HZ = 1000000;
+const uint32_t BNO055_TWI_HZ = 100000;
+// Bytes on the bus for one burst read of the IMU: address, register, address and the data bytes
+const uint16_t BNO055_SAMPLE_BYTES = 3 + BNO055_BURST_BYTES;
+// Gyroscope axis (X, Y, Z) measuring the rate of change of roll and of pitch, and the sign relating them;
+// the BNO055 rolls about its Y axis and pitches about its X axis
+const uint8_t IMU_RATE_AXIS[] = {1, 0};
+const int8_t IMU_RATE_SIGN[] = {1, 1};
+
+static_assert(sizeof(ADC_ADDRESSES) >= EITActiveAcquire::adcCount, "Every ADC needs an address");
+static_assert(sizeof(PCA9956_ADDRESSES) >= EITActiveAcquire::bankCount, "Every current controller needs an address");
+static_assert(sizeof(MultiEnable_PINS) >= EITActiveAcquire::bankCount, "Every multiplexer needs an enable pin");
+#ifndef MUX_ENABLE_DRIVES_NE
+static_assert(EITActiveAcquire::bankCount == 1, "Banks are selected through nE, which must be driven");
+#endif
 
 // Pin definition for motors
 uint8_t nSleepPin = 02;
@@ -72,37 +129,153 @@ Share<bool> readVFLG ("Read V");
 // Shares to communicate target position between webpage and motor control tasks
 Share<float> xBar ("X Centroid");
 Share<float> yBar ("Y Centroid");
-// A share which holds the data to be published
-float publish[208] = {0};
-Share<bool> dataAvailable ("Publish Flag");
-// Mutex to thread protect the
-SemaphoreHandle_t twiMutex;
+// A share which holds the latest complete frame to be published
+SeqShare<EITActiveFrame> eitFrame ("EIT Frame");
+// The web server task, woken by the material reading task whenever a frame is complete
+TaskHandle_t webTaskHandle = NULL;
+// A share which holds the timing of the latest EIT frame
+Share<EITStats> eitStats ("EIT Stats");
+// A share which holds whether the settle times should be calibrated again
+Share<bool> calibrateFLG ("Calibrate");
+// Positions the motor servos are driven to, set by the motor control task
+SeqShare<MotorServoTargets> motorTargets ("Motor Targets");
+// The latest roll and pitch, set by the IMU sampling task
+SeqShare<IMUSample> imuSample ("IMU Sample");
+// How fresh the IMU samples used by the motor control task were
+SeqShare<IMUStats> imuStats ("IMU Stats");
+// The tasks owning the TWI buses, which run the transactions of every other task
+TWIBus eitBus (&Wire);
+#ifdef TWI_SPLIT_BUS
+static TWIBus imuController (&Wire1);
+TWIBus& imuBus = imuController;
+#else
+TWIBus& imuBus = eitBus;
+#endif
+
+// Times setup() tries to initialize the IMU before running without it
+const uint8_t IMU_INIT_ATTEMPTS = 3;
+// Time an IMU read may wait for the bus before it is dropped
+const TickType_t IMU_READ_DEADLINE = 4/portTICK_PERIOD_MS;
+// Period of the IMU sampling task, the rate the BNO055 fuses its Euler angles at in NDOF mode
+const uint32_t IMU_SAMPLE_PERIOD_US = 10000;
+// Width of each bin of the IMU sampling period jitter histogram served at /stats
+const uint32_t IMU_JITTER_BIN_US = 250;
+static_assert(IMU_SAMPLE_PERIOD_US % (1000*portTICK_PERIOD_MS) == 0, "The IMU period must be a whole number of ticks");
+// Age beyond which a control cycle counts its IMU sample as stale, two missed samples
+const uint32_t IMU_STALE_US = 3*IMU_SAMPLE_PERIOD_US;
+// Wakes the IMU sampling task at fixed intervals and times its cycles
+Periodic imuCycle (IMU_SAMPLE_PERIOD_US, IMU_JITTER_BIN_US);
+
+// Period of the motor control cycle, which the PID gains were tuned at
+const uint32_t CONTROL_PERIOD_US = 5000;
+// Width of each bin of the control period jitter histogram served at /stats
+const uint32_t CONTROL_JITTER_BIN_US = 250;
+static_assert(CONTROL_PERIOD_US % (1000*portTICK_PERIOD_MS) == 0, "The control period must be a whole number of ticks");
+// Wakes the motor control task at fixed intervals and times its cycles
+Periodic controlCycle (CONTROL_PERIOD_US, CONTROL_JITTER_BIN_US);
+
+// Drive the motors through encoder servos running far faster than the IMU can be read, with the
+// control task setting their positions; false drives the motors straight from the tilt PID instead
+const bool CONTROL_CASCADED = true;
+// Period of the motor servo cycle, and the width of each bin of its jitter histogram
+const uint32_t SERVO_PERIOD_US = 1000;
+const uint32_t SERVO_JITTER_BIN_US = 50;
+static_assert(SERVO_PERIOD_US % (1000*portTICK_PERIOD_MS) == 0, "The servo period must be a whole number of ticks");
+// Encoder counts a motor turns per degree of platform tilt through its linkage
+const float MOTOR_COUNTS_PER_DEGREE = 18.3f;
+// Direction each motor turns to raise the tilt of its axis, +1 if forwards
+const int8_t MOTOR_TILT_SIGN[] = {1, -1};
+// Gains of the motor servos: position to velocity in 1/s, velocity limit in counts/s,
+// velocity PI gains in duty per count/s and per count, and the velocity filter weight
+const MotorServoGains SERVO_GAINS = {60.0f, 6000.0f, 0.2f, 2.0f, 0.4f};
+// Wakes the motor servo task at fixed intervals and times its cycles
+Periodic servoCycle (SERVO_PERIOD_US, SERVO_JITTER_BIN_US);
+
+// Number type the tilt loops compute in; Q16 runs them in fixed point
+typedef float ControlValue;
+// Take the derivative terms from the IMU's gyroscope; false differentiates its Euler angles instead
+const bool CONTROL_GYRO_RATE = true;
+
+/// Gains of the single tilt loop, from tilt error in degrees to motor PWM duty
+struct TiltPidConfig {
+    static constexpr uint8_t axes = 2;
+    static constexpr float kp = 40.0f;
+    static constexpr float ki = 20.0f;              // 0.1 per 5 ms cycle
+    static constexpr float kd = 0.05f;              // 10 per 5 ms cycle
+    static constexpr float derivativeFilter = 0.5f; // Averages the 1/16 degree steps of the IMU
+    static constexpr float outputLimit = 255.0f;
+};
+
+/// Gains of the cascaded tilt loop, from tilt error to the tilt in degrees the servo positions ask for
+struct CascadePidConfig {
+    static constexpr uint8_t axes = 2;
+    static constexpr float kp = 0.25f;
+    static constexpr float ki = 30.0f;
+    static constexpr float kd = 0.0f;               // The servos' velocity loops damp the motors
+    static constexpr float derivativeFilter = 1.0f;
+    static constexpr float outputLimit = 15.0f;     // Largest tilt the servo positions may ask for
+};
+
+/*!
+* @brief Initializes the IMU while its bus task is idle, before any task queues jobs on it
+* @details Starting the BNO055 in NDOF mode takes hundreds of milliseconds, which as a bus job would
+* hold up every job queued behind it. The bus is left at the clock its task expects.
+* @param busFrequency the clock the IMU bus task was begun at
+* @return true if the IMU initialized
+*/
+static bool IMU_initIdleBus(uint32_t busFrequency)
+{
+    TwoWire* wire = imuBus.getWire();
+    wire->setClock(BNO055_TWI_HZ);
+    bool initialized = false;
+    for (uint8_t attempt=0;attempt<IMU_INIT_ATTEMPTS && !initialized;attempt++) {initialized = IMU_init(wire, 5);}
+    wire->setClock(busFrequency);
+    return initialized;
+}
+
+/*!
+* @brief Bus job reading roll, pitch, their rates and the calibration status from the IMU in one burst
+* @param context the IMUSample to fill in
+* @return true if the burst was read
+*/
+static bool IMU_anglesJob(void* context)
+{
+    IMUSample* angles = (IMUSample*)context;
+    angles->readAt = esp_timer_get_time();
+    IMUBurst burst;
+    if (!IMU_readBurst(burst)) {return false;}
+
+    const int16_t rates[] = {burst.gyro.x, burst.gyro.y, burst.gyro.z};
+    angles->x = burst.euler.y; // Roll
+    angles->y = burst.euler.z; // Pitch
+    angles->xRate = IMU_RATE_SIGN[0]*rates[IMU_RATE_AXIS[0]];
+    angles->yRate = IMU_RATE_SIGN[1]*rates[IMU_RATE_AXIS[1]];
+    angles->calibration = burst.calibration;
+    return true;
+}
 
 /*!
 * @brief Task to handle cycling through the pins to take EIT voltage readings
 * @details First waits for initialization of twi communication to complete.
 * Then each round has one channel with an applied current, one grounded, and 14 others.
-* ADCs read all adc channels, discards the two non-read channels, finds the deltaV between appropriate pins
-* and stores all values in the resulting array into a global array after lowering the dataAvailable flag.
+* The acquisition engine reads all adc channels, discards the two non-read channels and finds the
+* deltaV between appropriate pins, switching to the next energization state while the previous one
+* is processed. Each complete frame is published to the webpage task through a lock-free share.
 * @param p_params void*, unused.
 */
 void task_ReadMaterial(void* p_params) {
     Serial << "Starting Read Material Task" << endl;
-    ADC128D818 ADC_1 (ADC_1ADDRESS);
-    ADC128D818 ADC_2 (ADC_2ADDRESS);
-    CD74HC4067SM Multiplex (s0_PIN,s1_PIN,s2_PIN,s3_PIN,MultiEnable_PIN);
-    PCA9956 CurrCtrl (&Wire);
-
-    const uint8_t maxCurrent = 0xFF;
-
-    uint8_t currPinIndex;
-    double measure[208] = {0}; // Somewhere to store the data for 1 complete measurement
-    double cycleVals[16]; // Somewhere to store the data for 1 energization state
-    double skipCycleVals[14]; // Somewhere to store the important data begining at the correct index for 1 energization state
+    // The engine owns every ADC, multiplexer and current controller of the sheet
+    EITActiveAcquire Engine (&eitBus,ADC_ADDRESSES,PCA9956_ADDRESSES,MultiSelect_PINS,MultiGate_PINS);
+    Engine.setSettleTime(EIT_SETTLE_US);
+    Engine.setInterleavedReads(EIT_INTERLEAVED_READS);
+    Engine.setOversampling(EIT_OVERSAMPLING_SHIFT);
+    Engine.setScale(EIT_VOLTS_PER_CODE);
     Serial << "Finished initializing Read Material Task" << endl;
 
-    uint8_t cycleIndex = 0;
     uint8_t state = 0; // Initialization State
+    uint32_t reportedFailures = 0; // Failed steps already published in the statistics
+    uint8_t failedInRow = 0; // Consecutive steps which failed
 
     for (;;) {
         #ifdef DEBUG_READMATERIAL
@@ -112,177 +285,174 @@ void task_ReadMaterial(void* p_params) {
         // Priority for this isn't important, so it will just sit in this state until able to initialize.
         if (state == 0) // Start TWI communication
         {
-            if (xSemaphoreTake(twiMutex,5) == pdTRUE) // Takes the mutex and returns true if successful
+            if (Engine.begin()) // Runs on the bus task and returns true if successful
             {
-                ADC_1.setOperationMode(SINGLE_ENDED); //Mode 1 reads voltages on channels 0-7
-                ADC_1.begin(); // Initializes ADC1
-                ADC_2.setOperationMode(SINGLE_ENDED);//Mode 1 reads voltages on channels 0-7
-                ADC_2.begin(); // Initializes ADC2
-                CurrCtrl.init(PCA9956_ADDRESS,0xFF,false); // Initialize current control address and max brightnes
-                xSemaphoreGive(twiMutex); // Use of twi is complete, free mutex
-                state = 1; // Switch to reading the material
+                // Use the settle times calibrated for this protocol, or measure them if there are none
+                uint32_t settleUs[EITActiveAcquire::electrodes];
+                if (EITsettle_load(EITActiveAcquire::signature, settleUs, EITActiveAcquire::electrodes))
+                {
+                    Engine.setSettleTimes(settleUs);
+                    state = 1; // Switch to reading the material
+                }
+                else
+                {
+                    state = 2; // Switch to calibrating the settle times
+                }
+            }
+            else
+            {
+                vTaskDelay(50/portTICK_PERIOD_MS); // Delay 50ms before retrying
             }
         }
 
-        else if (state == 1) // Change Energization State
+        // Read one energization state
+        else if (state == 1)
         {
-            // cycleIndex initializes to n=0, which is also the grounded electrode.
-            currPinIndex = (cycleIndex + 1) % 16; // The electrode with current applied is always n+1
-            
-            // Attempt to send TWI instruction to change LED
-            if (xSemaphoreTake(twiMutex,5) == pdTRUE) // Takes the mutex and returns true if successful
+            if (calibrateFLG.get())
             {
-                CurrCtrl.offLED(cycleIndex); // Stop producing current for what will become the grounded pin
-                Multiplex.switchPin(cycleIndex); // Use multiplexer to ground the appropriate pin
-                CurrCtrl.onLED(currPinIndex); // Start producing current on the appropriate pin
-                xSemaphoreGive(twiMutex); // Use of twi is complete, free mutex
-                state = 2; // Only advances to start recording if communication was successful
+                calibrateFLG.put(false);
+                state = 2; // Calibrate again when asked to through the webpage
             }
-        }
-        
-        // After a short delay, try to take all the available measurements for 1 energization state
-        else if (state == 2) 
-        {
-            if (xSemaphoreTake(twiMutex,5) == pdTRUE) // Takes the mutex and returns true if successful
+            else
             {
-                // Record all ADC channels, electrodes 0-15 are recorded in order by ADC1 7-0 and then ADC2 7-0
-                for (uint8_t i=0;i<8;i++) {
-                    cycleVals[i] = ADC_1.readConverted(7-i);
-                    cycleVals[8+i] = ADC_2.readConverted(7-i);
-
-                    #ifdef DEBUG_READMATERIAL
-                    Serial << cycleVals[i] << endl;
-                    Serial << cycleVals[8+i] << endl;
-                    #endif
-
-                };
-                Serial << "Finished a full round, giving Mutex" << endl;
-                xSemaphoreGive(twiMutex); // Use of twi is complete, free mutex
-                Serial << "Finished a full round and Gave Mutex" << endl;
-                
-                // Grounded pin and current pin are not used in analysis so the 0th measurement
-                // should be grounded pin +2 or current pin + 1.
-                for (uint8_t i=0;i<14;i++) 
+                uint32_t failedBefore = Engine.getStats().failedSteps;
+                if (Engine.step())
                 {
-                    skipCycleVals[i] = cycleVals[(currPinIndex + 1 + i) % 16];
                     #ifdef DEBUG_READMATERIAL
-                    Serial << skipCycleVals[i] << endl;
+                    Serial << "Finished a full measurement in " << Engine.getStats().frameUs << " us" << endl;
+                    for (uint16_t n=0;n<EITActiveFrame::measurements;n++)
+                    {
+                        Serial << Engine.frame().values[n] << endl;
+                    }
                     #endif
-                };
-                Serial << "end skip" << endl;
-
-                // Finds all the deltaV values used and stores them in a local data storage array,
-                // ordered according to which of the 16 energization states is being recorded.
-                for (uint8_t i=0;i<13;i++) 
-                {
-                    measure[cycleIndex*13+i] = skipCycleVals[i+1] - skipCycleVals[i];
-                };
-
-                cycleIndex++; // Advances to the next energization state.
-                if (cycleIndex == 16)
+                    // Publishing never waits on the webpage task, which always reads a whole frame
+                    eitFrame.put(Engine.frame());
+                    eitStats.put(Engine.getStats());
+                    if (webTaskHandle != NULL) {xTaskNotifyGive(webTaskHandle);} // Stream the frame right away
+                    if (readVFLG.get() == false) {
+                        if (initializeVFLG.get() == false)
+                        {
+                            initializeVFLG.put(true);
+                        }
+                        else
+                        {
+                            readVFLG.put(true);
+                        }
+                    }
+                }
+                else if (Engine.getStats().failedSteps != reportedFailures)
                 {
-                    Serial << "Finished a full measurement" << endl;
-                    cycleIndex = 0; // Resets energization marker to ground pin n=0
-                    state = 3; // Change to publish value state
+                    // Failures are reported even while no frame can be completed
+                    reportedFailures = Engine.getStats().failedSteps;
+                    eitStats.put(Engine.getStats());
                 }
-                else
+
+                // A device which keeps failing, such as one unplugged or reset, is initialized again
+                // after a pause, so a bus which fails at once cannot starve the lower priority tasks
+                if (Engine.getStats().failedSteps == failedBefore) {failedInRow = 0;}
+                else if (++failedInRow >= EIT_FAILED_STEP_LIMIT)
                 {
-                    state = 1;
+                    failedInRow = 0;
+                    vTaskDelay(EIT_FAILURE_BACKOFF_MS/portTICK_PERIOD_MS);
+                    state = 0;
                 }
             }
         }
 
-        // Pushes all locally stored measurements to a global array accessable by the webpage task
-        else if (state == 3) 
+        // Measure the shortest settle time of each energization state and keep it in NVS
+        else if (state == 2)
         {
-            #ifdef DEBUG_READMATERIAL
-            Serial << "publishing values" << endl;
-            Serial << dataAvailable.get() << endl;
-            #endif
-            if (dataAvailable.get()) // Checks if the webpage task is currently attempting to read values
+            Serial << "Calibrating settle times" << endl;
+            if (Engine.calibrateSettling())
             {
-                dataAvailable.put(false); // Lower the flag to avoid corrupted data
-                #ifdef DEBUG_READMATERIAL
-                Serial << "Took dataMutex" << endl;
-                #endif
-                // Record every datapoint
-                for (uint8_t n=0;n<208;n++) 
+                for (uint8_t k=0;k<EITActiveAcquire::electrodes;k++)
                 {
-                    publish[n] = measure[n];
-                    #ifdef DEBUG_READMATERIAL
-                    Serial << measure[n] << endl;
-                    #endif
+                    Serial << "Excitation " << k << " settles in " << Engine.getSettleTime(k) << " us" << endl;
                 }
-                dataAvailable.put(true); // data is no longer being used, raise the allow flag
-                if (readVFLG.get() == false) {
-                    if (initializeVFLG.get() == false)
-                    {
-                        initializeVFLG.put(true);
-                    }
-                    else
-                    {
-                        readVFLG.put(true);
-                    }
+                if (!EITsettle_save(EITActiveAcquire::signature, Engine.getSettleTimes(), EITActiveAcquire::electrodes))
+                {
+                    Serial << "Could not store the settle times" << endl;
                 }
-                #ifdef DEBUG_READMATERIAL
-                Serial << "Gave dataMutex" << endl;
-                #endif
-                state = 1; // go back to energizing the newest state
+                state = 1; // Switch to reading the material
             }
-            else {
-                Serial << "Failed to take dataMutex" << endl;
+            else
+            {
+                state = 0; // The devices stopped responding, so initialize them again
             }
         }
-        vTaskDelay(50/portTICK_PERIOD_MS); // Delay 50ms
     }
 }
 
 /*!
 * @brief Task to handle controlling the table position using an IMU and two motors
 * @details Has PID control on both motors to attempt to reach the desired setpoint and measured by a BNO055A IMU.
+* Control cycles start at fixed intervals. The integral term uses the measured time between cycles, so a
+* late cycle does not change the effective gains. The derivative term uses the rates measured by the IMU's
+* gyroscope in the same burst as the angles, or with CONTROL_GYRO_RATE cleared, the change in the angles
+* over the time between the IMU reads. Both axes are computed in one step of a Pid,
+* whose gains are set in TiltPidConfig and CascadePidConfig.
+* When CONTROL_CASCADED is set, the tilt loop instead sets the positions the motor servo task drives the
+* motors to. Those positions integrate the tilt error, so the platform converges without the linkage being
+* known exactly, and the servos give the motors far more bandwidth than the IMU rate allows.
 * @param p_params void*, unused.
 */
 void task_controlMotors(void *parameter) {
-    float x_angle, y_angle, xTargetAngle, yTargetAngle, xAngleErr, yAngleErr, errSumX,errSumY, effX, effY;
-    float xAngleErrOld,yAngleErrOld;
-    int16_t encoderXTicks, encoderYTicks, errX, errY;
-    uint8_t pwm_X, pwm_Y;
-    const float KP = 40; // Proportional gain for speed control
-    const float KI = 0.1; // Integral gain for speed control
-    const float KD = 10; // Integral gain for speed control
+    typedef FixedValue<ControlValue> Value;
+    Pid<ControlValue, TiltPidConfig> tiltPid;
+    Pid<ControlValue, CascadePidConfig> cascadePid;
+    IMUSample sample;
+    uint32_t lastSequence = 0; // Samples published before the one in use
+    IMUStats use;
+    MotorServoTargets targets;
     
     uint8_t maxAngle = 10; // software limit for desired angle
-    xTargetAngle = 0.0; // Target angle is 0 degrees by default
-    yTargetAngle = 0.0; // Target angle is 0 degrees by default
     
     MOTOR_brake(motorXPin1, motorXPin2, 0, 1); // Initially stop both motors
     MOTOR_brake(motorYPin1, motorYPin2, 2, 3);
 
     uint8_t state = 0;
     for (;;) {
-        // Initial State waits for IMU to initialize
+        // Initial State waits for the IMU sampling task to publish its first angles
         if (state == 0) {
-            if (xSemaphoreTake(twiMutex,5) == pdTRUE) // Takes the mutex and returns true if successful
-            {
-                // Only advance states if IMU sucessfully initializes
-                if (!IMU_init(5)) {
-                    Serial.println("Failed to initialize IMU!");
-                }
-                else {
-                    Serial.println("IMU initialized.");
-                    state = 1;
-                }
-                xSemaphoreGive(twiMutex);
+            lastSequence = imuSample.get(sample);
+            if (lastSequence == 0) {
+                vTaskDelay(5/portTICK_PERIOD_MS); // Delay for 5 ms
+            }
+            else {
+                controlCycle.begin(); // Time the cycles from here, not from the initialization
+                memset(&use, 0, sizeof(use));
+                tiltPid.reset();
+                cascadePid.reset();
+                state = 1;
             }
         }
         // After Initialization, control the motor according to setpoint
         else if (state == 1) {
+            // Sleep until this cycle is due, then integrate over the time that actually passed
+            float cycleDt = controlCycle.wait();
+
             /* get the currentl angles of the platform*/
-            if (xSemaphoreTake(twiMutex,5) == pdTRUE) 
+            // The freshest sample never waits for the bus; if no new one was published since the last cycle,
+            // the last angles and their rate of change are kept, as the derivative is only taken over new angles
+            float readDt = 0.0f;
+            int64_t previousReadAt = sample.readAt;
+            uint32_t sequence = imuSample.get(sample);
+            if (sequence != lastSequence)
+            {
+                readDt = (sample.readAt - previousReadAt) * 1.0e-6f;
+                lastSequence = sequence;
+            }
+            else
             {
-                IMU_getAngles(x_angle, y_angle);
-                xSemaphoreGive(twiMutex);
+                use.reused++;
             }
+            use.samples = sequence;
+            use.dropped = sample.dropped;
+            use.calibration = sample.calibration;
+            use.ageUs = (uint32_t)(esp_timer_get_time() - sample.readAt);
+            if (use.ageUs > use.maxAgeUs) {use.maxAgeUs = use.ageUs;}
+            if (use.ageUs > IMU_STALE_US) {use.stale++;}
+            imuStats.put(use);
             // if (abs(x_angle) > 15.0f || abs(y_angle) > 15.0f) {
             //     // If tilt angle exceeds 15 degrees, stop motors for safety
             //     MOTOR_brake(motorXPin1, motorXPin2, 0, 1);
@@ -292,66 +462,134 @@ void task_controlMotors(void *parameter) {
             //     continue; // Skip the rest of the loop
             // }
 
-            // Adopts targets communicated by the webpage task
-            xTargetAngle = xBar.get()*maxAngle; // Centroid values communicated are from -1 to 1
-            yTargetAngle = yBar.get()*maxAngle;
-
-            // Determine error
-            xAngleErr = xTargetAngle - x_angle;
-            yAngleErr = yTargetAngle - y_angle;
+            // Adopts targets communicated by the webpage task; centroid values communicated are from -1 to 1
+            const ControlValue setpoint[] = {Value::from(xBar.get()*maxAngle), Value::from(yBar.get()*maxAngle)};
+            const float perCount = 1.0f / BNO055_LSB_PER_DEGREE;
+            const ControlValue measurement[] = {Value::from(sample.x*perCount), Value::from(sample.y*perCount)};
+            const ControlValue rate[] = {Value::from(sample.xRate*perCount), Value::from(sample.yRate*perCount)};
             
-            // Constrain Integral Error to produce at most max effort to eliminate run-away integral control
-            errSumX = constrain(errSumX + xAngleErr,-2550,2550);
-            errSumY = constrain(errSumY + yAngleErr,-2550,2550);
-            #ifdef DEBUG
-            Serial << endl;
-            Serial << xAngleErr << " " << yAngleErr << endl;
-            Serial << errSumX << " " << errSumY << endl;
-            #endif
-            // Calculate appropriate effort
-            effX = xAngleErr*KP + errSumX*KI + (xAngleErr-xAngleErrOld)*KD;
-            effY = yAngleErr*KP + errSumY*KI + (yAngleErr-yAngleErrOld)*KD;
-            
-            // Assign previous error for use in derivative control
-            xAngleErrOld = xAngleErr;
-            yAngleErrOld = yAngleErr;
+            if (CONTROL_CASCADED)
+            {
+                // The servo positions integrate the tilt error, so they converge without the linkage being known exactly
+                const ControlValue* tilt = CONTROL_GYRO_RATE ? cascadePid.update(setpoint, measurement, rate, Value::from(cycleDt))
+                                                             : cascadePid.update(setpoint, measurement, Value::from(cycleDt), Value::from(readDt));
+                targets.x = lroundf(MOTOR_TILT_SIGN[0]*MOTOR_COUNTS_PER_DEGREE*Value::toFloat(tilt[0]));
+                targets.y = lroundf(MOTOR_TILT_SIGN[1]*MOTOR_COUNTS_PER_DEGREE*Value::toFloat(tilt[1]));
+                motorTargets.put(targets);
+            }
+            else
+            {
+                // Calculate appropriate effort, limited to the largest duty
+                const ControlValue* effort = CONTROL_GYRO_RATE ? tiltPid.update(setpoint, measurement, rate, Value::from(cycleDt))
+                                                               : tiltPid.update(setpoint, measurement, Value::from(cycleDt), Value::from(readDt));
+                float effX = Value::toFloat(effort[0]);
+                float effY = Value::toFloat(effort[1]);
+                uint8_t pwm_X = (uint8_t)fabsf(effX);
+                uint8_t pwm_Y = (uint8_t)fabsf(effY);
+                #ifdef DEBUG
+                Serial << endl;
+                Serial << effX << " " << effY << endl;
+                #endif
 
-            // constrain effort to maximum allowed
-            pwm_X = constrain((abs(effX)), 0, 255);
-            pwm_Y = constrain((abs(effY)), 0, 255);
-            
-            #ifdef DEBUG
-            Serial.print(pwm_X);
-            Serial.print(" ");
-            Serial.println(pwm_Y);
-            #endif
-
-            /* control motor X*/
-            if (effX > 0) {
-                MOTOR_forward(motorXPin1, motorXPin2, 0, 1, pwm_X);
-            } else if (effX < 0) {
-                MOTOR_reverse(motorXPin1, motorXPin2, 0, 1, pwm_X);
-            } else {
-                MOTOR_brake(motorXPin1, motorXPin2, 0, 1); // Shouldn't get here
+                /* control motor X*/
+                if (effX > 0) {
+                    MOTOR_forward(motorXPin1, motorXPin2, 0, 1, pwm_X);
+                } else if (effX < 0) {
+                    MOTOR_reverse(motorXPin1, motorXPin2, 0, 1, pwm_X);
+                } else {
+                    MOTOR_brake(motorXPin1, motorXPin2, 0, 1); // Shouldn't get here
+                }
+                /* control motor Y*/
+                if (effY > 0) {
+                    MOTOR_reverse(motorYPin1, motorYPin2, 2, 3, pwm_Y);
+                } else if (effY < 0) {
+                    MOTOR_forward(motorYPin1, motorYPin2, 2, 3, pwm_Y);
+                } else {
+                    MOTOR_brake(motorYPin1, motorYPin2, 2, 3); // Shouldn't get here
+                }
             }
-            /* control motor Y*/
-            if (effY > 0) {
-                MOTOR_reverse(motorYPin1, motorYPin2, 2, 3, pwm_Y);
-            } else if (effY < 0) {
-                MOTOR_forward(motorYPin1, motorYPin2, 2, 3, pwm_Y);
-            } else {
-                MOTOR_brake(motorYPin1, motorYPin2, 2, 3); // Shouldn't get here
+        }
+    }
+}
+
+/*!
+* @brief Task to sample the IMU at its output rate for the motor control task
+* @details Reads the angles of the IMU, which setup() initialized, every IMU_SAMPLE_PERIOD_US through the IMU bus task
+* and publishes each one with the time it was read to a lock-free share, so the control task always finds
+* the freshest angles without waiting for the bus. Reads which fail or miss their deadline are counted
+* as dropped and leave the previous sample in place.
+* @param p_params void*, unused.
+*/
+void task_sampleIMU(void* p_params) {
+    IMUSample sample;
+    memset(&sample, 0, sizeof(sample));
+
+    uint8_t state = 0;
+    for (;;) {
+        // Initial State times the cycles from here
+        if (state == 0) {
+            imuCycle.begin();
+            state = 1;
+        }
+        // Read the angles once per period; reads ahead of any queued EIT transfers if the buses are shared
+        else if (state == 1) {
+            imuCycle.wait();
+            IMUSample read = sample;
+            if (imuBus.run(TWI_CLIENT_IMU, TWI_PRIORITY_HIGH, BNO055_ADDRESS_A, BNO055_SAMPLE_BYTES, IMU_anglesJob, &read, IMU_READ_DEADLINE) == TWI_JOB_DONE)
+            {
+                sample = read;
+                imuSample.put(sample);
+            }
+            else
+            {
+                sample.dropped++; // Published with the next sample
+            }
+        }
+    }
+}
+
+/*!
+* @brief Task to drive both motors to the positions set by the motor control task
+* @details Holds the motors still until the first positions are set, then runs a position and
+* velocity servo on each motor's encoder every SERVO_PERIOD_US. The encoders are counted by the
+* PCNT peripheral, so the servos never wait for a bus.
+* @param p_params void*, unused.
+*/
+void task_servoMotors(void* p_params) {
+    MotorServo servoX (&encoderX, motorXPin1, motorXPin2, 0, 1, SERVO_GAINS);
+    MotorServo servoY (&encoderY, motorYPin1, motorYPin2, 2, 3, SERVO_GAINS);
+
+    uint8_t state = 0;
+    for (;;) {
+        // Wait for the motor control task to set the first positions, which are relative to where the motors are now
+        if (state == 0) {
+            if (motorTargets.sequence() > 0) {
+                servoX.begin();
+                servoY.begin();
+                servoCycle.begin();
+                state = 1;
+            }
+            else {
+                vTaskDelay(5/portTICK_PERIOD_MS); // Delay for 5 ms
             }
         }
-        vTaskDelay(5/portTICK_PERIOD_MS); // Delay for 5 ms
+        // Drive both motors towards their latest positions
+        else if (state == 1) {
+            float dt = servoCycle.wait();
+            MotorServoTargets targets;
+            motorTargets.get(targets);
+            servoX.update(targets.x, dt);
+            servoY.update(targets.y, dt);
+        }
     }
 }
 
 /*!
 * @brief Task to handle the webpage for user interfacing.
-* @details publishes all 208 datapoints used for 1 measurement and some flags used by an external python program
+* @details publishes all datapoints used for 1 measurement and some flags used by an external python program
 * to know whether to initialize a base value or make appropriate calculations. Additionally, uses args on the webpage
 * to allow the user or external python program to set a desired table position.
+* Streaming clients are pushed every frame over a WebSocket as soon as the material reading task finishes it.
 * @param p_params void*, unused.
 */
 void task_webserver (void* p_params)
@@ -362,22 +600,31 @@ void task_webserver (void* p_params)
     // The server has been created statically when the program was started and
     // is accessed as a global object because not only this function but also
     // the page handling functions referenced below need access to the server
-    server.on ("/", handle_DocumentRoot);
-    server.on ("/data", handle_data);
-    server.on ("/set", handleSetValues);
-    server.on ("/flags", handleFlags);
+    server.on ("/", HTTP_GET, handle_DocumentRoot);
+    server.on ("/data", HTTP_GET, handle_data);
+    server.on ("/data.bin", HTTP_GET, handle_data_bin);
+    server.on ("/set", HTTP_GET, handleSetValues);
+    server.on ("/flags", HTTP_GET, handleFlags);
+    server.on ("/stats", HTTP_GET, handle_stats);
     server.onNotFound (handle_NotFound);
 
-    // Get the web server running
+    // Streaming clients are pushed frames and send setpoints over a WebSocket
+    webSocket.onEvent (handle_ws_event);
+    server.addHandler (&webSocket);
+
+    // Get the web server running; from here on requests are answered by the
+    // AsyncTCP task as they arrive, so this task only has to stream frames
     server.begin ();
     Serial.println ("HTTP server started");
 
     // Task only has a single state, but changes behavior based on web requests as show above.
     for (;;)
     {
-        // The web server must be periodically run to watch for page requests
-        server.handleClient ();
-        vTaskDelay (100/portTICK_PERIOD_MS); //delay 100 ms
+        // Sleep until the material reading task signals a new frame
+        ulTaskNotifyTake (pdTRUE, 1000/portTICK_PERIOD_MS);
+        stream_frame ();
+        // Drop streaming clients which have disconnected or stopped reading
+        webSocket.cleanupClients ();
     }
 }
 
@@ -386,7 +633,20 @@ void setup() {
     Serial.begin(115200);
     delay(1000);
 
-    twiMutex = xSemaphoreCreateMutex();
+    // Every device gets its own clock
+    for (uint8_t a=0;a<EITActiveAcquire::adcCount;a++) {eitBus.addDevice(ADC_ADDRESSES[a], ADC128D818_TWI_HZ);}
+    for (uint8_t b=0;b<EITActiveAcquire::bankCount;b++) {eitBus.addDevice(PCA9956_ADDRESSES[b], PCA9956_TWI_HZ);}
+    imuBus.addDevice(BNO055_ADDRESS_A, BNO055_TWI_HZ);
+
+    // The bus tasks run above every task using the buses
+    eitBus.begin("EIT Bus", 8, EIT_SDA_PIN, EIT_SCL_PIN, EIT_TWI_HZ);
+    #ifdef TWI_SPLIT_BUS
+    imuBus.begin("IMU Bus", 8, IMU_SDA_PIN, IMU_SCL_PIN, IMU_TWI_HZ);
+    bool imuInitialized = IMU_initIdleBus(IMU_TWI_HZ);
+    #else
+    bool imuInitialized = IMU_initIdleBus(EIT_TWI_HZ);
+    #endif
+    Serial.println(imuInitialized ? "IMU initialized." : "Failed to initialize IMU!");
 
     /* Initialize motors  */
     MOTOR_init(motorXPin1, motorXPin2, 0, 1);
@@ -402,9 +662,11 @@ void setup() {
     // Assign default share values
     initializeVFLG.put(false);
     readVFLG.put(false);
+    calibrateFLG.put(false);
     xBar.put(0.0);
     yBar.put(0.0);
-    dataAvailable.put(true);
+    eitStats.put(EITStats {});
+    imuStats.put(IMUStats {});
 
     // Call function which gets the WiFi working
     setup_wifi();
@@ -421,11 +683,18 @@ void setup() {
          NULL                 // Task handle
      );
     
-    // Task which produces the blinking LED
+    // The IMU sampling task runs above the motor control task, so a new sample is ready when a cycle starts;
+    // without the IMU the control task never gets its first angles and keeps the motors braked
+    if (imuInitialized) {xTaskCreate (task_sampleIMU, "Sample IMU", 4096, NULL, 2, NULL);}
+
+    // The motor servos run above every task but the EIT reading and bus tasks, to keep their period
+    if (CONTROL_CASCADED) {xTaskCreate (task_servoMotors, "Servo Motors", 4096, NULL, 6, NULL);}
+
+    // Task which measures the EIT frames, at the highest priority of the application tasks
     xTaskCreate (task_ReadMaterial, "EIT Read", 65536, NULL, 7, NULL);
 
     // Task which runs the web server.
-    xTaskCreate (task_webserver, "Web Server", 8192, NULL, 3, NULL);
+    xTaskCreate (task_webserver, "Web Server", 8192, NULL, 3, &webTaskHandle);
 }
 
 void loop() {
@@ -456,10 +725,10 @@ void setup() {
   Wire.beginTransmission(PCA9956_ADDRESS);
   uint8_t err = Wire.endTransmission();
   
-PCA9956 CurrCtrl (&Wire);
+PCA9956Bulk CurrCtrl (&Wire, PCA9956_ADDRESS);
 
 const uint8_t maxCurrent = 0xFF;
-CurrCtrl.init(PCA9956_ADDRESS,maxCurrent,false);
+CurrCtrl.begin(maxCurrent);
 
 if (err != 0) {
 Serial.print("No ACK at 0x01, error = ");
@@ -468,7 +737,8 @@ return;
 }
 
 Serial.println("ACK from 0x01, attempting to read MODE1...");
-CurrCtrl.onLED(0);
+const uint8_t firstLED[PCA9956_BANK_LEDOUT_BYTES] = {PCA9956_LED_ON}; // Channel 0 only
+CurrCtrl.writeLedOut(firstLED);
 
   // Step 2: read MODE1 (reg 0x00)
 }
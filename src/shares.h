@@ -13,6 +13,12 @@
 
 #include "taskqueue.h"
 #include "taskshare.h"
+#include "SeqShare.h"
+#include "EITconfig.h"
+#include "TWIbus.h"
+#include "Periodic.h"
+#include "MotorServo.h"
+#include "IMU.h"
 
 // A share which holds whether the external program needs to initialize V0
 extern Share<bool> initializeVFLG;
@@ -21,9 +27,26 @@ extern Share<bool> readVFLG;
 // Shares to communicate target position between webpage and motor control tasks
 extern Share<float> xBar;
 extern Share<float> yBar;
-// A rudimentary share to publish data from
-extern float publish[208];
-extern Share<bool> dataAvailable;
-// Mutexes to thread protect the twi process
-extern SemaphoreHandle_t twiMutex;
+// The latest complete EIT frame, written only by the material reading task
+extern SeqShare<EITActiveFrame> eitFrame;
+// The web server task, notified when a new frame is available
+extern TaskHandle_t webTaskHandle;
+// Timing of the latest EIT frame
+extern Share<EITStats> eitStats;
+// A share which holds whether the material reading task should calibrate its settle times again
+extern Share<bool> calibrateFLG;
+// The tasks owning the EIT and IMU TWI buses, through which every transaction is run;
+// both refer to the same bus unless TWI_SPLIT_BUS is defined
+extern TWIBus eitBus;
+extern TWIBus& imuBus;
+// Times the cycles of the motor control task and of the motor servo task inside it
+extern Periodic controlCycle;
+extern Periodic servoCycle;
+// Positions the motor servos are driven to, written only by the motor control task
+extern SeqShare<MotorServoTargets> motorTargets;
+// The latest roll and pitch, written only by the IMU sampling task, and the cycle timing of that task
+extern SeqShare<IMUSample> imuSample;
+extern Periodic imuCycle;
+// How fresh the IMU samples used by the motor control task were, written only by that task
+extern SeqShare<IMUStats> imuStats;
 #endif // _SHARES_H_
\ No newline at end of file
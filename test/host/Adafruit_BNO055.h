@@ -0,0 +1,90 @@
+/*!
+ * @file Adafruit_BNO055.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the Adafruit BNO055 driver, for the native test build.
+ * @details Talks to the sensor through the same registers as the Adafruit driver, so a
+ * simulated BNO055 on a host TwoWire answers it. Only what IMU.cpp uses is provided.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_ADAFRUIT_BNO055_H__
+#define __HOST_ADAFRUIT_BNO055_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "utility/imumaths.h"
+
+#define BNO055_ADDRESS_A (0x28)
+#define BNO055_ADDRESS_B (0x29)
+#define BNO055_ID (0xA0)
+
+typedef enum {
+    BNO055_CHIP_ID_ADDR = 0x00,
+    BNO055_EULER_H_LSB_ADDR = 0x1A,
+    BNO055_CALIB_STAT_ADDR = 0x35,
+    BNO055_OPR_MODE_ADDR = 0x3D,
+    BNO055_SYS_TRIGGER_ADDR = 0x3F
+} adafruit_bno055_reg_t;
+
+typedef enum {
+    OPERATION_MODE_CONFIG = 0x00,
+    OPERATION_MODE_NDOF = 0x0C
+} adafruit_bno055_opmode_t;
+
+/**
+ * @class Adafruit_BNO055
+ * @brief A BNO055 on a TWI bus.
+ */
+class Adafruit_BNO055 {
+    private:
+        uint8_t address;
+        TwoWire* wire;
+
+        bool write8(uint8_t reg, uint8_t value)
+        {
+            wire->beginTransmission(address);
+            wire->write(reg);
+            wire->write(value);
+            return wire->endTransmission() == 0;
+        }
+        bool readLen(uint8_t reg, uint8_t* buffer, uint8_t length)
+        {
+            wire->beginTransmission(address);
+            wire->write(reg);
+            if (wire->endTransmission(false) != 0) {return false;}
+            if (wire->requestFrom(address, length) != length) {return false;}
+            for (uint8_t i=0;i<length;i++) {buffer[i] = wire->read();}
+            return true;
+        }
+    public:
+        typedef enum {
+            VECTOR_EULER = BNO055_EULER_H_LSB_ADDR
+        } adafruit_vector_type_t;
+
+        Adafruit_BNO055(int32_t sensorID = -1, uint8_t sensorAddress = BNO055_ADDRESS_A, TwoWire* bus = &Wire)
+            : address(sensorAddress), wire(bus) {}
+
+        /// Checks the chip ID and enters the operating mode, without the boot delays of the driver
+        bool begin(adafruit_bno055_opmode_t mode = OPERATION_MODE_NDOF)
+        {
+            uint8_t id;
+            return readLen(BNO055_CHIP_ID_ADDR, &id, 1) && id == BNO055_ID && write8(BNO055_OPR_MODE_ADDR, mode);
+        }
+        void setExtCrystalUse(bool useCrystal) {write8(BNO055_SYS_TRIGGER_ADDR, useCrystal ? 0x80 : 0x00);}
+        bool isFullyCalibrated(void)
+        {
+            uint8_t calibration;
+            return readLen(BNO055_CALIB_STAT_ADDR, &calibration, 1) && calibration == 0xFF;
+        }
+        imu::Vector<3> getVector(adafruit_vector_type_t type)
+        {
+            imu::Vector<3> vector;
+            uint8_t buffer[6];
+            if (!readLen(type, buffer, 6)) {return vector;}
+            for (uint8_t n=0;n<3;n++) {vector[n] = (int16_t)(buffer[2*n] | buffer[2*n + 1] << 8) / 16.0;}
+            return vector;
+        }
+};
+
+#endif //__HOST_ADAFRUIT_BNO055_H__
@@ -0,0 +1,186 @@
+/*!
+ * @file Arduino.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the parts of the ESP32 Arduino core the sources use, for the native test build.
+ * @details Pin levels, pin modes and PWM duties are recorded so tests can check what was
+ * driven. String and dtostrf() follow the core, so text formatted on the host matches the
+ * ESP32's. Serial prints to the standard output.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_ARDUINO_H__
+#define __HOST_ARDUINO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "HostRuntime.h"
+#include "esp_timer.h"
+
+using std::abs;
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+/// GPIOs of the ESP32, and PWM channels of its LEDC peripheral
+#define HOST_PINS 40
+#define HOST_LEDC_CHANNELS 16
+
+/// Mode and level last set on every pin, and duty last written to every PWM channel
+inline uint8_t hostPinMode[HOST_PINS];
+inline uint8_t hostPinLevel[HOST_PINS];
+inline uint32_t hostLedcDuty[HOST_LEDC_CHANNELS];
+
+inline void pinMode(uint8_t pin, uint8_t mode) {hostPinMode[pin] = mode;}
+inline void digitalWrite(uint8_t pin, uint8_t level) {hostPinLevel[pin] = level;}
+inline int digitalRead(uint8_t pin) {return hostPinLevel[pin];}
+
+inline uint32_t ledcSetup(uint8_t channel, uint32_t frequency, uint8_t resolution) {return frequency;}
+inline void ledcAttachPin(uint8_t pin, uint8_t channel) {}
+inline void ledcWrite(uint8_t channel, uint32_t duty) {hostLedcDuty[channel] = duty;}
+
+inline unsigned long micros(void) {return (unsigned long)(uint32_t)HOST_timeUs();}
+inline unsigned long millis(void) {return (unsigned long)(uint32_t)(HOST_timeUs() / 1000);}
+inline void delay(uint32_t ms) {HOST_sleepUntilUs(HOST_timeUs() + (int64_t)ms * 1000);}
+inline void delayMicroseconds(uint32_t us) {HOST_spendUs(us);}
+
+/*! @brief Prints a number with a fixed number of decimals, as the ESP32 core does
+* @param number the value
+* @param width least number of characters, padded with spaces in front
+* @param prec number of decimals
+* @param s buffer receiving the text
+* @return s
+*/
+inline char* dtostrf(double number, signed char width, unsigned char prec, char* s)
+{
+    if (isnan(number)) {strcpy(s, "nan"); return s;}
+    if (isinf(number)) {strcpy(s, "inf"); return s;}
+
+    bool negative = false;
+    char* out = s;
+    int fillme = width;
+    if (prec > 0) {fillme -= prec + 1;}
+    if (number < 0.0) {negative = true; fillme--; number = -number;}
+
+    // Round so that printing 1.999 to 2 decimals gives 2.00
+    double rounding = 2.0;
+    for (uint8_t i=0;i<prec;i++) {rounding *= 10.0;}
+    number += 1.0 / rounding;
+
+    double tenpow = 1.0;
+    int digitcount = 1;
+    while (number >= 10.0 * tenpow) {tenpow *= 10.0; digitcount++;}
+    number /= tenpow;
+    fillme -= digitcount;
+
+    while (fillme-- > 0) {*out++ = ' ';}
+    if (negative) {*out++ = '-';}
+    digitcount += prec;
+    while (digitcount-- > 0)
+    {
+        int8_t digit = (int8_t)number;
+        if (digit > 9) {digit = 9;}
+        *out++ = (char)('0' | digit);
+        if (digitcount == prec && prec > 0) {*out++ = '.';}
+        number -= digit;
+        number *= 10.0;
+    }
+    *out = 0;
+    return s;
+}
+
+/**
+ * @class String
+ * @brief The Arduino String, on a heap allocated std::string as the core's is on its own buffer.
+ */
+class String {
+    private:
+        std::string text;
+    public:
+        String(void) {}
+        String(const char* value) : text(value ? value : "") {}
+        String(const std::string& value) : text(value) {}
+        explicit String(char value) : text(1, value) {}
+        String(int value) : text(std::to_string(value)) {}
+        String(unsigned int value) : text(std::to_string(value)) {}
+        String(long value) : text(std::to_string(value)) {}
+        String(unsigned long value) : text(std::to_string(value)) {}
+        String(long long value) : text(std::to_string(value)) {}
+        String(unsigned long long value) : text(std::to_string(value)) {}
+        String(float value, unsigned char decimals = 2) {char buf[33]; text = dtostrf(value, decimals + 2, decimals, buf);}
+        String(double value, unsigned char decimals = 2) {char buf[33]; text = dtostrf(value, decimals + 2, decimals, buf);}
+
+        String& operator+=(const String& other) {text += other.text; return *this;}
+        String& operator+=(const char* other) {text += other; return *this;}
+        String& operator+=(char other) {text += other; return *this;}
+        friend String operator+(const String& a, const String& b) {return String(a.text + b.text);}
+        friend String operator+(const char* a, const String& b) {return String(a + b.text);}
+        friend String operator+(const String& a, const char* b) {return String(a.text + b);}
+        bool operator==(const String& other) const {return text == other.text;}
+        bool operator==(const char* other) const {return text == other;}
+        bool operator!=(const char* other) const {return text != other;}
+        bool equals(const char* other) const {return text == other;}
+        /// Every String is true, as the core's is once its buffer exists
+        explicit operator bool(void) const {return true;}
+
+        const char* c_str(void) const {return text.c_str();}
+        unsigned int length(void) const {return text.length();}
+        bool reserve(unsigned int size) {text.reserve(size); return true;}
+        long toInt(void) const {return atol(text.c_str());}
+        float toFloat(void) const {return (float)atof(text.c_str());}
+};
+
+/**
+ * @class Print
+ * @brief Text output, writing every byte to the standard output.
+ */
+class Print {
+    public:
+        virtual size_t write(uint8_t c) {return fwrite(&c, 1, 1, stdout);}
+        virtual size_t write(const uint8_t* buffer, size_t size) {return fwrite(buffer, 1, size, stdout);}
+        size_t write(const char* text) {return write((const uint8_t*)text, strlen(text));}
+        size_t print(const char* text) {return write(text);}
+        size_t print(const String& text) {return write(text.c_str());}
+        size_t print(char c) {return write((uint8_t)c);}
+        size_t print(int value) {return print(String(value));}
+        size_t print(unsigned int value) {return print(String(value));}
+        size_t print(long value) {return print(String(value));}
+        size_t print(unsigned long value) {return print(String(value));}
+        size_t print(double value, int decimals = 2) {return print(String(value, decimals));}
+        size_t println(void) {return write("\r\n");}
+        template <typename T>
+        size_t println(const T& value) {return print(value) + println();}
+};
+
+/**
+ * @class HardwareSerial
+ * @brief The serial port, on the standard output.
+ */
+class HardwareSerial : public Print {
+    public:
+        void begin(unsigned long baud) {}
+        void flush(void) {fflush(stdout);}
+};
+
+inline HardwareSerial Serial;
+
+#endif //__HOST_ARDUINO_H__
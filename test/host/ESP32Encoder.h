@@ -0,0 +1,37 @@
+/*!
+ * @file ESP32Encoder.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the ESP32Encoder PCNT quadrature counter, for the native test build.
+ * @details The count is set by the test, as a simulated motor turning the encoder would.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_ESP32ENCODER_H__
+#define __HOST_ESP32ENCODER_H__
+
+#include <Arduino.h>
+
+enum class puType {
+    up,
+    down,
+    none
+};
+
+/**
+ * @class ESP32Encoder
+ * @brief A quadrature counter whose count the test moves.
+ */
+class ESP32Encoder {
+    public:
+        static inline puType useInternalWeakPullResistors = puType::down;
+        volatile int64_t count = 0;
+
+        void attachFullQuad(int aPinNumber, int bPinNumber) {}
+        void attachHalfQuad(int aPinNumber, int bPinNumber) {}
+        int64_t getCount(void) {return count;}
+        int64_t clearCount(void) {count = 0; return 0;}
+        void setCount(int64_t value) {count = value;}
+};
+
+#endif //__HOST_ESP32ENCODER_H__
@@ -0,0 +1,275 @@
+/*!
+ * @file ESPAsyncWebServer.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for ESPAsyncWebServer, for the native test build.
+ * @details There are no sockets: a test opens a request by its URL, which is parsed and
+ * passed to the handler of its route at once, as the AsyncTCP task does when a request
+ * has arrived. The response is then taken from the request a window at a time, as the
+ * connection would send it, so chunked responses are formatted as slowly as a client
+ * reads them and content sent from a buffer is only read when it is transmitted.
+ * Closing the request runs its disconnect handler.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_ESPASYNCWEBSERVER_H__
+#define __HOST_ESPASYNCWEBSERVER_H__
+
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+
+enum WebRequestMethod {HTTP_GET = 1, HTTP_POST = 2, HTTP_ANY = 255};
+
+typedef std::function<void(void)> ArDisconnectHandler;
+typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
+
+/**
+ * @class AsyncWebParameter
+ * @brief One name=value argument of a request's URL.
+ */
+class AsyncWebParameter {
+    private:
+        String paramName;
+        String paramValue;
+    public:
+        AsyncWebParameter(const String& name, const String& value) : paramName(name), paramValue(value) {}
+        const String& name(void) const {return paramName;}
+        const String& value(void) const {return paramValue;}
+};
+
+/**
+ * @class AsyncWebServerResponse
+ * @brief A response waiting to be sent, from a copy of its text, a buffer or a filler.
+ */
+class AsyncWebServerResponse {
+    public:
+        int code;
+        String contentType;
+        std::string text;                  ///< Content sent from a copy
+        const uint8_t* content = NULL;     ///< Content sent from the caller's buffer
+        size_t contentLength = 0;
+        AwsResponseFiller filler;          ///< Content formatted as it is sent
+        size_t sent = 0;
+
+        AsyncWebServerResponse(int status, const char* type) : code(status), contentType(type) {}
+        void addHeader(const char* name, const char* value) {}
+};
+
+/**
+ * @class AsyncWebServerRequest
+ * @brief A request, answered by its handler and then transmitted by the test.
+ */
+class AsyncWebServerRequest {
+    private:
+        std::vector<AsyncWebParameter> params;
+        std::unique_ptr<AsyncWebServerResponse> response;
+        ArDisconnectHandler disconnect;
+        bool closed = false;
+    public:
+        String path;
+
+        /*! @brief Parses a URL into its path and arguments
+        * @param url the path, then optionally ? and name=value arguments separated by &
+        */
+        AsyncWebServerRequest(const char* url)
+        {
+            std::string text(url);
+            size_t query = text.find('?');
+            path = String(text.substr(0, query));
+            while (query != std::string::npos)
+            {
+                size_t start = query + 1;
+                query = text.find('&', start);
+                std::string arg = text.substr(start, query == std::string::npos ? std::string::npos : query - start);
+                size_t equals = arg.find('=');
+                params.emplace_back(String(arg.substr(0, equals)),
+                                    String(equals == std::string::npos ? std::string() : arg.substr(equals + 1)));
+            }
+        }
+        ~AsyncWebServerRequest(void) {close();}
+
+        bool hasParam(const char* name) const {return getParam(name) != NULL;}
+        const AsyncWebParameter* getParam(const char* name) const
+        {
+            for (const AsyncWebParameter& p : params) {if (p.name() == name) {return &p;}}
+            return NULL;
+        }
+
+        void send(AsyncWebServerResponse* answer) {response.reset(answer);}
+        void send(int code, const char* contentType, const String& content)
+        {
+            send(new AsyncWebServerResponse(code, contentType));
+            response->text = content.c_str();
+        }
+        void send(int code, const char* contentType, const char* content) {send(code, contentType, String(content));}
+        void send(int code, const char* contentType, const uint8_t* content, size_t len)
+        {
+            send(new AsyncWebServerResponse(code, contentType));
+            response->content = content;
+            response->contentLength = len;
+        }
+        AsyncWebServerResponse* beginChunkedResponse(const char* contentType, AwsResponseFiller callback)
+        {
+            AsyncWebServerResponse* answer = new AsyncWebServerResponse(200, contentType);
+            answer->filler = callback;
+            return answer;
+        }
+        void onDisconnect(ArDisconnectHandler fn) {disconnect = fn;}
+
+        /// Status of the response, or 0 if the handler sent none
+        int code(void) const {return response ? response->code : 0;}
+
+        /*! @brief Sends the next part of the response, as the connection does when it has room
+        * @param buffer receives the part
+        * @param window most bytes the connection takes at once
+        * @return bytes sent, 0 once the whole response has been
+        */
+        size_t transmit(uint8_t* buffer, size_t window)
+        {
+            if (!response) {return 0;}
+            AsyncWebServerResponse& r = *response;
+            size_t len = 0;
+            if (r.filler) {len = r.filler(buffer, window, r.sent);}
+            else if (r.content) {len = min(window, r.contentLength - r.sent); memcpy(buffer, r.content + r.sent, len);}
+            else {len = min(window, r.text.size() - r.sent); memcpy(buffer, r.text.data() + r.sent, len);}
+            r.sent += len;
+            return len;
+        }
+
+        /*! @brief Sends the rest of the response
+        * @param window most bytes the connection takes at once
+        * @return the response's content
+        */
+        std::string receive(size_t window = 1460)
+        {
+            std::string content;
+            std::vector<uint8_t> buffer(window);
+            size_t len;
+            while ((len = transmit(buffer.data(), window)) > 0) {content.append((const char*)buffer.data(), len);}
+            return content;
+        }
+
+        /// Closes the connection, running the disconnect handler once
+        void close(void)
+        {
+            if (closed) {return;}
+            closed = true;
+            if (disconnect) {disconnect();}
+        }
+};
+
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+
+/**
+ * @class AsyncWebHandler
+ * @brief Something the server passes requests to besides its routes.
+ */
+class AsyncWebHandler {};
+
+/**
+ * @class AsyncWebSocketClient
+ * @brief One client connected to a WebSocket.
+ */
+class AsyncWebSocketClient {
+    private:
+        uint32_t clientId;
+    public:
+        AsyncWebSocketClient(uint32_t id) : clientId(id) {}
+        uint32_t id(void) const {return clientId;}
+};
+
+enum AwsEventType {WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA};
+enum AwsFrameType {WS_CONTINUATION = 0x00, WS_TEXT = 0x01, WS_BINARY = 0x02};
+
+/**
+ * @struct AwsFrameInfo
+ * @brief Where a received WebSocket message fragment lies in its message.
+ */
+struct AwsFrameInfo {
+    uint8_t message_opcode;
+    uint32_t num;
+    uint8_t final;
+    uint8_t masked;
+    uint8_t opcode;
+    uint64_t len;
+    uint8_t mask[4];
+    uint64_t index;
+};
+
+/**
+ * @class AsyncWebSocket
+ * @brief A WebSocket endpoint whose clients are the test, which keeps what is pushed to them.
+ */
+class AsyncWebSocket : public AsyncWebHandler {
+    public:
+        typedef std::function<void(AsyncWebSocket*, AsyncWebSocketClient*, AwsEventType, void*, uint8_t*, size_t)> AwsEventHandler;
+    private:
+        AwsEventHandler handler;
+        std::vector<AsyncWebSocketClient> clients;
+    public:
+        uint32_t messages = 0;            ///< Binary messages pushed to all clients
+        std::vector<uint8_t> lastMessage;
+
+        explicit AsyncWebSocket(const char* url) {}
+        void onEvent(AwsEventHandler fn) {handler = fn;}
+        size_t count(void) const {return clients.size();}
+        void binaryAll(const uint8_t* data, size_t len) {messages++; lastMessage.assign(data, data + len);}
+        void cleanupClients(uint16_t maxClients = 8) {}
+
+        /// Connects a client, returning its id
+        uint32_t connect(void)
+        {
+            clients.emplace_back(clients.size() + 1);
+            if (handler) {handler(this, &clients.back(), WS_EVT_CONNECT, NULL, NULL, 0);}
+            return clients.back().id();
+        }
+
+        /// Delivers a text message from a client in a single frame
+        void receive(uint32_t id, const char* text)
+        {
+            size_t len = strlen(text);
+            AwsFrameInfo info = {WS_TEXT, 0, 1, 1, WS_TEXT, len, {0, 0, 0, 0}, 0};
+            if (handler) {handler(this, &clients[id - 1], WS_EVT_DATA, &info, (uint8_t*)text, len);}
+        }
+};
+
+/**
+ * @class AsyncWebServer
+ * @brief Routes requests opened by the test to their handlers.
+ */
+class AsyncWebServer {
+    private:
+        struct Route {
+            std::string path;
+            WebRequestMethod method;
+            ArRequestHandlerFunction handler;
+        };
+        std::vector<Route> routes;
+        ArRequestHandlerFunction notFound;
+    public:
+        bool started = false;
+
+        explicit AsyncWebServer(uint16_t port) {}
+        void on(const char* uri, WebRequestMethod method, ArRequestHandlerFunction fn) {routes.push_back({uri, method, fn});}
+        void onNotFound(ArRequestHandlerFunction fn) {notFound = fn;}
+        void addHandler(AsyncWebHandler* handler) {}
+        void begin(void) {started = true;}
+
+        /*! @brief Opens a GET request and runs the handler of its route
+        * @param url the path and arguments requested
+        * @return the request, answered but not yet transmitted
+        */
+        std::unique_ptr<AsyncWebServerRequest> request(const char* url)
+        {
+            std::unique_ptr<AsyncWebServerRequest> r(new AsyncWebServerRequest(url));
+            for (const Route& route : routes)
+            {
+                if (route.path == r->path.c_str() && (route.method & HTTP_GET)) {route.handler(r.get()); return r;}
+            }
+            if (notFound) {notFound(r.get());}
+            return r;
+        }
+};
+
+#endif //__HOST_ESPASYNCWEBSERVER_H__
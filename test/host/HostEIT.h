@@ -0,0 +1,291 @@
+/*!
+ * @file HostEIT.h
+ * @author Setting-Dawn
+ * @brief Simulated EIT hardware for the native test build: ADC128D818s, PCA9956s and the sheet.
+ * @details The ADCs convert on demand like the real ones, staying busy for the conversion
+ * time of the channels they convert, and take each conversion from a level function
+ * standing in for the sheet, plus gaussian noise. The current sources record which channel
+ * they drive. Together with the multiplexer select pins in the simulated GPIO registers,
+ * the sheet knows which electrodes source and sink the current at every conversion.
+ * HostEITRig wires an acquisition engine of the sources to a set of them.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_EIT_H__
+#define __HOST_EIT_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <soc/gpio_struct.h>
+#include <functional>
+#include <random>
+#include "EITacquire.h"
+
+/// Clocks of the EIT bus and its devices, as set up by main.cpp
+#define HOST_EIT_TWI_HZ 400000
+#define HOST_ADC_TWI_HZ 400000
+#define HOST_PCA_TWI_HZ 1000000
+
+/// Addresses and pins of the EIT devices, as wired on the board
+inline const uint8_t HOST_ADC_ADDRESSES[] = {0x1D, 0x1F, 0x2D, 0x2F};
+inline const uint8_t HOST_PCA_ADDRESSES[] = {0x01, 0x02};
+inline const uint8_t HOST_SELECT_PINS[] = {26, 25, 33, 32};
+/// The board's multiplexer nE is on input-only GPI35 and is not driven, as main.cpp builds by default
+inline const uint8_t HOST_BOARD_ENABLE_PINS[] = {CD74HC4067SM_NO_ENABLE};
+/// Enable pins of a board reworked so they drive nE, as built with MUX_ENABLE_DRIVES_NE
+inline const uint8_t HOST_ENABLE_PINS[] = {13, 14};
+
+/**
+ * @class SimulatedADC128D818
+ * @brief An ADC128D818 in one-shot mode, mode 1, with its results from a level function.
+ */
+class SimulatedADC128D818 : public HostRegisterDevice {
+    private:
+        uint8_t result[16];        // Channel reading registers, 12 bit results left aligned, MSB first
+        int64_t busyUntil = 0;     // HOST_timeUs() the current round ends at
+        std::mt19937 random;
+        std::normal_distribution<float> gaussian {0.0f, 1.0f};
+    public:
+        /// Level of a channel in ADC codes before noise, given the channel
+        std::function<float(uint8_t channel)> level;
+        float noise = 0;           ///< Standard deviation of the noise added to every conversion, in codes
+        uint32_t conversionUs = 1525; ///< Time each enabled channel takes to convert
+        uint32_t rounds = 0;       ///< Rounds of conversions started
+        uint32_t conversions = 0;  ///< Channel conversions made
+        uint32_t busyReads = 0;    ///< Busy status reads which found a round running
+        uint32_t earlyReads = 0;   ///< Result reads while a round was running
+
+        SimulatedADC128D818(uint32_t seed = 1) : random(seed) {memset(result, 0, sizeof(result));}
+
+        /// Restarts the noise from a seed, so ADCs of one rig have independent noise
+        void seed(uint32_t value) {random.seed(value);}
+
+        /// Whether a round of conversions is running
+        bool busy(void) {return HOST_timeUs() < busyUntil;}
+
+        uint8_t readRegister(uint8_t reg) override
+        {
+            if (reg == 0x0C) // Busy status: converting, never not ready
+            {
+                if (busy()) {busyReads++; return 0x01;}
+                return 0x00;
+            }
+            return registers[reg];
+        }
+
+        void writeRegister(uint8_t reg, uint8_t value) override
+        {
+            registers[reg] = value;
+            if (reg != 0x09 || !(value & 0x01)) {return;}
+
+            // One-shot: convert every enabled channel, results are there once the round ends
+            uint8_t converted = 0;
+            for (uint8_t c=0;c<8;c++)
+            {
+                if (registers[0x08] & (1 << c)) {continue;}
+                float code = (level ? level(c) : 0.0f) + (noise > 0 ? noise * gaussian(random) : 0.0f);
+                uint16_t clamped = (uint16_t)constrain(lroundf(code), 0L, 4095L);
+                result[2*c] = clamped >> 4;
+                result[2*c + 1] = (clamped << 4) & 0xF0;
+                converted++;
+            }
+            rounds++;
+            conversions += converted;
+            busyUntil = HOST_timeUs() + (int64_t)converted * conversionUs;
+        }
+
+        bool request(uint8_t* data, size_t length) override
+        {
+            if (pointer < 0x20 || pointer > 0x27) {return HostRegisterDevice::request(data, length);}
+            if (failures > 0) {failures--; return false;}
+            if (busy()) {earlyReads++;}
+            // The 16 bit channel registers are read MSB first, moving on to the next channel
+            size_t offset = (pointer - 0x20) * 2;
+            for (size_t i=0;i<length;i++) {data[i] = result[(offset + i) % sizeof(result)];}
+            return true;
+        }
+};
+
+/**
+ * @class SimulatedPCA9956
+ * @brief A PCA9956B whose register pointer only auto-increments when asked to.
+ */
+class SimulatedPCA9956 : public HostRegisterDevice {
+    private:
+        bool increment = false;
+    public:
+        uint32_t ledoutWrites = 0; ///< Writes which changed any LEDOUT register
+        int64_t ledoutAt = 0;      ///< HOST_timeUs() of the latest of them
+
+        bool receive(const uint8_t* data, size_t length) override
+        {
+            if (failures > 0) {failures--; return false;}
+            if (length == 0) {return true;}
+            increment = data[0] & 0x80;
+            pointer = data[0] & 0x7F;
+            bool ledout = false;
+            for (size_t i=1;i<length;i++)
+            {
+                if (pointer >= 0x02 && pointer <= 0x07) {ledout = true;}
+                writeRegister(pointer, data[i]);
+                if (increment) {pointer++;}
+            }
+            if (ledout) {ledoutWrites++; ledoutAt = HOST_timeUs();}
+            return true;
+        }
+
+        uint8_t nextRegister(uint8_t reg) override {return increment ? reg + 1 : reg;}
+
+        /*! @brief Finds the channel among 0-15 driven on
+        * @return the channel, -1 if none is and -2 if several are
+        */
+        int source(void)
+        {
+            int on = -1;
+            for (uint8_t c=0;c<16;c++)
+            {
+                if (((registers[0x02 + c / 4] >> (2 * (c % 4))) & 0x03) == 0) {continue;}
+                if (on != -1) {return -2;}
+                on = c;
+            }
+            return on;
+        }
+};
+
+/*! @brief Gets the level a pin is driven to through the GPIO registers
+* @param pin the GPIO
+* @return true if high
+*/
+inline bool HOST_gpioLevel(uint8_t pin) {return (hostGpioOut[pin / 32] >> (pin % 32)) & 1;}
+
+/*! @brief Gets the channel selected by the four select pins of a CD74HC4067
+* @param selectPins s0-s3
+* @return the channel, 0-15
+*/
+inline uint8_t HOST_muxChannel(const uint8_t* selectPins)
+{
+    uint8_t channel = 0;
+    for (uint8_t k=0;k<4;k++) {channel |= HOST_gpioLevel(selectPins[k]) << k;}
+    return channel;
+}
+
+/**
+ * @class HostEITRig
+ * @brief An acquisition engine, its bus task and the simulated devices it drives.
+ * @details The bus task never ends, so a rig must live for the rest of the program;
+ * tests make them static. Rigs on the same TwoWire may be used one after the other,
+ * as begin() attaches the rig's devices to the bus.
+ * @tparam PROTOCOL the EITProtocol the engine runs
+ */
+template <typename PROTOCOL>
+class HostEITRig {
+    public:
+        using Engine = EITAcquire<PROTOCOL>;
+        static constexpr uint8_t electrodes = Engine::electrodes;
+
+        SimulatedADC128D818 adc[Engine::adcCount];
+        SimulatedPCA9956 pca[Engine::bankCount];
+        TwoWire* wire;
+        const uint8_t* enablePins;
+        TWIBus bus;
+        Engine engine;
+
+        /*! @brief Creates the engine and its simulated devices
+        * @param p_wire the bus the devices are attached to
+        * @param p_enablePins the multiplexer enable pins; by default the board's undriven nE
+        *        for one bank and the reworked pins for more, as main.cpp requires
+        */
+        HostEITRig(TwoWire* p_wire = &Wire,
+            const uint8_t* p_enablePins = Engine::bankCount > 1 ? HOST_ENABLE_PINS : HOST_BOARD_ENABLE_PINS)
+            : wire(p_wire), enablePins(p_enablePins), bus(p_wire),
+              engine(&bus, HOST_ADC_ADDRESSES, HOST_PCA_ADDRESSES, HOST_SELECT_PINS, p_enablePins)
+        {
+            for (uint8_t a=0;a<Engine::adcCount;a++)
+            {
+                adc[a].seed(a + 1);
+                bus.addDevice(HOST_ADC_ADDRESSES[a], HOST_ADC_TWI_HZ);
+            }
+            for (uint8_t b=0;b<Engine::bankCount;b++) {bus.addDevice(HOST_PCA_ADDRESSES[b], HOST_PCA_TWI_HZ);}
+        }
+
+        /*! @brief Attaches the devices, starts the bus task and begins the engine
+        * @details Must be called from the thread which steps the engine.
+        * @return true if the engine began
+        */
+        bool begin(void)
+        {
+            for (uint8_t a=0;a<Engine::adcCount;a++) {wire->attach(HOST_ADC_ADDRESSES[a], &adc[a]);}
+            for (uint8_t b=0;b<Engine::bankCount;b++) {wire->attach(HOST_PCA_ADDRESSES[b], &pca[b]);}
+            return bus.begin("EIT Bus", 8, 21, 22, HOST_EIT_TWI_HZ) && engine.begin();
+        }
+
+        /*! @brief Steps the engine until it has completed a number of frames
+        * @param count frames to complete
+        */
+        void frames(uint32_t count)
+        {
+            for (uint32_t n=0;n<count;)
+            {
+                if (engine.step()) {n++;}
+            }
+        }
+
+        /*! @brief Sets the level of every electrode, in ADC codes before noise
+        * @param level gives the level of an electrode, which may depend on sink() and source()
+        */
+        void setLevels(std::function<float(uint8_t electrode)> level)
+        {
+            // Each ADC records its 8 electrodes in order on channels 7-0
+            for (uint8_t a=0;a<Engine::adcCount;a++)
+            {
+                adc[a].level = [level, a] (uint8_t channel) {return level(a * 8 + 7 - channel);};
+            }
+        }
+
+        /*! @brief Sets the noise of every ADC
+        * @param codes standard deviation of the noise, in ADC codes
+        */
+        void setNoise(float codes)
+        {
+            for (uint8_t a=0;a<Engine::adcCount;a++) {adc[a].noise = codes;}
+        }
+
+        /*! @brief Finds the electrode grounded through an enabled multiplexer
+        * @details A multiplexer whose nE is not driven is always enabled.
+        * @return the electrode, or -1 if no multiplexer is enabled
+        */
+        int sink(void)
+        {
+            for (uint8_t b=0;b<Engine::bankCount;b++)
+            {
+                if (enablePins[b] == CD74HC4067SM_NO_ENABLE || !HOST_gpioLevel(enablePins[b]))
+                {
+                    return b * 16 + HOST_muxChannel(HOST_SELECT_PINS);
+                }
+            }
+            return -1;
+        }
+
+        /*! @brief Finds the electrode the current is sourced into
+        * @return the electrode, -1 if none and -2 if several
+        */
+        int source(void)
+        {
+            int found = -1;
+            for (uint8_t b=0;b<Engine::bankCount;b++)
+            {
+                int channel = pca[b].source();
+                if (channel == -2 || (channel >= 0 && found != -1)) {return -2;}
+                if (channel >= 0) {found = b * 16 + channel;}
+            }
+            return found;
+        }
+
+        /// Rounds, conversions and early reads of all ADCs together
+        uint32_t rounds(void) {uint32_t n = 0; for (auto& a : adc) {n += a.rounds;} return n;}
+        uint32_t conversions(void) {uint32_t n = 0; for (auto& a : adc) {n += a.conversions;} return n;}
+        uint32_t earlyReads(void) {uint32_t n = 0; for (auto& a : adc) {n += a.earlyReads;} return n;}
+};
+
+#endif //__HOST_EIT_H__
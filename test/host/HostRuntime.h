@@ -0,0 +1,253 @@
+/*!
+ * @file HostRuntime.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the clock and the FreeRTOS tasks, notifications and queues the sources use.
+ * @details Part of the native test build, which compiles the sources against the headers in
+ * test/host instead of the ESP32 Arduino core. Tasks are threads and the scheduler tick is
+ * one millisecond. Time is either the host's monotonic clock, so threaded tests run in real
+ * time, or a simulated clock which only moves when a test spends time or a task sleeps,
+ * for single threaded tests of timing logic. Everything the threads share is allocated
+ * once and never freed, so tasks still running when a test exits touch nothing destroyed.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOSTRUNTIME_H__
+#define __HOSTRUNTIME_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms) / portTICK_PERIOD_MS)
+
+/// Whether time is simulated, and the simulated time in microseconds
+inline std::atomic<bool> hostSimulated {false};
+inline std::atomic<int64_t> hostSimulatedUs {0};
+/// Start of the host's clock, so real time starts near zero like the ESP32's
+inline const std::chrono::steady_clock::time_point hostEpoch = std::chrono::steady_clock::now();
+/// Extra time a sleeping task takes to wake on the simulated clock, standing in for scheduling latency
+inline std::function<uint32_t(void)>* hostWakeLatency = new std::function<uint32_t(void)>();
+
+/*! @brief Selects the simulated or the real clock
+* @details The simulated clock restarts at 0 and has no wake latency until one is set.
+* @param simulated true to simulate time, false to follow the host's clock
+*/
+inline void HOST_useSimulatedClock(bool simulated)
+{
+    hostSimulatedUs = 0;
+    *hostWakeLatency = nullptr;
+    hostSimulated = simulated;
+}
+
+/*! @brief Sets the latency of every wakeup from a sleep on the simulated clock
+* @param latency returns the microseconds each wakeup is late by, or nullptr for none
+*/
+inline void HOST_setWakeLatency(std::function<uint32_t(void)> latency) {*hostWakeLatency = latency;}
+
+/*! @brief Gets the current time
+* @return microseconds since the clock started
+*/
+inline int64_t HOST_timeUs(void)
+{
+    if (hostSimulated) {return hostSimulatedUs;}
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostEpoch).count();
+}
+
+/*! @brief Spends time working, as a transfer or a computation would
+* @details Moves the simulated clock on, or busy waits on the real one.
+* @param us microseconds to spend
+*/
+inline void HOST_spendUs(int64_t us)
+{
+    if (hostSimulated) {hostSimulatedUs += us; return;}
+    int64_t until = HOST_timeUs() + us;
+    while (HOST_timeUs() < until) {}
+}
+
+/*! @brief Sleeps until a time
+* @details The simulated clock jumps to the time, plus any wake latency.
+* @param due microseconds since the clock started to wake at
+*/
+inline void HOST_sleepUntilUs(int64_t due)
+{
+    if (hostSimulated)
+    {
+        if (due > hostSimulatedUs) {hostSimulatedUs = due;}
+        if (*hostWakeLatency) {hostSimulatedUs += (*hostWakeLatency)();}
+        return;
+    }
+    std::this_thread::sleep_until(hostEpoch + std::chrono::microseconds(due));
+}
+
+/**
+ * @struct HostTask
+ * @brief A task: its thread and its notification.
+ */
+struct HostTask {
+    std::mutex lock;
+    std::condition_variable changed;
+    uint32_t value;  // Notification value
+    bool notified;   // A notification is pending
+};
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+/// The task of the calling thread, made on first use for threads not started by xTaskCreate()
+inline thread_local HostTask* hostCurrentTask = NULL;
+
+/*! @brief Waits on a task's notification for a number of ticks
+* @param task the task
+* @param guard the task's lock, held
+* @param ticks ticks to wait, portMAX_DELAY for ever
+* @param ready returns true once the wait is over
+* @return the result of ready
+*/
+template <typename READY>
+inline bool HOST_waitTicks(HostTask* task, std::unique_lock<std::mutex>& guard, TickType_t ticks, READY ready)
+{
+    if (ticks == portMAX_DELAY) {task->changed.wait(guard, ready); return true;}
+    return task->changed.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    if (hostCurrentTask == NULL) {hostCurrentTask = new HostTask {{}, {}, 0, false};}
+    return hostCurrentTask;
+}
+
+inline BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                              void* parameters, UBaseType_t priority, TaskHandle_t* created)
+{
+    HostTask* task = new HostTask {{}, {}, 0, false};
+    if (created != NULL) {*created = task;}
+    std::thread([task, function, parameters] () {hostCurrentTask = task; function(parameters);}).detach();
+    return pdPASS;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                          void* parameters, UBaseType_t priority, TaskHandle_t* created, BaseType_t core)
+{
+    return xTaskCreate(function, name, stackDepth, parameters, priority, created);
+}
+
+inline TickType_t xTaskGetTickCount(void) {return (TickType_t)(HOST_timeUs() / (1000 * portTICK_PERIOD_MS));}
+
+inline void vTaskDelay(TickType_t ticks) {HOST_sleepUntilUs(HOST_timeUs() + (int64_t)ticks * 1000 * portTICK_PERIOD_MS);}
+
+inline void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment)
+{
+    *previousWake += increment;
+    int64_t due = (int64_t)*previousWake * 1000 * portTICK_PERIOD_MS;
+    if (due > HOST_timeUs()) {HOST_sleepUntilUs(due);}
+}
+
+typedef enum {eNoAction, eSetBits, eIncrement, eSetValueWithOverwrite, eSetValueWithoutOverwrite} eNotifyAction;
+
+inline BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    std::lock_guard<std::mutex> guard(task->lock);
+    if (action == eSetBits) {task->value |= value;}
+    else if (action == eIncrement) {task->value++;}
+    else if (action != eNoAction) {task->value = value;}
+    task->notified = true;
+    task->changed.notify_all();
+    return pdPASS;
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {return xTaskNotify(task, 0, eIncrement);}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks)
+{
+    HostTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(task->lock);
+    HOST_waitTicks(task, guard, ticks, [task] () {return task->value != 0;});
+    uint32_t value = task->value;
+    if (value != 0) {task->value = clearOnExit ? 0 : value - 1;}
+    task->notified = false;
+    return value;
+}
+
+inline BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t ticks)
+{
+    HostTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(task->lock);
+    if (!task->notified) {task->value &= ~clearOnEntry;}
+    if (!HOST_waitTicks(task, guard, ticks, [task] () {return task->notified;})) {return pdFALSE;}
+    if (value != NULL) {*value = task->value;}
+    task->value &= ~clearOnExit;
+    task->notified = false;
+    return pdTRUE;
+}
+
+/**
+ * @struct HostQueue
+ * @brief A queue of fixed size items.
+ */
+struct HostQueue {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    HostQueue* queue = new HostQueue;
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> guard(queue->lock);
+    auto space = [queue] () {return queue->items.size() < queue->length;};
+    bool ready = ticks == portMAX_DELAY ? (queue->changed.wait(guard, space), true)
+        : queue->changed.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), space);
+    if (!ready) {return pdFALSE;}
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> guard(queue->lock);
+    auto waiting = [queue] () {return !queue->items.empty();};
+    bool ready = ticks == portMAX_DELAY ? (queue->changed.wait(guard, waiting), true)
+        : queue->changed.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), waiting);
+    if (!ready) {return pdFALSE;}
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->items.size();
+}
+
+#endif //__HOSTRUNTIME_H__
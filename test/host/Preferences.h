@@ -0,0 +1,82 @@
+/*!
+ * @file Preferences.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the ESP32 NVS key-value store, for the native test build.
+ * @details Namespaces live in memory for the life of the program, so what one test stores
+ * another can load, as across reboots of the ESP32.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_PREFERENCES_H__
+#define __HOST_PREFERENCES_H__
+
+#include <Arduino.h>
+#include <map>
+
+/// Every key of every namespace, named "namespace/key"
+inline std::map<std::string, std::vector<uint8_t>>* hostPreferences = new std::map<std::string, std::vector<uint8_t>>;
+
+/**
+ * @class Preferences
+ * @brief One open namespace of the store.
+ */
+class Preferences {
+    private:
+        std::string space;
+        bool open = false;
+        bool readOnly = true;
+
+        std::vector<uint8_t>* find(const char* key)
+        {
+            auto entry = hostPreferences->find(space + "/" + key);
+            return open && entry != hostPreferences->end() ? &entry->second : NULL;
+        }
+    public:
+        bool begin(const char* name, bool readOnlyMode = false)
+        {
+            space = name;
+            open = true;
+            readOnly = readOnlyMode;
+            return true;
+        }
+        void end(void) {open = false;}
+
+        size_t putBytes(const char* key, const void* value, size_t length)
+        {
+            if (!open || readOnly) {return 0;}
+            const uint8_t* bytes = (const uint8_t*)value;
+            (*hostPreferences)[space + "/" + key].assign(bytes, bytes + length);
+            return length;
+        }
+        size_t getBytesLength(const char* key)
+        {
+            std::vector<uint8_t>* value = find(key);
+            return value ? value->size() : 0;
+        }
+        size_t getBytes(const char* key, void* buffer, size_t length)
+        {
+            std::vector<uint8_t>* value = find(key);
+            if (value == NULL || value->size() > length) {return 0;}
+            memcpy(buffer, value->data(), value->size());
+            return value->size();
+        }
+        size_t putULong(const char* key, uint32_t value) {return putBytes(key, &value, sizeof(value));}
+        uint32_t getULong(const char* key, uint32_t defaultValue = 0)
+        {
+            uint32_t value;
+            return getBytesLength(key) == sizeof(value) && getBytes(key, &value, sizeof(value)) ? value : defaultValue;
+        }
+        bool clear(void)
+        {
+            if (!open || readOnly) {return false;}
+            for (auto entry = hostPreferences->begin(); entry != hostPreferences->end();)
+            {
+                if (entry->first.compare(0, space.size() + 1, space + "/") == 0) {entry = hostPreferences->erase(entry);}
+                else {++entry;}
+            }
+            return true;
+        }
+};
+
+#endif //__HOST_PREFERENCES_H__
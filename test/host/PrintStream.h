@@ -0,0 +1,22 @@
+/*!
+ * @file PrintStream.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the PrintStream << operators, for the native test build.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_PRINTSTREAM_H__
+#define __HOST_PRINTSTREAM_H__
+
+#include <Arduino.h>
+
+/// Ends a line when put to a stream
+enum _EndLineCode {endl};
+
+template <class T>
+inline Print& operator<<(Print& stream, const T& arg) {stream.print(arg); return stream;}
+
+inline Print& operator<<(Print& stream, _EndLineCode arg) {stream.println(); return stream;}
+
+#endif //__HOST_PRINTSTREAM_H__
@@ -0,0 +1,43 @@
+/*!
+ * @file WiFi.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the ESP32 WiFi driver, for the native test build.
+ * @details There is no radio; requests reach the web server from the test itself.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_WIFI_H__
+#define __HOST_WIFI_H__
+
+#include <Arduino.h>
+
+#define WIFI_AP 2
+
+/**
+ * @class IPAddress
+ * @brief An IPv4 address.
+ */
+class IPAddress {
+    public:
+        uint8_t octets[4];
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d} {}
+};
+
+/**
+ * @class WiFiClass
+ * @brief The WiFi driver, which only remembers its access point.
+ */
+class WiFiClass {
+    public:
+        int wifiMode = 0;
+        std::string ssid;
+
+        bool mode(int m) {wifiMode = m; return true;}
+        bool softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet) {return true;}
+        bool softAP(const char* name, const char* passphrase) {ssid = name; return true;}
+};
+
+inline WiFiClass WiFi;
+
+#endif //__HOST_WIFI_H__
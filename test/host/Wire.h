@@ -0,0 +1,238 @@
+/*!
+ * @file Wire.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the ESP32 TwoWire driver, for the native test build.
+ * @details Transactions are passed to simulated devices attached by address, and an address
+ * with no device does not acknowledge. Every transaction takes the time its bytes need at
+ * the bus clock, 9 bit times each, so a bus task is kept as busy as on the ESP32. The bus
+ * counts its transactions and bytes, and can log each one for tests to inspect.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_WIRE_H__
+#define __HOST_WIRE_H__
+
+#include <Arduino.h>
+
+/// Longest transfer in one direction, the size of the ESP32 driver's buffer
+#define HOST_TWI_BUFFER 128
+
+/**
+ * @class HostTwiDevice
+ * @brief A simulated device on a TWI bus.
+ */
+class HostTwiDevice {
+    public:
+        /*! @brief Takes the data bytes of a write
+        * @param data the bytes written after the address
+        * @param length number of bytes
+        * @return false to not acknowledge the write
+        */
+        virtual bool receive(const uint8_t* data, size_t length) = 0;
+
+        /*! @brief Gives the data bytes of a read
+        * @param data receives the bytes read
+        * @param length number of bytes requested
+        * @return false to not acknowledge the read
+        */
+        virtual bool request(uint8_t* data, size_t length) = 0;
+};
+
+/**
+ * @class HostRegisterDevice
+ * @brief A simulated device with a register pointer, auto-incremented by every byte read or written.
+ * @details The first byte of a write sets the pointer, as on the ADC128D818 and the BNO055.
+ * Reads and writes of registers go through readRegister() and writeRegister(), which
+ * devices override to model registers with side effects.
+ */
+class HostRegisterDevice : public HostTwiDevice {
+    protected:
+        uint8_t pointer = 0;
+    public:
+        uint8_t registers[256] = {}; ///< Register file, read and written by default
+        uint32_t failures = 0;       ///< Transactions still to not acknowledge
+
+        virtual uint8_t readRegister(uint8_t reg) {return registers[reg];}
+        virtual void writeRegister(uint8_t reg, uint8_t value) {registers[reg] = value;}
+        /// Register the pointer moves to after reg
+        virtual uint8_t nextRegister(uint8_t reg) {return reg + 1;}
+
+        bool receive(const uint8_t* data, size_t length) override
+        {
+            if (failures > 0) {failures--; return false;}
+            if (length == 0) {return true;}
+            pointer = data[0];
+            for (size_t i=1;i<length;i++)
+            {
+                writeRegister(pointer, data[i]);
+                pointer = nextRegister(pointer);
+            }
+            return true;
+        }
+
+        bool request(uint8_t* data, size_t length) override
+        {
+            if (failures > 0) {failures--; return false;}
+            for (size_t i=0;i<length;i++)
+            {
+                data[i] = readRegister(pointer);
+                pointer = nextRegister(pointer);
+            }
+            return true;
+        }
+};
+
+/**
+ * @struct HostTwiTransaction
+ * @brief One write or read of a transaction, as logged by the bus.
+ */
+struct HostTwiTransaction {
+    uint8_t address;
+    bool read;        ///< A read rather than a write
+    bool stop;        ///< Ended by a STOP rather than a repeated start
+    bool acknowledged;
+    std::vector<uint8_t> data;
+};
+
+/**
+ * @class TwoWire
+ * @brief A TWI controller with simulated devices on its bus.
+ */
+class TwoWire {
+    private:
+        uint8_t number;
+        uint32_t frequency = 100000;
+        HostTwiDevice* device[128] = {};
+        uint8_t txAddress = 0;
+        uint8_t txBuffer[HOST_TWI_BUFFER];
+        size_t txLength = 0;
+        uint8_t rxBuffer[HOST_TWI_BUFFER];
+        size_t rxLength = 0;
+        size_t rxIndex = 0;
+        bool inTransaction = false;  // A repeated start is continuing a transaction
+        bool logging = false;
+        std::vector<HostTwiTransaction>* log = new std::vector<HostTwiTransaction>;
+
+        /*! @brief Spends the time bytes take on the bus and counts them
+        * @param count bytes, including the address byte
+        * @param stop true if the transaction ends with them
+        */
+        void transfer(size_t count, bool stop)
+        {
+            if (!inTransaction) {transactions++;}
+            inTransaction = !stop;
+            bytes += count;
+            HOST_spendUs((int64_t)count * 9 * 1000000 / frequency);
+        }
+
+        void record(uint8_t address, bool read, bool stop, bool acknowledged, const uint8_t* data, size_t length)
+        {
+            if (logging) {log->push_back({address, read, stop, acknowledged, std::vector<uint8_t>(data, data + length)});}
+        }
+    public:
+        uint32_t transactions = 0; ///< Transactions since the bus was made, each ended by a STOP
+        uint64_t bytes = 0;        ///< Bytes put on the bus, including address bytes
+        uint32_t clockChanges = 0; ///< Times setClock() changed the clock
+
+        TwoWire(uint8_t bus) : number(bus) {}
+
+        bool begin(int sdaPin = -1, int sclPin = -1, uint32_t busFrequency = 0)
+        {
+            if (busFrequency != 0) {frequency = busFrequency;}
+            return true;
+        }
+        bool setClock(uint32_t busFrequency)
+        {
+            if (busFrequency != frequency) {clockChanges++;}
+            frequency = busFrequency;
+            return true;
+        }
+        uint32_t getClock(void) {return frequency;}
+
+        void beginTransmission(uint8_t address)
+        {
+            txAddress = address;
+            txLength = 0;
+        }
+        size_t write(uint8_t data)
+        {
+            if (txLength == HOST_TWI_BUFFER) {return 0;}
+            txBuffer[txLength++] = data;
+            return 1;
+        }
+        size_t write(const uint8_t* data, size_t length)
+        {
+            for (size_t i=0;i<length;i++)
+            {
+                if (!write(data[i])) {return i;}
+            }
+            return length;
+        }
+        /// Returns 0 on success and 2 when the address is not acknowledged, like the ESP32 driver
+        uint8_t endTransmission(bool sendStop = true)
+        {
+            HostTwiDevice* target = device[txAddress & 0x7F];
+            bool acknowledged = target != NULL && target->receive(txBuffer, txLength);
+            transfer(acknowledged ? 1 + txLength : 1, sendStop || !acknowledged);
+            record(txAddress, false, sendStop, acknowledged, txBuffer, txLength);
+            return acknowledged ? 0 : 2;
+        }
+        uint8_t endTransmission(int sendStop) {return endTransmission((bool)sendStop);}
+
+        /// Reads length bytes and ends with a STOP, returning the bytes received
+        uint8_t requestFrom(uint8_t address, uint8_t length)
+        {
+            if (length > HOST_TWI_BUFFER) {length = HOST_TWI_BUFFER;}
+            HostTwiDevice* target = device[address & 0x7F];
+            bool acknowledged = target != NULL && target->request(rxBuffer, length);
+            rxLength = acknowledged ? length : 0;
+            rxIndex = 0;
+            transfer(1 + rxLength, true);
+            record(address, true, true, acknowledged, rxBuffer, rxLength);
+            return rxLength;
+        }
+        uint8_t requestFrom(int address, int length) {return requestFrom((uint8_t)address, (uint8_t)length);}
+        int available(void) {return rxLength - rxIndex;}
+        int read(void) {return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;}
+        size_t readBytes(uint8_t* data, size_t length)
+        {
+            size_t n = 0;
+            for (;n<length && rxIndex<rxLength;n++) {data[n] = rxBuffer[rxIndex++];}
+            return n;
+        }
+
+        /*! @brief Puts a simulated device on the bus
+        * @param address its TWI address
+        * @param simulated the device, or NULL to take it off the bus
+        */
+        void attach(uint8_t address, HostTwiDevice* simulated) {device[address & 0x7F] = simulated;}
+
+        /*! @brief Starts logging every write and read, clearing the log
+        * @return the log, valid for the life of the program
+        */
+        std::vector<HostTwiTransaction>& startLog(void)
+        {
+            log->clear();
+            logging = true;
+            return *log;
+        }
+
+        /*! @brief Stops logging, keeping what was logged
+        */
+        void stopLog(void) {logging = false;}
+
+        /*! @brief Clears the transaction, byte and clock change counters
+        */
+        void clearCounters(void)
+        {
+            transactions = 0;
+            bytes = 0;
+            clockChanges = 0;
+        }
+};
+
+inline TwoWire Wire(0);
+inline TwoWire Wire1(1);
+
+#endif //__HOST_WIRE_H__
@@ -0,0 +1,117 @@
+/*!
+ * @file esp_timer.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the ESP-IDF high resolution timer, for the native test build.
+ * @details The time is that of HostRuntime.h. Each timer has a thread which runs its
+ * callback when it expires, as the esp_timer task does. On the simulated clock the thread
+ * moves the clock on to the expiry, plus any wake latency, as soon as the timer is started,
+ * so it suits tests where the task starting the timer then blocks until it fires. Reading
+ * the time costs a microsecond of simulated time, so busy waits on it come to an end.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_ESP_TIMER_H__
+#define __HOST_ESP_TIMER_H__
+
+#include "HostRuntime.h"
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_STATE 0x103
+
+/// Simulated time one esp_timer_get_time() takes, about what it takes on the ESP32
+#define HOST_TIMER_READ_US 1
+
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum {
+    ESP_TIMER_TASK
+} esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+/**
+ * @struct esp_timer
+ * @brief A one-shot timer and the thread running its callback.
+ */
+struct esp_timer {
+    std::mutex lock;
+    std::condition_variable changed;
+    esp_timer_cb_t callback;
+    void* arg;
+    int64_t due;     // HOST_timeUs() the callback is due at, -1 when stopped
+    uint32_t starts; // Times the timer was started
+};
+typedef esp_timer* esp_timer_handle_t;
+
+inline int64_t esp_timer_get_time(void)
+{
+    if (hostSimulated) {HOST_spendUs(HOST_TIMER_READ_US);}
+    return HOST_timeUs();
+}
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle)
+{
+    esp_timer* timer = new esp_timer;
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    timer->due = -1;
+    timer->starts = 0;
+    *handle = timer;
+    std::thread([timer] ()
+    {
+        std::unique_lock<std::mutex> guard(timer->lock);
+        for (;;)
+        {
+            timer->changed.wait(guard, [timer] () {return timer->due >= 0;});
+            int64_t remaining = timer->due - HOST_timeUs();
+            if (remaining > 0 && hostSimulated)
+            {
+                int64_t due = timer->due;
+                guard.unlock();
+                HOST_sleepUntilUs(due);
+                guard.lock();
+                continue; // Due by now, unless stopped or restarted meanwhile
+            }
+            if (remaining > 0)
+            {
+                timer->changed.wait_for(guard, std::chrono::microseconds(remaining));
+                continue; // Stopped, restarted or due by now
+            }
+            timer->due = -1;
+            guard.unlock();
+            timer->callback(timer->arg);
+            guard.lock();
+        }
+    }).detach();
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs)
+{
+    std::lock_guard<std::mutex> guard(timer->lock);
+    if (timer->due >= 0) {return ESP_ERR_INVALID_STATE;}
+    timer->due = HOST_timeUs() + (int64_t)timeoutUs;
+    timer->starts++;
+    timer->changed.notify_all();
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    std::lock_guard<std::mutex> guard(timer->lock);
+    if (timer->due < 0) {return ESP_ERR_INVALID_STATE;}
+    timer->due = -1;
+    timer->changed.notify_all();
+    return ESP_OK;
+}
+
+#endif //__HOST_ESP_TIMER_H__
@@ -0,0 +1,79 @@
+/*!
+ * @file gpio_struct.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the ESP32 GPIO output registers, for the native test build.
+ * @details Writes to the W1TS and W1TC registers set and clear bits of the two output
+ * registers, out for pins 0-31 and out1 for pins 32-39, and can be logged with the output
+ * levels they leave, so tests can check every intermediate state of the pins.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_GPIO_STRUCT_H__
+#define __HOST_GPIO_STRUCT_H__
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @struct HostGpioWrite
+ * @brief One write to a W1TS or W1TC register and the output levels after it.
+ */
+struct HostGpioWrite {
+    uint8_t bank;     ///< 0 for pins 0-31, 1 for pins 32-39
+    bool set;         ///< W1TS rather than W1TC
+    uint32_t mask;    ///< Bits written
+    uint32_t out[2];  ///< Output registers after the write
+};
+
+/// Output levels of pins 0-31 and 32-39, and the log of register writes when enabled
+inline uint32_t hostGpioOut[2];
+inline bool hostGpioLogging = false;
+inline std::vector<HostGpioWrite>* hostGpioLog = new std::vector<HostGpioWrite>;
+
+/**
+ * @struct HostGpioRegister
+ * @brief A write-one-to-set or write-one-to-clear register.
+ */
+struct HostGpioRegister {
+    uint8_t bank;
+    bool set;
+
+    HostGpioRegister& operator=(uint32_t mask)
+    {
+        if (set) {hostGpioOut[bank] |= mask;}
+        else {hostGpioOut[bank] &= ~mask;}
+        if (hostGpioLogging) {hostGpioLog->push_back({bank, set, mask, {hostGpioOut[0], hostGpioOut[1]}});}
+        return *this;
+    }
+};
+
+/// The registers of pins 32-39 are written through their val member
+struct HostGpioRegister1 {
+    HostGpioRegister val;
+};
+
+typedef struct {
+    HostGpioRegister out_w1ts;
+    HostGpioRegister out_w1tc;
+    HostGpioRegister1 out1_w1ts;
+    HostGpioRegister1 out1_w1tc;
+} gpio_dev_t;
+
+inline gpio_dev_t GPIO = {{0, true}, {0, false}, {{1, true}}, {{1, false}}};
+
+/*! @brief Starts logging GPIO register writes, clearing the log
+* @return the log, valid for the life of the program
+*/
+inline std::vector<HostGpioWrite>& HOST_startGpioLog(void)
+{
+    hostGpioLog->clear();
+    hostGpioLogging = true;
+    return *hostGpioLog;
+}
+
+/*! @brief Stops logging GPIO register writes, keeping what was logged
+*/
+inline void HOST_stopGpioLog(void) {hostGpioLogging = false;}
+
+#endif //__HOST_GPIO_STRUCT_H__
@@ -0,0 +1,36 @@
+/*!
+ * @file taskqueue.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the ME507 Queue, for the native test build.
+ * @details Items go through a host FreeRTOS queue, so a task getting from an empty
+ * queue blocks until another puts to it.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_TASKQUEUE_H__
+#define __HOST_TASKQUEUE_H__
+
+#include <Arduino.h>
+
+/**
+ * @class Queue
+ * @brief A queue of items passed between tasks.
+ */
+template <class DataType>
+class Queue {
+    private:
+        QueueHandle_t handle;
+    public:
+        Queue(BaseType_t queue_size, const char* p_name = NULL, TickType_t wait_time = portMAX_DELAY)
+            : handle(xQueueCreate(queue_size, sizeof(DataType))) {}
+
+        bool put(const DataType& item) {return xQueueSend(handle, &item, portMAX_DELAY) == pdTRUE;}
+        bool ISR_put(const DataType& item) {return xQueueSend(handle, &item, 0) == pdTRUE;}
+        void get(DataType& recipient) {xQueueReceive(handle, &recipient, portMAX_DELAY);}
+        DataType get(void) {DataType item; get(item); return item;}
+        bool is_empty(void) {return uxQueueMessagesWaiting(handle) == 0;}
+        bool any(void) {return !is_empty();}
+};
+
+#endif //__HOST_TASKQUEUE_H__
@@ -0,0 +1,35 @@
+/*!
+ * @file taskshare.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the ME507 Share, for the native test build.
+ * @details A share is one value guarded by a mutex, so tasks running as threads
+ * never see a half written value, as with the FreeRTOS queue behind the original.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_TASKSHARE_H__
+#define __HOST_TASKSHARE_H__
+
+#include <Arduino.h>
+
+/**
+ * @class Share
+ * @brief One value shared between tasks.
+ */
+template <class DataType>
+class Share {
+    private:
+        DataType value {};
+        std::mutex* guard = new std::mutex;
+    public:
+        Share(const char* p_name = NULL) {}
+
+        void put(DataType newData) {std::lock_guard<std::mutex> hold(*guard); value = newData;}
+        void ISR_put(DataType newData) {put(newData);}
+        void get(DataType& recipient) {std::lock_guard<std::mutex> hold(*guard); recipient = value;}
+        DataType get(void) {DataType copy; get(copy); return copy;}
+        void ISR_get(DataType& recipient) {get(recipient);}
+};
+
+#endif //__HOST_TASKSHARE_H__
@@ -0,0 +1,33 @@
+/*!
+ * @file imumaths.h
+ * @author Setting-Dawn
+ * @brief Host stand-in for the vector type of the Adafruit BNO055 driver, for the native test build.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#ifndef __HOST_IMUMATHS_H__
+#define __HOST_IMUMATHS_H__
+
+#include <stdint.h>
+
+namespace imu {
+
+/**
+ * @class Vector
+ * @brief A vector of N doubles.
+ */
+template <uint8_t N>
+class Vector {
+    private:
+        double p[N] = {};
+    public:
+        double& operator[](int n) {return p[n];}
+        double x(void) const {return p[0];}
+        double y(void) const {return p[1];}
+        double z(void) const {return p[2];}
+};
+
+} // namespace imu
+
+#endif //__HOST_IMUMATHS_H__
@@ -0,0 +1,194 @@
+/*!
+ * @file test_adc_bulk.cpp
+ * @author Setting-Dawn
+ * @brief Counts the transactions and bytes the ADC128D818 driver puts on a simulated bus.
+ * @details The bus counts every transaction and byte and spends the time they take on the
+ * simulated clock, so the block read can be compared with reading the channels one at a
+ * time, as every excitation used to, and the counters the driver and the engine keep can
+ * be checked against what actually went over the bus. The ADCs convert on demand, so the
+ * engine is also checked to convert only the channels each excitation measures.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+#include "ADC128D818Bulk.h"
+
+static const uint8_t ADDRESS = 0x1D;
+
+static SimulatedADC128D818 device;
+static ADC128D818Bulk adc(&Wire, ADDRESS);
+
+/*! @brief Converts all channels once so the result registers hold known codes
+*/
+static void convert(void)
+{
+    device.level = [] (uint8_t channel) {return 500.0f * channel + 17;};
+    TEST_ASSERT_TRUE(adc.setDisabledChannels(0x00));
+    TEST_ASSERT_TRUE(adc.startOneShot());
+    HOST_spendUs(8 * device.conversionUs);
+}
+
+void setUp(void)
+{
+    Wire.attach(ADDRESS, &device);
+    Wire.setClock(HOST_ADC_TWI_HZ);
+    TEST_ASSERT_TRUE(adc.begin(true));
+    convert();
+    adc.clearCounters();
+    Wire.clearCounters();
+}
+
+void tearDown(void) {Wire.attach(ADDRESS, NULL);}
+
+void test_read_all_is_one_transaction(void)
+{
+    uint16_t codes[8];
+    std::vector<HostTwiTransaction>& log = Wire.startLog();
+    TEST_ASSERT_TRUE(adc.readAll(codes));
+    Wire.stopLog();
+
+    // The register pointer write and the 16 byte read, joined by a repeated start
+    TEST_ASSERT_EQUAL(2, log.size());
+    TEST_ASSERT_FALSE(log[0].read);
+    TEST_ASSERT_FALSE(log[0].stop);
+    TEST_ASSERT_EQUAL(1, log[0].data.size());
+    TEST_ASSERT_EQUAL_HEX8(ADC128D818_CHANNEL_READING_REG, log[0].data[0]);
+    TEST_ASSERT_TRUE(log[1].read);
+    TEST_ASSERT_TRUE(log[1].stop);
+    TEST_ASSERT_EQUAL(16, log[1].data.size());
+
+    TEST_ASSERT_EQUAL(1, Wire.transactions);
+    TEST_ASSERT_EQUAL(ADC128D818_READ_ALL_BYTES, (uint32_t)Wire.bytes);
+    TEST_ASSERT_EQUAL(1, adc.getTransactions());
+    TEST_ASSERT_EQUAL(ADC128D818_READ_ALL_BYTES, adc.getBytes());
+    for (uint8_t c=0;c<8;c++) {TEST_ASSERT_EQUAL(500 * c + 17, codes[c]);}
+}
+
+void test_block_read_against_single_channel_reads(void)
+{
+    uint16_t codes[8];
+    int64_t start = HOST_timeUs();
+    TEST_ASSERT_TRUE(adc.readAll(codes));
+    int64_t blockUs = HOST_timeUs() - start;
+    uint32_t blockTransactions = Wire.transactions;
+    uint64_t blockBytes = Wire.bytes;
+
+    Wire.clearCounters();
+    start = HOST_timeUs();
+    for (uint8_t c=0;c<8;c++) {TEST_ASSERT_EQUAL(codes[c], adc.read(c));}
+    int64_t singleUs = HOST_timeUs() - start;
+
+    char message[160];
+    snprintf(message, sizeof(message), "All 8 channels at %u kHz: block read %u transaction, %u bytes, %d us; "
+             "single reads %u transactions, %u bytes, %d us", HOST_ADC_TWI_HZ / 1000, blockTransactions,
+             (unsigned)blockBytes, (int)blockUs, Wire.transactions, (unsigned)Wire.bytes, (int)singleUs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL(8, Wire.transactions);
+    TEST_ASSERT_EQUAL(8 * (3 + 2), (uint32_t)Wire.bytes);
+    TEST_ASSERT_EQUAL(1 + 8, adc.getTransactions());
+    TEST_ASSERT_EQUAL(ADC128D818_READ_ALL_BYTES + 8 * (3 + 2), adc.getBytes());
+    TEST_ASSERT_LESS_THAN(singleUs / 2, blockUs);
+}
+
+void test_counters_match_the_bus(void)
+{
+    bool busy = true;
+    uint16_t codes[8];
+    TEST_ASSERT_TRUE(adc.setDisabledChannels(0xF0));
+    TEST_ASSERT_TRUE(adc.startOneShot());
+    TEST_ASSERT_TRUE(adc.readBusy(busy));
+    TEST_ASSERT_TRUE(busy);
+    HOST_spendUs(4 * device.conversionUs);
+    TEST_ASSERT_TRUE(adc.readBusy(busy));
+    TEST_ASSERT_FALSE(busy);
+    TEST_ASSERT_TRUE(adc.readAll(codes));
+
+    TEST_ASSERT_EQUAL(Wire.transactions, adc.getTransactions());
+    TEST_ASSERT_EQUAL(2 * ADC128D818_WRITE_BYTES + 2 * ADC128D818_BUSY_BYTES + ADC128D818_READ_ALL_BYTES, adc.getBytes());
+    TEST_ASSERT_EQUAL((uint32_t)Wire.bytes, adc.getBytes());
+    TEST_ASSERT_EQUAL(4, adc.getConversions());
+}
+
+void test_failed_read_is_reported(void)
+{
+    uint16_t codes[8];
+    device.failures = 1;
+    TEST_ASSERT_FALSE(adc.readAll(codes));
+    TEST_ASSERT_EQUAL(1, adc.getTransactions());
+    TEST_ASSERT_TRUE(adc.readAll(codes));
+}
+
+void test_engine_counts_every_adc_transaction(void)
+{
+    using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+    static HostEITRig<Protocol> rig;
+    TEST_ASSERT_TRUE(rig.begin());
+    rig.frames(1);
+
+    std::vector<HostTwiTransaction>& log = Wire.startLog();
+    rig.frames(1);
+    Wire.stopLog();
+
+    // Every write ends a transaction with a STOP, or continues into the read which does
+    uint32_t transactions = 0;
+    uint32_t bytes = 0;
+    for (const HostTwiTransaction& t : log)
+    {
+        if (t.address != HOST_ADC_ADDRESSES[0] && t.address != HOST_ADC_ADDRESSES[1]) {continue;}
+        if (t.stop) {transactions++;}
+        bytes += 1 + t.data.size();
+    }
+    const EITStats& stats = rig.engine.getStats();
+    TEST_ASSERT_EQUAL(transactions, stats.adcTransactions);
+    TEST_ASSERT_EQUAL(bytes, stats.adcBytes);
+
+    char message[96];
+    snprintf(message, sizeof(message), "16 electrode frame: %u ADC transactions, %u bytes",
+             stats.adcTransactions, stats.adcBytes);
+    TEST_MESSAGE(message);
+}
+
+/*! @brief Counts the channel conversions of one frame of a protocol
+* @tparam PROTOCOL the EITProtocol the rig runs
+* @return the conversions the simulated ADCs made
+*/
+template <typename PROTOCOL>
+static uint32_t frameConversions(void)
+{
+    static HostEITRig<PROTOCOL> rig;
+    TEST_ASSERT_TRUE(rig.begin());
+    rig.frames(1);
+    uint32_t conversions = rig.conversions();
+    rig.frames(1);
+    conversions = rig.conversions() - conversions;
+
+    TEST_ASSERT_EQUAL(conversions, rig.engine.getStats().adcConversions);
+    TEST_ASSERT_EQUAL(0, rig.earlyReads());
+    return conversions;
+}
+
+void test_engine_converts_only_measured_channels(void)
+{
+    // Every excitation leaves out its source and sink, where all 8 channels of every ADC
+    // used to be converted
+    TEST_ASSERT_EQUAL(8 * 6, (frameConversions<EITProtocolOf<8, EITPattern::Adjacent>>()));
+    TEST_ASSERT_EQUAL(16 * 14, (frameConversions<EITProtocolOf<16, EITPattern::Adjacent>>()));
+    TEST_ASSERT_EQUAL(32 * 30, (frameConversions<EITProtocolOf<32, EITPattern::Adjacent>>()));
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_read_all_is_one_transaction);
+    RUN_TEST(test_block_read_against_single_channel_reads);
+    RUN_TEST(test_counters_match_the_bus);
+    RUN_TEST(test_failed_read_is_reported);
+    RUN_TEST(test_engine_counts_every_adc_transaction);
+    RUN_TEST(test_engine_converts_only_measured_channels);
+    return UNITY_END();
+}
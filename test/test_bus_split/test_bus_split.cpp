@@ -0,0 +1,184 @@
+/*!
+ * @file test_bus_split.cpp
+ * @author Setting-Dawn
+ * @brief Benchmark of the IMU reads and EIT jobs waiting for each other on one shared TWI bus and on two split ones.
+ * @details The EIT engine measures frames in a task of its own while the IMU is read every
+ * 10 ms, as in main.cpp, first with both behind one bus task on Wire1 as on the board
+ * and then with the engine on Wire and the IMU alone on Wire1, as with TWI_SPLIT_BUS. This runs
+ * on the real clock, as the two clients and the bus tasks must run at the same time, and
+ * every transfer takes as long as its bytes would at its clock.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+#include "IMU.h"
+
+using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+
+/// Clock the BNO055 is run at, as it stretches faster clocks
+static const uint32_t BNO055_HZ = 100000;
+/// Bytes of one IMU read: two address bytes, the register pointer and the burst
+static const uint16_t IMU_READ_BYTES = 3 + BNO055_BURST_BYTES;
+/// IMU sampling period and the ticks a read may wait for the bus, as in main.cpp
+static const uint32_t IMU_PERIOD_MS = 10;
+static const TickType_t IMU_DEADLINE = 4;
+/// IMU reads timed for each topology
+static const uint32_t IMU_READS = 100;
+
+/**
+ * @class SimulatedBNO055
+ * @brief A BNO055 which answers with its chip ID, enough for IMU_init() and burst reads.
+ */
+class SimulatedBNO055 : public HostRegisterDevice {
+    public:
+        SimulatedBNO055(void) {registers[0x00] = BNO055_ID;}
+};
+
+static SimulatedBNO055 sensor;
+
+/**
+ * @struct Contention
+ * @brief What one topology did to the IMU reads and to the frame rate.
+ */
+struct Contention {
+    uint32_t reads;        ///< IMU reads done
+    uint32_t expired;      ///< IMU reads dropped at their deadline
+    float imuMeanWaitUs;   ///< Mean time an IMU read waited for the bus
+    uint32_t imuMaxWaitUs; ///< Longest time an IMU read waited for the bus
+    float eitMeanWaitUs;   ///< Mean time an EIT job waited for the bus
+    uint32_t eitMaxWaitUs; ///< Longest time an EIT job waited for the bus
+    float framesPerSecond;
+};
+
+/// Whether the EIT task should keep measuring, and whether its engine began
+static std::atomic<bool> measuring {false};
+static std::atomic<int> eitBegan {-1};
+
+/*! @brief Bus job reading one IMU burst
+* @param context the IMUBurst to fill in
+* @return true if the IMU answered
+*/
+static bool readIMU(void* context) {return IMU_readBurst(*(IMUBurst*)context);}
+
+/*! @brief Task measuring frames until told to stop, as task_ReadMaterial does
+* @param p_params the rig
+*/
+static void eitTask(void* p_params)
+{
+    HostEITRig<Protocol>* rig = (HostEITRig<Protocol>*)p_params;
+    eitBegan = rig->begin() ? 1 : 0;
+    while (measuring) {rig->engine.step();}
+    eitBegan = -1;
+}
+
+/*! @brief Reads the IMU every period while a rig measures frames
+* @param rig the EIT engine, not begun
+* @param imuBus the bus the IMU is read through, which may be the rig's
+* @return what the IMU reads and the EIT jobs waited, and the frame rate
+*/
+static Contention measure(HostEITRig<Protocol>& rig, TWIBus& imuBus)
+{
+    measuring = true;
+    xTaskCreate(eitTask, "EIT", 8192, &rig, 3, NULL);
+    while (eitBegan < 0) {vTaskDelay(1);}
+    TEST_ASSERT_EQUAL(1, eitBegan);
+
+    TWIStats before, eitBefore;
+    imuBus.getStats(before);
+    rig.bus.getStats(eitBefore);
+    uint32_t firstFrame = rig.engine.getStats().frames;
+    int64_t start = esp_timer_get_time();
+
+    IMUBurst burst;
+    TickType_t wake = xTaskGetTickCount();
+    for (uint32_t n=0;n<IMU_READS;n++)
+    {
+        vTaskDelayUntil(&wake, IMU_PERIOD_MS);
+        imuBus.run(TWI_CLIENT_IMU, TWI_PRIORITY_HIGH, BNO055_ADDRESS_A, IMU_READ_BYTES, readIMU, &burst, IMU_DEADLINE);
+    }
+
+    float seconds = (esp_timer_get_time() - start) / 1e6f;
+    uint32_t frames = rig.engine.getStats().frames - firstFrame;
+    measuring = false;
+    while (eitBegan >= 0) {vTaskDelay(1);}
+
+    // Each bus was started for this measurement, so the longest waits are its own
+    TWIStats after, eitAfter;
+    imuBus.getStats(after);
+    rig.bus.getStats(eitAfter);
+    const TWIClientStats& imu = after.client[TWI_CLIENT_IMU];
+    const TWIClientStats& eit = eitAfter.client[TWI_CLIENT_EIT];
+    Contention result;
+    result.reads = imu.jobs - before.client[TWI_CLIENT_IMU].jobs;
+    result.expired = imu.expired - before.client[TWI_CLIENT_IMU].expired;
+    result.imuMeanWaitUs = result.reads ? (imu.waitUs - before.client[TWI_CLIENT_IMU].waitUs) / (float)result.reads : 0.0f;
+    result.imuMaxWaitUs = imu.maxWaitUs;
+    uint32_t eitJobs = eit.jobs - eitBefore.client[TWI_CLIENT_EIT].jobs;
+    result.eitMeanWaitUs = eitJobs ? (eit.waitUs - eitBefore.client[TWI_CLIENT_EIT].waitUs) / (float)eitJobs : 0.0f;
+    result.eitMaxWaitUs = eit.maxWaitUs;
+    result.framesPerSecond = frames / seconds;
+    return result;
+}
+
+/*! @brief Reports what one topology did
+* @param label name of the topology
+* @param result its measurements
+*/
+static void report(const char* label, const Contention& result)
+{
+    char message[200];
+    snprintf(message, sizeof(message), "%-6s IMU reads %lu, expired %lu, wait mean %6.1f us max %5lu us;"
+             " EIT jobs wait mean %6.1f us max %5lu us, %.2f frames/s",
+             label, (unsigned long)result.reads, (unsigned long)result.expired, result.imuMeanWaitUs,
+             (unsigned long)result.imuMaxWaitUs, result.eitMeanWaitUs, (unsigned long)result.eitMaxWaitUs,
+             result.framesPerSecond);
+    TEST_MESSAGE(message);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_split_buses_remove_contention(void)
+{
+    // One bus task on Wire1 for both, with the IMU at its own clock in the table as main.cpp does
+    static HostEITRig<Protocol> sharedRig(&Wire1);
+    sharedRig.bus.addDevice(BNO055_ADDRESS_A, BNO055_HZ);
+    Wire1.attach(BNO055_ADDRESS_A, &sensor);
+    TEST_ASSERT_TRUE(IMU_init(&Wire1, 5));
+    Contention shared = measure(sharedRig, sharedRig.bus);
+    report("Shared", shared);
+
+    // The engine on Wire and the IMU alone on Wire1
+    static HostEITRig<Protocol> splitRig(&Wire);
+    static TWIBus imuBus(&Wire1);
+    TEST_ASSERT_TRUE(imuBus.begin("IMU Bus", 8, 16, 17, BNO055_HZ));
+    Contention split = measure(splitRig, imuBus);
+    report("Split", split);
+
+    TEST_ASSERT_EQUAL(IMU_READS, shared.reads + shared.expired);
+    TEST_ASSERT_EQUAL(IMU_READS, split.reads);
+    TEST_ASSERT_EQUAL(0, split.expired);
+    // Split, neither bus task ever runs a job of the other client
+    TWIStats imuStats, eitStats;
+    imuBus.getStats(imuStats);
+    splitRig.bus.getStats(eitStats);
+    TEST_ASSERT_EQUAL(0, imuStats.client[TWI_CLIENT_EIT].jobs);
+    TEST_ASSERT_EQUAL(0, eitStats.client[TWI_CLIENT_IMU].jobs);
+    // Sharing the bus, EIT jobs queue behind IMU reads which take 3.3 ms at 100 kHz;
+    // split, they only wait for their bus task to wake. The IMU's own wait is reported but
+    // not compared: EIT transfers are split into short jobs, so what a shared bus adds to it
+    // is within the wake latency of the host's threads.
+    TEST_ASSERT_LESS_THAN_FLOAT(shared.eitMeanWaitUs, split.eitMeanWaitUs);
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(false);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_split_buses_remove_contention);
+    return UNITY_END();
+}
@@ -0,0 +1,171 @@
+/*!
+ * @file test_eit_binary.cpp
+ * @author Setting-Dawn
+ * @brief Round trip tests of the binary frame format and a size and time benchmark against the CSV page.
+ * @details Frames are encoded as /data.bin and the WebSocket stream send them and decoded
+ * as a host program reads them, in both the int16 code and float32 volt layouts. The
+ * decoder must refuse any buffer cut short of a whole frame. The benchmark compares the
+ * bytes and the encoding time of a 32 electrode frame with its /data CSV page.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include "ADC128D818Bulk.h"
+#include "EITprotocol.h"
+#include "EITframe.h"
+#include "EITbinary.h"
+#include "EITcsv.h"
+
+using Frame = EITFrame<EITProtocolOf<32, EITPattern::Adjacent>>;
+
+/// Largest encoded frame, with float32 values
+static const size_t FRAME_BYTES = EIT_BINARY_HEADER_SIZE + Frame::measurements * 4;
+
+/*! @brief Fills a frame with codes spread over the whole range
+* @param frame the frame
+* @param fractionBits extra bits of the codes
+*/
+static void fillFrame(Frame& frame, uint8_t fractionBits)
+{
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> code(-32768, 32767);
+    for (uint16_t n=0;n<Frame::measurements;n++) {frame.values[n] = (int16_t)code(random);}
+    frame.sequence = 0x89ABCDEF;
+    frame.timestamp = 0x01234567;
+    frame.scale = ADC128D818_INTERNAL_REF_V / 4096.0f / (1 << fractionBits);
+}
+
+/*! @brief Checks that a frame decodes to what was encoded
+* @param frame the frame
+* @param flags the flags it is encoded with
+*/
+static void assertRoundTrip(const Frame& frame, uint8_t flags)
+{
+    static uint8_t buffer[FRAME_BYTES];
+    static float volts[Frame::measurements];
+    size_t len = EITbinary_encode(frame, flags, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(EITbinary_size(Frame::measurements, flags), len);
+
+    EITBinaryHeader header;
+    TEST_ASSERT_EQUAL(Frame::measurements, EITbinary_decode(buffer, len, header, volts, Frame::measurements));
+    TEST_ASSERT_EQUAL_HEX32(EIT_BINARY_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL(EIT_BINARY_VERSION, header.version);
+    TEST_ASSERT_EQUAL(EIT_BINARY_HEADER_SIZE, header.headerSize);
+    TEST_ASSERT_EQUAL_HEX32(frame.sequence, header.sequence);
+    TEST_ASSERT_EQUAL_HEX32(frame.timestamp, header.timestamp);
+    TEST_ASSERT_EQUAL(Frame::electrodes, header.electrodes);
+    TEST_ASSERT_EQUAL_HEX8(flags, header.flags);
+    TEST_ASSERT_EQUAL(Frame::measurements, header.count);
+    TEST_ASSERT_EQUAL_FLOAT(frame.scale, header.scale);
+    for (uint16_t n=0;n<Frame::measurements;n++) {TEST_ASSERT_EQUAL_FLOAT(frame.volts(n), volts[n]);}
+}
+
+/*! @brief Encodes the /data page of a frame through the streaming CSV encoder
+* @param frame the frame
+* @return the bytes of the page
+*/
+static size_t csvPage(const Frame& frame)
+{
+    size_t bytes = 0;
+    EITCsvState state;
+    EITcsv_begin(state);
+    uint8_t buffer[1460];
+    size_t len;
+    while ((len = EITcsv_write(frame, true, true, state, buffer, sizeof(buffer))) > 0) {bytes += len;}
+    return bytes;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_codes_round_trip(void)
+{
+    static Frame frame;
+    fillFrame(frame, 0);
+    assertRoundTrip(frame, 0);
+    fillFrame(frame, 3);
+    assertRoundTrip(frame, EIT_BINARY_FLAG_INITIALIZE | EIT_BINARY_FLAG_READ);
+}
+
+void test_volts_round_trip(void)
+{
+    static Frame frame;
+    fillFrame(frame, 2);
+    assertRoundTrip(frame, EIT_BINARY_FLAG_FLOAT32 | EIT_BINARY_FLAG_READ);
+}
+
+void test_short_buffers_are_refused(void)
+{
+    static Frame frame;
+    static uint8_t buffer[FRAME_BYTES];
+    static float volts[Frame::measurements];
+    fillFrame(frame, 0);
+    EITBinaryHeader header;
+    const uint8_t layouts[] = {0, EIT_BINARY_FLAG_FLOAT32};
+    for (uint8_t flags : layouts)
+    {
+        size_t size = EITbinary_size(Frame::measurements, flags);
+        TEST_ASSERT_EQUAL(0, EITbinary_encode(frame, flags, buffer, size - 1));
+
+        // Every length short of the whole frame, from inside the header to the last value byte
+        TEST_ASSERT_EQUAL(size, EITbinary_encode(frame, flags, buffer, sizeof(buffer)));
+        for (size_t len=0;len<size;len++)
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(0, EITbinary_decode(buffer, len, header, volts, Frame::measurements), "Truncated frame decoded");
+        }
+        TEST_ASSERT_EQUAL(0, EITbinary_decode(buffer, size, header, volts, Frame::measurements - 1));
+    }
+
+    // Not a frame of this format
+    EITbinary_encode(frame, 0, buffer, sizeof(buffer));
+    buffer[0] ^= 0xFF;
+    TEST_ASSERT_EQUAL(0, EITbinary_decode(buffer, sizeof(buffer), header, volts, Frame::measurements));
+    buffer[0] ^= 0xFF;
+    EITbinary_put16(buffer + 4, EIT_BINARY_VERSION + 1);
+    TEST_ASSERT_EQUAL(0, EITbinary_decode(buffer, sizeof(buffer), header, volts, Frame::measurements));
+}
+
+void test_benchmark_against_csv(void)
+{
+    const uint32_t frames = 2000;
+    static Frame frame;
+    static uint8_t buffer[FRAME_BYTES];
+    fillFrame(frame, 3);
+
+    size_t csvBytes = 0, codeBytes = 0, voltBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n=0;n<frames;n++) {csvBytes = csvPage(frame);}
+    float csvUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t n=0;n<frames;n++) {codeBytes = EITbinary_encode(frame, 0, buffer, sizeof(buffer));}
+    float codeUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t n=0;n<frames;n++) {voltBytes = EITbinary_encode(frame, EIT_BINARY_FLAG_FLOAT32, buffer, sizeof(buffer));}
+    float voltUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    char message[160];
+    snprintf(message, sizeof(message), "%u value frame on the host: CSV %u bytes %.2f us, int16 %u bytes %.2f us, float32 %u bytes %.2f us",
+             (unsigned)Frame::measurements, (unsigned)csvBytes, csvUs, (unsigned)codeBytes, codeUs, (unsigned)voltBytes, voltUs);
+    TEST_MESSAGE(message);
+    // Two bytes a value against up to a dozen characters, with no digits to format
+    TEST_ASSERT_LESS_THAN(csvBytes / 4, codeBytes);
+    TEST_ASSERT_LESS_THAN(csvBytes / 2, voltBytes);
+    TEST_ASSERT_LESS_THAN_FLOAT(csvUs, codeUs);
+    TEST_ASSERT_LESS_THAN_FLOAT(csvUs, voltUs);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_codes_round_trip);
+    RUN_TEST(test_volts_round_trip);
+    RUN_TEST(test_short_buffers_are_refused);
+    RUN_TEST(test_benchmark_against_csv);
+    return UNITY_END();
+}
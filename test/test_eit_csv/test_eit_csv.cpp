@@ -0,0 +1,182 @@
+/*!
+ * @file test_eit_csv.cpp
+ * @author Setting-Dawn
+ * @brief Tests that the streaming CSV encoder prints exactly what String(value, 8) does, and a benchmark of the two.
+ * @details The host String formats through a copy of the core's dtostrf(), so every
+ * voltage an ADC code can give at every oversampling scale is compared character for
+ * character, along with values around the edges of the integer path. The benchmark
+ * times the /data page of a 32 electrode frame built both ways.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include "ADC128D818Bulk.h"
+#include "EITprotocol.h"
+#include "EITframe.h"
+#include "EITcsv.h"
+
+using Frame = EITFrame<EITProtocolOf<32, EITPattern::Adjacent>>;
+
+/// Volts of one ADC code without oversampling
+static const float VOLTS_PER_CODE = ADC128D818_INTERNAL_REF_V / 4096.0f;
+
+/*! @brief Checks that a value is printed as String(value, 8) prints it
+* @param value the value
+*/
+static void assertSameText(float value)
+{
+    char text[EIT_CSV_FIELD_MAX + 1];
+    text[EITcsv_formatVolts(value, text)] = '\0';
+    String expected(value, 8);
+    if (strcmp(expected.c_str(), text) != 0)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        char message[96];
+        snprintf(message, sizeof(message), "%.9g (0x%08x)", value, bits);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.c_str(), text, message);
+    }
+}
+
+/*! @brief Builds the /data page of a frame the way it used to be, through String
+* @param frame the frame
+* @param initialize value of initializeFLG
+* @param read value of readFLG
+* @return the page
+*/
+static String legacyPage(const Frame& frame, bool initialize, bool read)
+{
+    String csv_str = "Voltage Readings,";
+    for (uint16_t n=0;n<Frame::measurements;n++)
+    {
+        csv_str += String(frame.volts(n), 8);
+        csv_str += ",";
+    }
+    csv_str += "\n";
+    csv_str += "initializeFLG,";
+    csv_str += String(initialize);
+    csv_str += "\n";
+    csv_str += "readFLG,";
+    csv_str += String(read);
+    csv_str += "\n";
+    return csv_str;
+}
+
+/*! @brief Builds the /data page of a frame through the streaming encoder
+* @param frame the frame
+* @param initialize value of initializeFLG
+* @param read value of readFLG
+* @param chunk bytes the connection takes at a time
+* @return the page
+*/
+static std::string streamedPage(const Frame& frame, bool initialize, bool read, size_t chunk)
+{
+    std::string page;
+    EITCsvState state;
+    EITcsv_begin(state);
+    uint8_t buffer[1460];
+    size_t len;
+    while ((len = EITcsv_write(frame, initialize, read, state, buffer, chunk)) > 0) {page.append((char*)buffer, len);}
+    return page;
+}
+
+/*! @brief Fills a frame with codes spread over the whole range
+* @param frame the frame
+* @param fractionBits extra bits of the codes
+*/
+static void fillFrame(Frame& frame, uint8_t fractionBits)
+{
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> code(-32768, 32767);
+    for (uint16_t n=0;n<Frame::measurements;n++) {frame.values[n] = (int16_t)code(random);}
+    frame.scale = VOLTS_PER_CODE / (1 << fractionBits);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_every_code_at_every_scale(void)
+{
+    // Oversampling gives up to 3 extra bits
+    for (uint8_t fractionBits=0;fractionBits<=3;fractionBits++)
+    {
+        float scale = VOLTS_PER_CODE / (1 << fractionBits);
+        for (int32_t code=-32768;code<=32767;code++) {assertSameText((int16_t)code * scale);}
+    }
+}
+
+void test_edges_of_the_integer_path(void)
+{
+    const float values[] = {0.0f, -0.0f, 1e-9f, -1e-9f, 5e-9f, -5e-9f, 4.9999999e-9f, 1.5e-45f, -1.5e-45f,
+                            1.17549435e-38f, 0.5f, 0.125f, 0.00000001f, 0.000000015f, 9.99999999f,
+                            15.9999990f, 16.0f, -16.0f, 16.0000019f, 123.456789f, 1e10f, -3.4e38f};
+    for (float value : values) {assertSameText(value);}
+    assertSameText(NAN);
+    assertSameText(INFINITY);
+    assertSameText(-INFINITY);
+
+    // Every float in a few binades either side of 16 V and down to the smallest volts
+    std::mt19937 random(3);
+    std::uniform_int_distribution<uint32_t> bits(0, 0x7FFFFF);
+    for (int exponent=100;exponent<140;exponent++)
+    {
+        for (uint32_t n=0;n<20000;n++)
+        {
+            uint32_t word = (exponent << 23) | bits(random) | (n & 1 ? 0x80000000 : 0);
+            float value;
+            memcpy(&value, &word, sizeof(value));
+            assertSameText(value);
+        }
+    }
+}
+
+void test_streamed_page_matches_the_string_page(void)
+{
+    static Frame frame;
+    fillFrame(frame, 3);
+    String expected = legacyPage(frame, true, false);
+    const size_t chunks[] = {1, 7, 64, 536, 1460};
+    for (size_t chunk : chunks)
+    {
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), streamedPage(frame, true, false, chunk).c_str());
+    }
+    TEST_ASSERT_EQUAL_STRING(legacyPage(frame, false, true).c_str(), streamedPage(frame, false, true, 1460).c_str());
+}
+
+void test_benchmark_page(void)
+{
+    const uint32_t pages = 200;
+    static Frame frame;
+    fillFrame(frame, 3);
+
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n=0;n<pages;n++) {bytes += legacyPage(frame, true, true).length();}
+    float stringUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / pages;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t n=0;n<pages;n++) {bytes -= streamedPage(frame, true, true, 1460).length();}
+    float streamUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / pages;
+    TEST_ASSERT_EQUAL(0, bytes);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u value page on the host: String %.1f us, streamed %.1f us",
+             (unsigned)Frame::measurements, stringUs, streamUs);
+    TEST_MESSAGE(message);
+    // One integer scaling per value against a digit by digit double walk and a String per value
+    TEST_ASSERT_LESS_THAN(stringUs, streamUs);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_every_code_at_every_scale);
+    RUN_TEST(test_edges_of_the_integer_path);
+    RUN_TEST(test_streamed_page_matches_the_string_page);
+    RUN_TEST(test_benchmark_page);
+    return UNITY_END();
+}
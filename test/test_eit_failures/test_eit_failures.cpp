@@ -0,0 +1,192 @@
+/*!
+ * @file test_eit_failures.cpp
+ * @author Setting-Dawn
+ * @brief Tests of how the acquisition engine handles devices which stop acknowledging.
+ * @details Every electrode reads a level that depends on the current source, so values
+ * read in the wrong excitation, or left over from an earlier one, do not match. A frame
+ * with a failed trigger or read must not be published at all, while a failed switch is
+ * made again before the next excitation settles and costs nothing but the retry.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+
+using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+
+static HostEITRig<Protocol> rig;
+
+/// Makes the ADC of electrodes 0-7 fail its next transaction, from inside its next conversion
+static bool failNextRead = false;
+
+/*! @brief Gets the level of an electrode while a source drives current
+* @param electrode the electrode
+* @param source the electrode the current is sourced into
+* @return the level in ADC codes
+*/
+static float level(uint8_t electrode, int source)
+{
+    // Grows with the distance around the sheet from the source, so differences depend on it
+    uint8_t distance = (electrode + Protocol::electrodes - source) % Protocol::electrodes;
+    return 1000.0f + 4 * distance * distance;
+}
+
+/*! @brief Steps the engine through the steps of one frame
+* @return true if the last step published the frame, which no earlier one may
+*/
+static bool stepFrame(void)
+{
+    for (uint8_t k=0;k+1<Protocol::electrodes;k++) {TEST_ASSERT_FALSE(rig.engine.step());}
+    return rig.engine.step();
+}
+
+/*! @brief Counts the channel conversions of one frame
+* @return the electrodes in a measurement pair of each excitation, summed over the frame
+*/
+static uint32_t frameConversions(void)
+{
+    uint32_t conversions = 0;
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        const EITExcitation& exc = Protocol::table.excitation[k];
+        bool used[Protocol::electrodes] {};
+        for (uint8_t i=0;i<exc.count;i++)
+        {
+            used[Protocol::table.measurement[exc.first + i].plus] = true;
+            used[Protocol::table.measurement[exc.first + i].minus] = true;
+        }
+        for (uint8_t e=0;e<Protocol::electrodes;e++) {conversions += used[e];}
+    }
+    return conversions;
+}
+
+/*! @brief Checks that every value of the published frame was read in its own excitation
+*/
+static void assertValuesCurrent(void)
+{
+    const auto& frame = rig.engine.frame();
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        const EITExcitation& exc = Protocol::table.excitation[k];
+        for (uint8_t i=0;i<exc.count;i++)
+        {
+            const EITMeasurement& pair = Protocol::table.measurement[exc.first + i];
+            float expected = level(pair.plus, exc.source) - level(pair.minus, exc.source);
+            TEST_ASSERT_EQUAL_INT16((int16_t)expected, frame.values[exc.first + i]);
+        }
+    }
+}
+
+void setUp(void)
+{
+    // Start every test on a frame boundary with a good frame published
+    TEST_ASSERT_TRUE(stepFrame());
+}
+
+void tearDown(void) {}
+
+void test_clean_frame_converts_only_measured_channels(void)
+{
+    uint32_t conversions = rig.conversions();
+    EITStats before = rig.engine.getStats();
+    TEST_ASSERT_TRUE(stepFrame());
+
+    const EITStats& stats = rig.engine.getStats();
+    TEST_ASSERT_EQUAL(frameConversions(), rig.conversions() - conversions);
+    TEST_ASSERT_EQUAL(frameConversions(), stats.adcConversions);
+    TEST_ASSERT_EQUAL(0, rig.earlyReads());
+    TEST_ASSERT_EQUAL(before.frames + 1, stats.frames);
+    TEST_ASSERT_EQUAL(before.failedSteps, stats.failedSteps);
+    TEST_ASSERT_EQUAL(before.droppedFrames, stats.droppedFrames);
+    TEST_ASSERT_EQUAL(stats.frames, rig.engine.frame().sequence);
+    assertValuesCurrent();
+}
+
+void test_failed_trigger_drops_the_frame(void)
+{
+    uint32_t sequence = rig.engine.frame().sequence;
+    uint32_t conversions = rig.conversions();
+    EITStats before = rig.engine.getStats();
+
+    // The first transaction of the frame with the second ADC is its trigger
+    rig.adc[1].failures = 1;
+    TEST_ASSERT_FALSE(stepFrame());
+
+    const EITStats& stats = rig.engine.getStats();
+    TEST_ASSERT_EQUAL(before.failedSteps + 1, stats.failedSteps);
+    TEST_ASSERT_EQUAL(before.droppedFrames + 1, stats.droppedFrames);
+    TEST_ASSERT_EQUAL(before.frames, stats.frames);
+    TEST_ASSERT_EQUAL(sequence, rig.engine.frame().sequence);
+    // Only the round which never started is missing, and no results were read from it
+    TEST_ASSERT_LESS_THAN(frameConversions(), rig.conversions() - conversions);
+    TEST_ASSERT_EQUAL(0, rig.earlyReads());
+
+    // The next frame is read in full again
+    TEST_ASSERT_TRUE(stepFrame());
+    TEST_ASSERT_EQUAL(sequence + 1, rig.engine.frame().sequence);
+    assertValuesCurrent();
+}
+
+void test_failed_read_drops_the_frame(void)
+{
+    uint32_t sequence = rig.engine.frame().sequence;
+    EITStats before = rig.engine.getStats();
+
+    // The busy status read after the first conversion of the frame is not acknowledged
+    failNextRead = true;
+    TEST_ASSERT_FALSE(stepFrame());
+    TEST_ASSERT_FALSE(failNextRead);
+
+    const EITStats& stats = rig.engine.getStats();
+    TEST_ASSERT_EQUAL(before.failedSteps + 1, stats.failedSteps);
+    TEST_ASSERT_EQUAL(before.droppedFrames + 1, stats.droppedFrames);
+    TEST_ASSERT_EQUAL(before.frames, stats.frames);
+    TEST_ASSERT_EQUAL(sequence, rig.engine.frame().sequence);
+
+    TEST_ASSERT_TRUE(stepFrame());
+    TEST_ASSERT_EQUAL(sequence + 1, rig.engine.frame().sequence);
+    assertValuesCurrent();
+}
+
+void test_failed_switch_is_made_again(void)
+{
+    uint32_t sequence = rig.engine.frame().sequence;
+    EITStats before = rig.engine.getStats();
+
+    // The switch to the second excitation is not acknowledged, so the first source stays on
+    rig.pca[0].failures = 1;
+    TEST_ASSERT_FALSE(rig.engine.step());
+    TEST_ASSERT_EQUAL(Protocol::table.excitation[0].source, rig.source());
+    TEST_ASSERT_EQUAL(before.failedSteps + 1, rig.engine.getStats().failedSteps);
+
+    // The next step makes it again before reading, so the frame is still whole
+    TEST_ASSERT_FALSE(rig.engine.step());
+    TEST_ASSERT_EQUAL(Protocol::table.excitation[2].source, rig.source());
+    for (uint8_t k=2;k+1<Protocol::electrodes;k++) {TEST_ASSERT_FALSE(rig.engine.step());}
+    TEST_ASSERT_TRUE(rig.engine.step());
+
+    const EITStats& stats = rig.engine.getStats();
+    TEST_ASSERT_EQUAL(before.failedSteps + 1, stats.failedSteps);
+    TEST_ASSERT_EQUAL(before.droppedFrames, stats.droppedFrames);
+    TEST_ASSERT_EQUAL(sequence + 1, rig.engine.frame().sequence);
+    assertValuesCurrent();
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+    rig.setLevels([] (uint8_t e) {
+        if (failNextRead && e < 8) {rig.adc[0].failures = 1; failNextRead = false;}
+        return level(e, rig.source());
+    });
+    if (!rig.begin()) {return 1;}
+
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_frame_converts_only_measured_channels);
+    RUN_TEST(test_failed_trigger_drops_the_frame);
+    RUN_TEST(test_failed_read_drops_the_frame);
+    RUN_TEST(test_failed_switch_is_made_again);
+    return UNITY_END();
+}
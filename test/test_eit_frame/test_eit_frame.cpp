@@ -0,0 +1,151 @@
+/*!
+ * @file test_eit_frame.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the integer frame and a benchmark against the double arrays it replaced.
+ * @details The old path converted every ADC reading to volts in a double, subtracted the
+ * doubles into measure[208] and copied them into publish[208] as floats. The frame keeps
+ * code differences in int16_t and one scale, converting to volts only where asked. On the
+ * host both run in hardware; on the ESP32, which has no double precision unit, the old
+ * path also paid for software emulation of every double operation.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include "ADC128D818Bulk.h"
+#include "EITprotocol.h"
+#include "EITframe.h"
+
+using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+using Frame = EITFrame<Protocol>;
+
+static const float VOLTS_PER_CODE = ADC128D818_INTERNAL_REF_V / 4096.0f;
+
+/// The arrays of the old reading task
+struct DoubleFrame {
+    double measure[Protocol::measurements];
+    float publish[Protocol::measurements];
+};
+
+/// ADC codes of every electrode in every excitation
+static uint16_t codes[Protocol::electrodes][Protocol::electrodes];
+
+/*! @brief Computes a frame the old way, in volts in doubles
+* @param frame receives the voltage differences
+*/
+static void processDouble(DoubleFrame& frame)
+{
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        double cycleVals[Protocol::electrodes];
+        for (uint8_t e=0;e<Protocol::electrodes;e++) {cycleVals[e] = codes[k][e] * (2.56 / 4096.0);}
+        const EITExcitation& exc = Protocol::table.excitation[k];
+        for (uint8_t i=0;i<exc.count;i++)
+        {
+            const EITMeasurement& pair = Protocol::table.measurement[exc.first + i];
+            frame.measure[exc.first + i] = cycleVals[pair.plus] - cycleVals[pair.minus];
+        }
+    }
+    for (uint16_t n=0;n<Protocol::measurements;n++) {frame.publish[n] = frame.measure[n];}
+}
+
+/*! @brief Computes a frame as the engine does, in code differences
+* @param frame receives the voltage differences
+*/
+static void processInt(Frame& frame)
+{
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        const EITExcitation& exc = Protocol::table.excitation[k];
+        const EITMeasurement* pair = &Protocol::table.measurement[exc.first];
+        int16_t* out = &frame.values[exc.first];
+        for (uint8_t i=0;i<exc.count;i++) {out[i] = (int16_t)codes[k][pair[i].plus] - (int16_t)codes[k][pair[i].minus];}
+    }
+    frame.scale = VOLTS_PER_CODE;
+}
+
+/*! @brief Times a number of frames
+* @param frames frames to compute and copy
+* @param work computes and copies one frame
+* @return nanoseconds per frame
+*/
+template <typename WORK>
+static float timeFrames(uint32_t frames, WORK work)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n=0;n<frames;n++) {work();}
+    return std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+void setUp(void)
+{
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> code(0, 4095);
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        for (uint8_t e=0;e<Protocol::electrodes;e++) {codes[k][e] = code(random);}
+    }
+}
+
+void tearDown(void) {}
+
+void test_frame_is_a_quarter_of_the_doubles(void)
+{
+    TEST_ASSERT_EQUAL(208, Frame::measurements);
+    TEST_ASSERT_EQUAL(416, sizeof(Frame::values));
+    TEST_ASSERT_LESS_OR_EQUAL(416 + 16, sizeof(Frame));
+    TEST_ASSERT_EQUAL(1664, sizeof(DoubleFrame::measure));
+    TEST_ASSERT_LESS_THAN(sizeof(DoubleFrame) / 4, sizeof(Frame));
+}
+
+void test_volts_match_the_doubles(void)
+{
+    static Frame frame;
+    static DoubleFrame legacy;
+    processInt(frame);
+    processDouble(legacy);
+    for (uint16_t n=0;n<Frame::measurements;n++)
+    {
+        // The same code difference, scaled in float rather than double
+        TEST_ASSERT_EQUAL_FLOAT(legacy.publish[n], frame.volts(n));
+    }
+}
+
+void test_benchmark_frame(void)
+{
+    const uint32_t frames = 20000;
+    static Frame frame, published;
+    static DoubleFrame legacy, legacyPublished;
+
+    float intNs = timeFrames(frames, [] () {
+        processInt(frame);
+        published = frame;
+        asm volatile("" : : "r"(&published) : "memory"); // Keeps every frame
+    });
+    float doubleNs = timeFrames(frames, [] () {
+        processDouble(legacy);
+        legacyPublished = legacy;
+        asm volatile("" : : "r"(&legacyPublished) : "memory");
+    });
+
+    char message[160];
+    snprintf(message, sizeof(message), "Process and publish one %u value frame on the host: int16 %.0f ns, %u bytes; "
+             "double %.0f ns, %u bytes", (unsigned)Frame::measurements, intNs, (unsigned)sizeof(Frame),
+             doubleNs, (unsigned)sizeof(DoubleFrame));
+    TEST_MESSAGE(message);
+    // A few hundred subtractions and a copy either way
+    TEST_ASSERT_LESS_THAN(100000, (int)intNs);
+    TEST_ASSERT_LESS_THAN(100000, (int)doubleNs);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_is_a_quarter_of_the_doubles);
+    RUN_TEST(test_volts_match_the_doubles);
+    RUN_TEST(test_benchmark_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,166 @@
+/*!
+ * @file test_eit_interleave.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the per-frame read timing of the acquisition engine, with and without interleaved reads.
+ * @details The simulated ADCs take the datasheet conversion time per enabled channel and
+ * report busy until their round is over, on the simulated clock. Both ADCs are triggered
+ * back to back; interleaved, the one with fewer channels to convert is read while the
+ * other is still converting, so its transfer is hidden behind the longer round.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+
+using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+using Engine = HostEITRig<Protocol>::Engine;
+
+static HostEITRig<Protocol> rig;
+
+/**
+ * @struct FrameTiming
+ * @brief What one frame's steps took, as measured step by step and as reported for the frame.
+ */
+struct FrameTiming {
+    uint32_t stepReadUs;  ///< Sum of readUs over the frame's steps
+    EITStats stats;       ///< The engine's statistics once the frame completed
+    uint32_t conversions; ///< Channel conversions the simulated ADCs made
+    uint32_t earlyReads;  ///< Result reads of a simulated ADC while it was still converting
+    int16_t values[Protocol::measurements];
+};
+
+/*! @brief Runs one whole frame, summing the read time of its steps
+* @return the timing of the frame
+*/
+static FrameTiming runFrame(void)
+{
+    FrameTiming timing = {};
+    uint32_t conversions = rig.conversions();
+    uint32_t early = rig.earlyReads();
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        bool complete = rig.engine.step();
+        timing.stepReadUs += rig.engine.getStats().readUs;
+        TEST_ASSERT_EQUAL(k == Protocol::electrodes - 1, complete);
+    }
+    timing.stats = rig.engine.getStats();
+    timing.conversions = rig.conversions() - conversions;
+    timing.earlyReads = rig.earlyReads() - early;
+    memcpy(timing.values, rig.engine.frame().values, sizeof(timing.values));
+    return timing;
+}
+
+/*! @brief Reports the read timing of a frame
+* @param label how the frame was read
+* @param timing the frame
+*/
+static void report(const char* label, const FrameTiming& timing)
+{
+    char message[160];
+    snprintf(message, sizeof(message), "%-11s frame %6lu us, reads %5lu us, %lu conversions in %lu rounds, %lu busy polls",
+             label, (unsigned long)timing.stats.frameUs, (unsigned long)timing.stats.frameReadUs,
+             (unsigned long)timing.stats.adcConversions, (unsigned long)timing.stats.adcRounds,
+             (unsigned long)timing.stats.busyPolls);
+    TEST_MESSAGE(message);
+}
+
+/*! @brief Sets how the ADCs are read and runs a frame to start from a clean one
+* @param interleaved true to read each ADC as soon as its own round is due
+*/
+static void readMode(bool interleaved)
+{
+    rig.engine.setInterleavedReads(interleaved);
+    runFrame();
+}
+
+void setUp(void)
+{
+    for (SimulatedADC128D818& adc : rig.adc) {adc.conversionUs = ADC128D818_CHANNEL_CONVERSION_US;}
+}
+void tearDown(void) {}
+
+void test_frame_stats_add_up_the_steps(void)
+{
+    for (bool interleaved : {false, true})
+    {
+        readMode(interleaved);
+        FrameTiming timing = runFrame();
+        report(interleaved ? "Interleaved" : "Sequential", timing);
+        TEST_ASSERT_EQUAL(timing.stepReadUs, timing.stats.frameReadUs);
+        TEST_ASSERT_EQUAL(timing.conversions, timing.stats.adcConversions);
+        // Without oversampling every excitation converts one round on all ADCs at once
+        TEST_ASSERT_EQUAL(Protocol::electrodes, timing.stats.adcRounds);
+        // The engine waits out each round as the datasheet gives it, so it never has to poll
+        TEST_ASSERT_EQUAL(0, timing.stats.busyPolls);
+        TEST_ASSERT_EQUAL(0, timing.earlyReads);
+    }
+}
+
+void test_interleaved_reads_hide_transfers_behind_conversions(void)
+{
+    readMode(false);
+    FrameTiming sequential = runFrame();
+    readMode(true);
+    FrameTiming interleaved = runFrame();
+
+    // Same codes either way
+    TEST_ASSERT_EQUAL_INT16_ARRAY(sequential.values, interleaved.values, Protocol::measurements);
+    TEST_ASSERT_EQUAL(sequential.conversions, interleaved.conversions);
+
+    // Every step whose ADCs convert different numbers of channels reads the shorter one
+    // while the longer converts, saving at least the read of its results
+    uint32_t unequal = 0;
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        const EITExcitation& exc = Protocol::table.excitation[k];
+        bool used[Protocol::electrodes] {};
+        for (uint8_t i=0;i<exc.count;i++)
+        {
+            used[Protocol::table.measurement[exc.first + i].plus] = true;
+            used[Protocol::table.measurement[exc.first + i].minus] = true;
+        }
+        uint8_t converted[Engine::adcCount] = {};
+        for (uint8_t e=0;e<Protocol::electrodes;e++) {converted[e / 8] += used[e];}
+        if (converted[0] != converted[1]) {unequal++;}
+    }
+    TEST_ASSERT_GREATER_THAN(0, unequal);
+    uint32_t saved = sequential.stats.frameReadUs - interleaved.stats.frameReadUs;
+    char message[96];
+    snprintf(message, sizeof(message), "Interleaving saved %lu us a frame over %lu unequal steps",
+             (unsigned long)saved, (unsigned long)unequal);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN(sequential.stats.frameReadUs, interleaved.stats.frameReadUs);
+    // A result read is 2 address bytes, the pointer and 2 bytes a channel at 400 kHz, over 100 us
+    TEST_ASSERT_GREATER_OR_EQUAL(unequal * 100, saved);
+    TEST_ASSERT_EQUAL(sequential.stats.frameUs - saved, interleaved.stats.frameUs);
+}
+
+void test_slow_conversions_are_polled_not_read_early(void)
+{
+    // ADCs 10% slower than the datasheet are still busy when their rounds are due
+    for (SimulatedADC128D818& adc : rig.adc) {adc.conversionUs = ADC128D818_CHANNEL_CONVERSION_US * 11 / 10;}
+    for (bool interleaved : {false, true})
+    {
+        readMode(interleaved);
+        FrameTiming timing = runFrame();
+        report(interleaved ? "Interleaved" : "Sequential", timing);
+        TEST_ASSERT_GREATER_THAN(0, timing.stats.busyPolls);
+        TEST_ASSERT_EQUAL(0, timing.earlyReads);
+        TEST_ASSERT_EQUAL(timing.stepReadUs, timing.stats.frameReadUs);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+    rig.setLevels([] (uint8_t e) {return 1000.0f + 100 * e;});
+    if (!rig.begin()) {return 1;}
+
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_stats_add_up_the_steps);
+    RUN_TEST(test_interleaved_reads_hide_transfers_behind_conversions);
+    RUN_TEST(test_slow_conversions_are_polled_not_read_early);
+    return UNITY_END();
+}
@@ -0,0 +1,162 @@
+/*!
+ * @file test_eit_jitter.cpp
+ * @author Setting-Dawn
+ * @brief Runs the acquisition engine's frame schedule on the simulated clock and reports the jitter of every step.
+ * @details The settle timer wakes the reading task EIT_WAKE_LEAD_US before each step is due
+ * and the task busy waits the rest, so a step starts on time as long as the wake is no
+ * later than the lead. The simulated clock adds a chosen latency to every wake, standing in
+ * for the dispatch of esp_timer callbacks and the scheduler, and the start of each step is
+ * compared with its due time.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <random>
+#include <HostEIT.h>
+
+using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+
+static HostEITRig<Protocol> rig;
+
+/// Jitter a step on time may have, the time of the esp_timer_get_time() which ended its busy wait
+static const uint32_t ON_TIME_US = 2 * HOST_TIMER_READ_US;
+
+/**
+ * @struct StepJitter
+ * @brief Jitter of one step of the frame over several frames.
+ */
+struct StepJitter {
+    uint32_t steps;
+    uint64_t totalUs;
+    uint32_t maxUs;
+};
+
+/*! @brief Runs whole frames and collects the jitter of each step
+* @param frames frames to run
+* @param jitter receives the jitter of each step of the frame
+* @param lastFrameMaxUs receives the largest jitter of the last frame's steps
+*/
+static void runFrames(uint32_t frames, StepJitter (&jitter)[Protocol::electrodes], uint32_t& lastFrameMaxUs)
+{
+    memset(jitter, 0, sizeof(jitter));
+    // Frames start with the step of excitation 0, the one switched to by the last frame
+    for (uint32_t n=0;n<frames;n++)
+    {
+        lastFrameMaxUs = 0;
+        for (uint8_t k=0;k<Protocol::electrodes;k++)
+        {
+            rig.engine.step();
+            uint32_t us = rig.engine.getStats().jitterUs;
+            jitter[k].steps++;
+            jitter[k].totalUs += us;
+            if (us > jitter[k].maxUs) {jitter[k].maxUs = us;}
+            if (us > lastFrameMaxUs) {lastFrameMaxUs = us;}
+        }
+    }
+}
+
+/*! @brief Reports the mean and largest jitter of every step
+* @param label the wake latency the frames ran with
+* @param jitter the jitter of each step
+*/
+static void report(const char* label, const StepJitter (&jitter)[Protocol::electrodes])
+{
+    TEST_MESSAGE(label);
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        char message[96];
+        snprintf(message, sizeof(message), "  step %2u: jitter mean %6.1f us, max %4lu us over %lu steps", k,
+                 (double)jitter[k].totalUs / jitter[k].steps, (unsigned long)jitter[k].maxUs, (unsigned long)jitter[k].steps);
+        TEST_MESSAGE(message);
+    }
+}
+
+void setUp(void)
+{
+    HOST_setWakeLatency(nullptr);
+    // Frames must complete before the runner starts counting steps
+    rig.frames(1);
+}
+
+void tearDown(void) {HOST_setWakeLatency(nullptr);}
+
+void test_steps_start_on_time_without_wake_latency(void)
+{
+    StepJitter jitter[Protocol::electrodes];
+    uint32_t frameMax;
+    runFrames(4, jitter, frameMax);
+    for (const StepJitter& step : jitter) {TEST_ASSERT_LESS_OR_EQUAL(ON_TIME_US, step.maxUs);}
+    TEST_ASSERT_EQUAL(frameMax, rig.engine.getStats().maxJitterUs);
+    TEST_ASSERT_EQUAL(0, rig.engine.getStats().lateSteps);
+}
+
+void test_wake_latency_within_the_lead_is_absorbed(void)
+{
+    std::mt19937 random(16);
+    std::uniform_int_distribution<uint32_t> latency(0, EIT_WAKE_LEAD_US - 10);
+    HOST_setWakeLatency([&] () {return latency(random);});
+
+    StepJitter jitter[Protocol::electrodes];
+    uint32_t frameMax;
+    runFrames(8, jitter, frameMax);
+    report("Wake latency uniform 0-90 us", jitter);
+    for (const StepJitter& step : jitter) {TEST_ASSERT_LESS_OR_EQUAL(ON_TIME_US, step.maxUs);}
+}
+
+void test_wake_latency_beyond_the_lead_is_reported(void)
+{
+    const uint32_t LATENCY_US = 250;
+    HOST_setWakeLatency([] () {return LATENCY_US;});
+
+    StepJitter jitter[Protocol::electrodes];
+    uint32_t frameMax;
+    runFrames(4, jitter, frameMax);
+    // Every step starts as late as the wake is beyond the lead
+    for (const StepJitter& step : jitter)
+    {
+        TEST_ASSERT_UINT32_WITHIN(ON_TIME_US, LATENCY_US - EIT_WAKE_LEAD_US, step.maxUs);
+        TEST_ASSERT_UINT32_WITHIN(ON_TIME_US, LATENCY_US - EIT_WAKE_LEAD_US, (uint32_t)(step.totalUs / step.steps));
+    }
+    TEST_ASSERT_EQUAL(frameMax, rig.engine.getStats().maxJitterUs);
+    // Late wakes delay the reads, but every step is still switched in time to settle
+    TEST_ASSERT_EQUAL(0, rig.engine.getStats().lateSteps);
+}
+
+void test_jitter_per_step_with_occasional_long_wakes(void)
+{
+    // Mostly quick wakes, with one in fifty delayed by up to 400 us by another task
+    std::mt19937 random(507);
+    std::uniform_int_distribution<uint32_t> quick(0, 60);
+    std::uniform_int_distribution<uint32_t> slow(0, 400);
+    std::uniform_int_distribution<uint32_t> which(0, 49);
+    HOST_setWakeLatency([&] () {return which(random) == 0 ? slow(random) : quick(random);});
+
+    StepJitter jitter[Protocol::electrodes];
+    uint32_t frameMax;
+    runFrames(20, jitter, frameMax);
+    report("Wake latency 0-60 us, 1 in 50 up to 400 us", jitter);
+
+    uint32_t worst = 0;
+    for (const StepJitter& step : jitter)
+    {
+        TEST_ASSERT_LESS_OR_EQUAL(400 - EIT_WAKE_LEAD_US + ON_TIME_US, step.maxUs);
+        if (step.maxUs > worst) {worst = step.maxUs;}
+    }
+    TEST_ASSERT_GREATER_THAN(ON_TIME_US, worst);
+    TEST_ASSERT_EQUAL(frameMax, rig.engine.getStats().maxJitterUs);
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+    rig.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_steps_start_on_time_without_wake_latency);
+    RUN_TEST(test_wake_latency_within_the_lead_is_absorbed);
+    RUN_TEST(test_wake_latency_beyond_the_lead_is_reported);
+    RUN_TEST(test_jitter_per_step_with_occasional_long_wakes);
+    return UNITY_END();
+}
@@ -0,0 +1,104 @@
+/*!
+ * @file test_eit_noise.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the oversampling noise floor against ADCs with known gaussian noise.
+ * @details With 2^6 rounds per excitation, the decimated codes should have the noise of
+ * one conversion, plus its quantization noise of 1/12 code squared, divided by 64. Near
+ * full scale the sums of squared codes need more than the 24 bits of a float, so codes
+ * alternating by one there check that the variance is computed exactly.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+
+using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+
+static HostEITRig<Protocol> rig;
+
+/// Volts of one ADC code
+static const float VOLTS_PER_CODE = ADC128D818_INTERNAL_REF_V / 4096.0f;
+
+/*! @brief Gets the noise floor the engine should report
+* @param sigma noise of one conversion in codes
+* @param shift log2 of the rounds averaged
+* @return the noise floor in microvolts
+*/
+static float expectedFloorUv(float sigma, uint8_t shift)
+{
+    return sqrtf((sigma * sigma + 1.0f / 12) / (1 << shift)) * VOLTS_PER_CODE * 1e6f;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_noise_floor_mid_scale(void)
+{
+    rig.setLevels([] (uint8_t e) {return 1000.3f + 10 * e;});
+    rig.setNoise(2.0f);
+    rig.frames(2);
+    float expected = expectedFloorUv(2.0f, 6);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f * expected, expected, rig.engine.getStats().noiseFloorUv);
+}
+
+void test_noise_floor_near_full_scale(void)
+{
+    rig.setLevels([] (uint8_t e) {return 4000.3f + e;});
+    rig.setNoise(1.0f);
+    rig.frames(2);
+    float expected = expectedFloorUv(1.0f, 6);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * expected, expected, rig.engine.getStats().noiseFloorUv);
+}
+
+void test_alternating_codes_at_full_scale(void)
+{
+    // Every electrode reads 4094 and 4095 in turn, so each excitation's 64 rounds split
+    // evenly: a sample variance of 0.25 * 64/63, which rounding the squared sums to floats
+    // would lose entirely
+    static uint32_t conversions[Protocol::electrodes];
+    rig.setLevels([] (uint8_t e) {return 4094.0f + (conversions[e]++ & 1);});
+    rig.setNoise(0.0f);
+    rig.frames(2);
+    float expected = sqrtf(0.25f / 63) * VOLTS_PER_CODE * 1e6f;
+    TEST_ASSERT_FLOAT_WITHIN(0.001f * expected, expected, rig.engine.getStats().noiseFloorUv);
+}
+
+void test_noiseless_levels_have_no_floor(void)
+{
+    rig.setLevels([] (uint8_t e) {return 4095.0f;});
+    rig.setNoise(0.0f);
+    rig.frames(2);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, rig.engine.getStats().noiseFloorUv);
+}
+
+void test_decimated_codes_keep_the_mean(void)
+{
+    // Three extra bits at 2^6 rounds, so a difference of 5 codes is 40
+    rig.setLevels([] (uint8_t e) {return 2000.0f + 5 * e;});
+    rig.setNoise(0.5f);
+    rig.frames(2);
+    const auto& frame = rig.engine.frame();
+    for (uint16_t n=0;n<frame.measurements;n++)
+    {
+        const EITMeasurement& pair = Protocol::table.measurement[n];
+        float expected = 40.0f * ((int)pair.plus - (int)pair.minus);
+        TEST_ASSERT_FLOAT_WITHIN(4.0f, expected, (float)frame.values[n]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+    rig.engine.setOversampling(6);
+    if (!rig.begin()) {return 1;}
+
+    UNITY_BEGIN();
+    RUN_TEST(test_noise_floor_mid_scale);
+    RUN_TEST(test_noise_floor_near_full_scale);
+    RUN_TEST(test_alternating_codes_at_full_scale);
+    RUN_TEST(test_noiseless_levels_have_no_floor);
+    RUN_TEST(test_decimated_codes_keep_the_mean);
+    return UNITY_END();
+}
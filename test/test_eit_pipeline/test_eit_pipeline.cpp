@@ -0,0 +1,129 @@
+/*!
+ * @file test_eit_pipeline.cpp
+ * @author Setting-Dawn
+ * @brief Measures the frame rate and per-stage timing of the acquisition engine on simulated devices.
+ * @details The ADCs take their datasheet conversion time per enabled channel and every
+ * transaction takes the time its bytes need at its clock, on a simulated clock, so a frame
+ * costs exactly its settle times, conversions and bus transfers. Nothing else may stall
+ * the pipeline: the switch to the next excitation and the processing of the last one must
+ * both fit in the settle time.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+
+using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+
+static HostEITRig<Protocol> rig;
+
+/// What each excitation took before the engine, a 50 ms task delay
+static const uint32_t FIXED_DELAY_FRAME_US = Protocol::electrodes * 50000;
+
+/// Volts of one ADC code with the internal 2.56 V reference
+static const float VOLTS_PER_CODE = ADC128D818_INTERNAL_REF_V / 4096.0f;
+
+/*! @brief Reports the timing of the last frame and step
+* @param label what was run
+*/
+static void report(const char* label)
+{
+    const EITStats& stats = rig.engine.getStats();
+    char message[200];
+    snprintf(message, sizeof(message), "%s: %.2f frames/s, frame %u us, read %u us; last step switch %u us, "
+             "settle %u us, read %u us, process %u us", label, 1e6f / stats.frameUs, stats.frameUs,
+             stats.frameReadUs, stats.switchUs, stats.settleUs, stats.readUs, stats.processUs);
+    TEST_MESSAGE(message);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_frame_is_settling_and_reading_only(void)
+{
+    rig.engine.setSettleTime(EIT_DEFAULT_SETTLE_US);
+    rig.frames(2);
+    report("Default settle time");
+
+    const EITStats& stats = rig.engine.getStats();
+    // Each step waits out its settle time and then converts and reads; the switch and
+    // the processing run inside the settle time, so only bus stalls are left over
+    uint32_t expected = Protocol::electrodes * EIT_DEFAULT_SETTLE_US + stats.frameReadUs;
+    TEST_ASSERT_UINT32_WITHIN(Protocol::electrodes * 100, expected, stats.frameUs);
+    TEST_ASSERT_EQUAL(0, stats.lateSteps);
+    TEST_ASSERT_EQUAL(0, rig.earlyReads());
+    TEST_ASSERT_LESS_THAN(FIXED_DELAY_FRAME_US / 3, stats.frameUs);
+    TEST_ASSERT_GREATER_THAN_FLOAT(4.0f, 1e6f / stats.frameUs);
+}
+
+void test_reads_are_conversion_bound(void)
+{
+    rig.engine.setSettleTime(EIT_DEFAULT_SETTLE_US);
+    rig.frames(2);
+    const EITStats& stats = rig.engine.getStats();
+
+    // The ADCs convert in parallel, so each step reads once the longest round is over
+    uint32_t conversions = 0;
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        const EITExcitation& exc = Protocol::table.excitation[k];
+        uint8_t converted[HostEITRig<Protocol>::Engine::adcCount] = {};
+        bool used[Protocol::electrodes] {};
+        for (uint8_t i=0;i<exc.count;i++)
+        {
+            used[Protocol::table.measurement[exc.first + i].plus] = true;
+            used[Protocol::table.measurement[exc.first + i].minus] = true;
+        }
+        for (uint8_t e=0;e<Protocol::electrodes;e++) {converted[e / 8] += used[e];}
+        uint8_t longest = 0;
+        for (uint8_t count : converted) {longest = max(longest, count);}
+        conversions += longest * ADC128D818_CHANNEL_CONVERSION_US;
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(conversions, stats.frameReadUs);
+    // Triggering, polling and reading the two ADCs at 400 kHz takes under 2 ms a step
+    TEST_ASSERT_LESS_THAN(conversions + Protocol::electrodes * 2000, stats.frameReadUs);
+}
+
+void test_measurements_are_adjacent_differences(void)
+{
+    rig.frames(1);
+    const auto& frame = rig.engine.frame();
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        // Excitation k skips electrodes k and k+1, measuring from k+2 around to k-1
+        for (uint8_t i=0;i<13;i++)
+        {
+            uint8_t minus = (k + 2 + i) % 16;
+            TEST_ASSERT_EQUAL(minus == 15 ? -1500 : 100, frame.values[k*13 + i]);
+        }
+    }
+    TEST_ASSERT_EQUAL(rig.engine.getStats().frames, frame.sequence);
+    TEST_ASSERT_EQUAL_FLOAT(100 * VOLTS_PER_CODE, frame.volts(0));
+}
+
+void test_processing_overlaps_the_settle_time(void)
+{
+    // With no settle time at all every step is late, as the switch is the last thing before the wait
+    rig.engine.setSettleTime(0);
+    rig.frames(2);
+    report("No settle time");
+    const EITStats& stats = rig.engine.getStats();
+    TEST_ASSERT_EQUAL(Protocol::electrodes, stats.lateSteps);
+    TEST_ASSERT_UINT32_WITHIN(Protocol::electrodes * 100, stats.frameReadUs, stats.frameUs);
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+    rig.setLevels([] (uint8_t e) {return 1000.0f + 100 * e;});
+    if (!rig.begin()) {return 1;}
+
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_is_settling_and_reading_only);
+    RUN_TEST(test_reads_are_conversion_bound);
+    RUN_TEST(test_measurements_are_adjacent_differences);
+    RUN_TEST(test_processing_overlaps_the_settle_time);
+    return UNITY_END();
+}
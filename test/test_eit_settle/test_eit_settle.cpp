@@ -0,0 +1,118 @@
+/*!
+ * @file test_eit_settle.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the settle time calibration and of keeping its result in NVS.
+ * @details Every electrode of the simulated sheet approaches its settled level along an
+ * exponential curve after each switch of the current source, with a time constant of its
+ * own for each excitation. The calibration has to find, on its grid of settle times, the
+ * first one at which the curve is within tolerance of the settled level.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+#include "EITsettle.h"
+
+using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+using Engine = HostEITRig<Protocol>::Engine;
+
+static HostEITRig<Protocol> rig;
+
+/// Codes an electrode is off its settled level by straight after a switch
+static const float STEP_CODES = 800.0f;
+
+/*! @brief Gets the time after which an excitation reads within tolerance of settled
+* @details Halfway between two settle times the calibration tries, so the time it finds
+* does not depend on how long triggering a conversion takes.
+* @param index the excitation
+* @return the time in microseconds
+*/
+static uint32_t settledAfterUs(uint8_t index)
+{
+    return EIT_SETTLE_STEP_US * (4 + index) + EIT_SETTLE_STEP_US / 2;
+}
+
+/*! @brief Gets the time constant of the settling curve of an excitation
+* @details A reading rounds to within EIT_SETTLE_TOLERANCE codes of the settled level once
+* the curve has fallen below half a code more than that, which is at settledAfterUs().
+* @param index the excitation
+* @return the time constant in microseconds
+*/
+static float tauUs(uint8_t index)
+{
+    return settledAfterUs(index) / logf(STEP_CODES / (EIT_SETTLE_TOLERANCE + 0.5f));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_calibration_finds_each_settle_time(void)
+{
+    rig.setLevels([] (uint8_t e) {
+        // Excitation k sources current into the electrode after the one it grounds
+        uint8_t excitation = (rig.source() + Protocol::electrodes - 1) % Protocol::electrodes;
+        float sinceUs = HOST_timeUs() - rig.pca[0].ledoutAt;
+        return 1000.0f + 100 * e + STEP_CODES * expf(-sinceUs / tauUs(excitation));
+    });
+    TEST_ASSERT_TRUE(rig.engine.calibrateSettling());
+
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        TEST_ASSERT_EQUAL(settledAfterUs(k) + EIT_SETTLE_STEP_US / 2, rig.engine.getSettleTime(k));
+    }
+
+    // Frames run on from the first excitation, each one waiting out its own time
+    rig.frames(2);
+    TEST_ASSERT_EQUAL(0, rig.engine.getStats().lateSteps);
+    TEST_ASSERT_EQUAL(100, rig.engine.frame().values[0]);
+}
+
+void test_settle_times_survive_a_reboot(void)
+{
+    uint32_t saved[Protocol::electrodes];
+    for (uint8_t k=0;k<Protocol::electrodes;k++) {saved[k] = 1000 + 10 * k;}
+    TEST_ASSERT_TRUE(EITsettle_save(Engine::signature, saved, Protocol::electrodes));
+
+    uint32_t loaded[Protocol::electrodes] = {};
+    TEST_ASSERT_TRUE(EITsettle_load(Engine::signature, loaded, Protocol::electrodes));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(saved, loaded, Protocol::electrodes);
+
+    rig.engine.setSettleTimes(loaded);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(saved, rig.engine.getSettleTimes(), Protocol::electrodes);
+}
+
+void test_settle_times_of_another_protocol_are_rejected(void)
+{
+    uint32_t saved[Protocol::electrodes];
+    for (uint8_t k=0;k<Protocol::electrodes;k++) {saved[k] = 2000 + k;}
+    TEST_ASSERT_TRUE(EITsettle_save(Engine::signature, saved, Protocol::electrodes));
+
+    // Another pattern or electrode count has another signature
+    using Opposite = EITAcquire<EITProtocolOf<16, EITPattern::Opposite>>;
+    using Larger = EITAcquire<EITProtocolOf<32, EITPattern::Adjacent>>;
+    TEST_ASSERT_NOT_EQUAL(Engine::signature, Opposite::signature);
+    TEST_ASSERT_NOT_EQUAL(Engine::signature, Larger::signature);
+
+    // Nothing is written unless the times were stored for this very protocol
+    uint32_t loaded[32];
+    for (uint8_t k=0;k<32;k++) {loaded[k] = 7;}
+    TEST_ASSERT_FALSE(EITsettle_load(Opposite::signature, loaded, Opposite::electrodes));
+    TEST_ASSERT_FALSE(EITsettle_load(Engine::signature, loaded, Protocol::electrodes / 2));
+    TEST_ASSERT_FALSE(EITsettle_load(Engine::signature, loaded, 32));
+    for (uint8_t k=0;k<32;k++) {TEST_ASSERT_EQUAL(7, loaded[k]);}
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+    rig.setLevels([] (uint8_t e) {return 1000.0f + 100 * e;});
+    if (!rig.begin()) {return 1;}
+
+    UNITY_BEGIN();
+    RUN_TEST(test_calibration_finds_each_settle_time);
+    RUN_TEST(test_settle_times_survive_a_reboot);
+    RUN_TEST(test_settle_times_of_another_protocol_are_rejected);
+    return UNITY_END();
+}
@@ -0,0 +1,103 @@
+/*!
+ * @file test_eit_sizes.cpp
+ * @author Setting-Dawn
+ * @brief Runs the acquisition engine with 8, 16 and 32 electrodes on simulated devices.
+ * @details Each size has its own ADCs, banks and a frame sized at compile time, and must
+ * measure every value of its protocol. The frame rate of each
+ * is reported; it falls with the number of measurements, which grows as n(n-3).
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+
+/*! @brief Gets the level of an electrode, which differs between every pair
+* @param electrode the electrode
+* @return the level in ADC codes
+*/
+static float level(uint8_t electrode) {return 200.0f + 100 * electrode;}
+
+/*! @brief Runs two frames of one size and checks every value
+* @param rig the engine, not yet begun
+* @return the frame rate
+*/
+template <typename PROTOCOL>
+static float checkSize(HostEITRig<PROTOCOL>& rig)
+{
+    using Engine = typename HostEITRig<PROTOCOL>::Engine;
+    using Frame = typename Engine::Frame;
+    constexpr uint8_t n = PROTOCOL::electrodes;
+    TEST_ASSERT_EQUAL((n + 7) / 8, Engine::adcCount);
+    TEST_ASSERT_EQUAL((n + 15) / 16, Engine::bankCount);
+    TEST_ASSERT_EQUAL(n * (n - 3), Frame::measurements);
+    TEST_ASSERT_EQUAL(n * (n - 3) * sizeof(int16_t), sizeof(Frame::values));
+    static_assert(sizeof(Frame) < n * (n - 3) * sizeof(int16_t) + 16, "The frame is the values and a short header");
+
+    rig.setLevels(level);
+    TEST_ASSERT_TRUE(rig.begin());
+    rig.frames(2);
+
+    const auto& frame = rig.engine.frame();
+    for (uint16_t m=0;m<frame.measurements;m++)
+    {
+        const EITMeasurement& pair = PROTOCOL::table.measurement[m];
+        TEST_ASSERT_EQUAL(100 * ((int)pair.plus - (int)pair.minus), frame.values[m]);
+    }
+
+    const EITStats& stats = rig.engine.getStats();
+    float rate = 1e6f / stats.frameUs;
+    char message[128];
+    snprintf(message, sizeof(message), "%u electrodes: %u values, %.2f frames/s, %.0f values/s, %u ADC bytes per frame",
+             n, (unsigned)frame.measurements, rate, rate * frame.measurements, stats.adcBytes);
+    TEST_MESSAGE(message);
+    return rate;
+}
+
+static float rate8, rate16, rate32;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_8_electrodes(void)
+{
+    static HostEITRig<EITProtocolOf<8, EITPattern::Adjacent>> rig;
+    rate8 = checkSize(rig);
+}
+
+void test_16_electrodes(void)
+{
+    static HostEITRig<EITProtocolOf<16, EITPattern::Adjacent>> rig;
+    rate16 = checkSize(rig);
+}
+
+void test_32_electrodes(void)
+{
+    static HostEITRig<EITProtocolOf<32, EITPattern::Adjacent>> rig;
+    rate32 = checkSize(rig);
+}
+
+void test_throughput_scales(void)
+{
+    // The ADCs of all banks convert in parallel, so the frame time grows with the
+    // excitations and the channels each ADC converts, not with the number of ADCs,
+    // and larger sheets measure more values per second
+    TEST_ASSERT_GREATER_THAN_FLOAT(rate16, rate8);
+    TEST_ASSERT_GREATER_THAN_FLOAT(rate32, rate16);
+    TEST_ASSERT_GREATER_THAN_FLOAT(1.0f, rate32);
+    TEST_ASSERT_GREATER_THAN_FLOAT(rate8 * 40, rate16 * 208);
+    TEST_ASSERT_GREATER_THAN_FLOAT(rate16 * 208, rate32 * 928);
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_8_electrodes);
+    RUN_TEST(test_16_electrodes);
+    RUN_TEST(test_32_electrodes);
+    RUN_TEST(test_throughput_scales);
+    return UNITY_END();
+}
@@ -0,0 +1,124 @@
+/*!
+ * @file test_imu_burst.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the BNO055 burst read against a simulated sensor.
+ * @details The sensor's register map from 0x14 to 0x35 holds known gyroscope rates, Euler
+ * angles and CALIB_STAT, with filler in the registers between, so a decode reading the
+ * wrong offset gets a wrong value rather than a zero.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <unity.h>
+#include "IMU.h"
+
+/// Raw counts the simulated sensor holds
+static const int16_t GYRO[3] = {100, -200, 0x7FFF};
+static const int16_t EULER[3] = {5760, -160, 480};  // Heading 360, roll -10 and pitch 30 degrees
+static const uint8_t CALIBRATION = 0xE4;            // System 3, gyroscope 2, accelerometer 1, magnetometer 0
+
+/**
+ * @class SimulatedBNO055
+ * @brief A BNO055 with its chip ID and a known page 0 register map.
+ */
+class SimulatedBNO055 : public HostRegisterDevice {
+    public:
+        SimulatedBNO055(void)
+        {
+            registers[0x00] = BNO055_ID;
+            for (uint8_t reg=0x20;reg<BNO055_CALIB_STAT_REG;reg++) {registers[reg] = 0xA5;}
+            for (uint8_t n=0;n<3;n++)
+            {
+                put(0x14 + 2*n, GYRO[n]);
+                put(0x1A + 2*n, EULER[n]);
+            }
+            registers[BNO055_CALIB_STAT_REG] = CALIBRATION;
+        }
+
+        void put(uint8_t reg, int16_t value)
+        {
+            registers[reg] = (uint16_t)value & 0xFF;
+            registers[reg + 1] = (uint16_t)value >> 8;
+        }
+};
+
+static SimulatedBNO055 sensor;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/// Checks every field of a decoded burst against the simulated sensor
+static void assertBurst(const IMUBurst& burst)
+{
+    TEST_ASSERT_EQUAL_INT16(GYRO[0], burst.gyro.x);
+    TEST_ASSERT_EQUAL_INT16(GYRO[1], burst.gyro.y);
+    TEST_ASSERT_EQUAL_INT16(GYRO[2], burst.gyro.z);
+    TEST_ASSERT_EQUAL_INT16(EULER[0], burst.euler.x);
+    TEST_ASSERT_EQUAL_INT16(EULER[1], burst.euler.y);  // Roll
+    TEST_ASSERT_EQUAL_INT16(EULER[2], burst.euler.z);  // Pitch
+    TEST_ASSERT_EQUAL_HEX8(CALIBRATION, burst.calibration);
+}
+
+void test_decode_register_map(void)
+{
+    IMUBurst burst;
+    IMU_decodeBurst(&sensor.registers[BNO055_BURST_FIRST_REG], burst);
+    assertBurst(burst);
+    TEST_ASSERT_EQUAL(0x21, BNO055_CALIB_STAT_REG - BNO055_BURST_FIRST_REG);
+}
+
+void test_read_is_one_transaction(void)
+{
+    TEST_ASSERT_TRUE(IMU_init(&Wire1, 5));
+
+    IMUBurst burst;
+    Wire1.clearCounters();
+    std::vector<HostTwiTransaction>& log = Wire1.startLog();
+    TEST_ASSERT_TRUE(IMU_readBurst(burst));
+    Wire1.stopLog();
+    assertBurst(burst);
+
+    // The register pointer write ends in a repeated start, not a STOP
+    TEST_ASSERT_EQUAL(2, log.size());
+    TEST_ASSERT_FALSE(log[0].read);
+    TEST_ASSERT_FALSE(log[0].stop);
+    TEST_ASSERT_EQUAL(1, log[0].data.size());
+    TEST_ASSERT_EQUAL_HEX8(BNO055_BURST_FIRST_REG, log[0].data[0]);
+    TEST_ASSERT_TRUE(log[1].read);
+    TEST_ASSERT_EQUAL(BNO055_BURST_BYTES, log[1].data.size());
+    TEST_ASSERT_EQUAL(1, Wire1.transactions);
+    // Two address bytes, the register pointer and the data
+    TEST_ASSERT_EQUAL(2 + 1 + BNO055_BURST_BYTES, (uint32_t)Wire1.bytes);
+}
+
+void test_calibration_status(void)
+{
+    TEST_ASSERT_TRUE(IMU_isCalibrated((uint8_t)0xFF));
+    TEST_ASSERT_FALSE(IMU_isCalibrated(CALIBRATION));
+}
+
+void test_read_fails_without_acknowledge(void)
+{
+    IMUBurst burst;
+    sensor.failures = 1;
+    TEST_ASSERT_FALSE(IMU_readBurst(burst));
+    Wire1.attach(BNO055_ADDRESS_A, NULL);
+    TEST_ASSERT_FALSE(IMU_readBurst(burst));
+    Wire1.attach(BNO055_ADDRESS_A, &sensor);
+    TEST_ASSERT_TRUE(IMU_readBurst(burst));
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+    Wire1.attach(BNO055_ADDRESS_A, &sensor);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_decode_register_map);
+    RUN_TEST(test_read_is_one_transaction);
+    RUN_TEST(test_calibration_status);
+    RUN_TEST(test_read_fails_without_acknowledge);
+    return UNITY_END();
+}
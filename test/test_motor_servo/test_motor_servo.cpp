@@ -0,0 +1,189 @@
+/*!
+ * @file test_motor_servo.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the motor servo against a simulated motor, linkage and IMU.
+ * @details The motor's speed follows its PWM duty with a first order lag, and it does not
+ * turn below the duty that overcomes its static friction. The encoder counts its turning
+ * and the platform tilts by it through the linkage, which the IMU samples every 10 ms in
+ * steps of 1/16 degree. A tilt step is settled by the tilt PID driving the motor directly,
+ * as with CONTROL_CASCADED false, and by the cascaded loop setting the servo's position.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <math.h>
+#include "MOTOR.h"
+#include "MotorServo.h"
+#include "Pid.h"
+
+/// Period of the simulated physics, and of the servo, control and IMU cycles, in microseconds
+static const uint32_t PHYSICS_US = 100;
+static const uint32_t SERVO_US = 1000;
+static const uint32_t CONTROL_US = 5000;
+static const uint32_t IMU_US = 10000;
+/// Time each step response is simulated for
+static const uint32_t RESPONSE_US = 3000000;
+
+/// Motor speed at full duty in counts/s, its time constant in seconds and the duty it starts turning at
+static const float MOTOR_FULL_SPEED = 8000.0f;
+static const float MOTOR_TIME_CONSTANT = 0.04f;
+static const float MOTOR_STATIC_DUTY = 25.0f;
+
+/// As in main.cpp
+static const float COUNTS_PER_DEGREE = 18.3f;
+static const float IMU_LSB_PER_DEGREE = 16.0f;
+static const MotorServoGains GAINS = {60.0f, 6000.0f, 0.2f, 2.0f, 0.4f};
+
+struct TiltConfig {
+    static constexpr uint8_t axes = 1;
+    static constexpr float kp = 40.0f;
+    static constexpr float ki = 20.0f;
+    static constexpr float kd = 0.05f;
+    static constexpr float derivativeFilter = 0.5f;
+    static constexpr float outputLimit = 255.0f;
+};
+
+struct CascadeConfig {
+    static constexpr uint8_t axes = 1;
+    static constexpr float kp = 0.25f;
+    static constexpr float ki = 30.0f;
+    static constexpr float kd = 0.0f;
+    static constexpr float derivativeFilter = 1.0f;
+    static constexpr float outputLimit = 15.0f;
+};
+
+/**
+ * @struct SimulatedMotor
+ * @brief A motor on PWM channels 0 and 1 turning an encoder and tilting the platform.
+ */
+struct SimulatedMotor {
+    ESP32Encoder encoder;
+    float speed = 0.0f;    // counts/s
+    float position = 0.0f; // counts
+
+    /*! @brief Advances the motor by one physics step at the duty its channels are driven with
+    */
+    void step(void)
+    {
+        float duty = (float)hostLedcDuty[0] - (float)hostLedcDuty[1];
+        float drive = fabsf(duty) < MOTOR_STATIC_DUTY && fabsf(speed) < 1.0f ? 0.0f : duty / 255.0f * MOTOR_FULL_SPEED;
+        speed += (drive - speed) * (PHYSICS_US * 1e-6f / MOTOR_TIME_CONSTANT);
+        position += speed * PHYSICS_US * 1e-6f;
+        encoder.setCount(lroundf(position));
+    }
+
+    float tilt(void) {return position / COUNTS_PER_DEGREE;}
+};
+
+/*! @brief Quantizes a value to the IMU's steps
+* @param degrees tilt or rate
+* @return the value the IMU reports
+*/
+static float imuRead(float degrees) {return roundf(degrees * IMU_LSB_PER_DEGREE) / IMU_LSB_PER_DEGREE;}
+
+/*! @brief Steps the platform from level to a tilt and times how long it takes to settle
+* @param cascaded true to set the servo's position from the cascaded loop, false to drive the motor from the tilt PID
+* @param setpoint tilt to step to, in degrees
+* @param tolerance error in degrees the tilt must stay within
+* @return the time in seconds after which the tilt stayed settled, or a negative value if it never did
+*/
+static float settlingTime(bool cascaded, float setpoint, float tolerance)
+{
+    SimulatedMotor motor;
+    hostLedcDuty[0] = hostLedcDuty[1] = 0;
+    MotorServo servo (&motor.encoder, 19, 18, 0, 1, GAINS);
+    servo.begin();
+    Pid<float, TiltConfig> tiltPid;
+    Pid<float, CascadeConfig> cascadePid;
+    float tilt = 0.0f;
+    float rate = 0.0f;
+    int32_t target = 0;
+
+    float settledAt = 0.0f;
+    for (uint32_t t=0;t<RESPONSE_US;t+=PHYSICS_US)
+    {
+        if (t % IMU_US == 0)
+        {
+            tilt = imuRead(motor.tilt());
+            rate = imuRead(motor.speed / COUNTS_PER_DEGREE);
+        }
+        if (t % CONTROL_US == 0)
+        {
+            const float sp[] = {setpoint};
+            const float measurement[] = {tilt};
+            const float measuredRate[] = {rate};
+            if (cascaded)
+            {
+                target = lroundf(COUNTS_PER_DEGREE * cascadePid.update(sp, measurement, measuredRate, CONTROL_US * 1e-6f)[0]);
+            }
+            else
+            {
+                float effort = tiltPid.update(sp, measurement, measuredRate, CONTROL_US * 1e-6f)[0];
+                uint8_t pwm = (uint8_t)fabsf(effort);
+                if (effort > 0) {MOTOR_forward(19, 18, 0, 1, pwm);}
+                else if (effort < 0) {MOTOR_reverse(19, 18, 0, 1, pwm);}
+                else {MOTOR_brake(19, 18, 0, 1);}
+            }
+        }
+        if (cascaded && t % SERVO_US == 0) {servo.update(target, SERVO_US * 1e-6f);}
+        motor.step();
+
+        if (fabsf(motor.tilt() - setpoint) > tolerance) {settledAt = -1.0f;}
+        else if (settledAt < 0.0f) {settledAt = t * 1e-6f;}
+    }
+    return settledAt;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_cascade_settles_faster_than_the_single_loop(void)
+{
+    float single = settlingTime(false, 5.0f, 0.25f);
+    float cascade = settlingTime(true, 5.0f, 0.25f);
+    char message[96];
+    snprintf(message, sizeof(message), "Settled within 0.25 degree: single loop %s%.3f s, cascade %.3f s",
+             single < 0.0f ? "never in " : "", single < 0.0f ? RESPONSE_US * 1e-6f : single, cascade);
+    TEST_MESSAGE(message);
+    // Static friction leaves the single loop sticking off the setpoint and slipping past it
+    TEST_ASSERT_TRUE(cascade >= 0.0f);
+    TEST_ASSERT_TRUE(single < 0.0f || cascade < single);
+}
+
+void test_update_without_time_passing_keeps_the_state(void)
+{
+    SimulatedMotor motor;
+    MotorServo servo (&motor.encoder, 19, 18, 0, 1, GAINS);
+    servo.begin();
+    motor.encoder.setCount(3);
+    servo.update(10, 0.001f);
+    MotorServoState before = servo.getState();
+
+    // Neither measures a velocity nor integrates, so repeating them changes nothing
+    motor.encoder.setCount(5);
+    for (uint8_t k=0;k<3;k++)
+    {
+        int16_t zero = servo.update(10, 0.0f);
+        int16_t negative = servo.update(10, -0.001f);
+        TEST_ASSERT_EQUAL_FLOAT(before.velocity, servo.getState().velocity);
+        TEST_ASSERT_TRUE(isfinite(servo.getState().velocity));
+        TEST_ASSERT_EQUAL(zero, negative);
+        TEST_ASSERT_EQUAL(5, servo.getState().position);
+    }
+    TEST_ASSERT_INT_WITHIN(MOTOR_SERVO_MAX_EFFORT, 0, servo.getState().effort);
+
+    // The counts turned meanwhile are measured over the next update
+    servo.update(10, 0.001f);
+    float expected = before.velocity + GAINS.velocityFilter * (2 / 0.001f - before.velocity);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, expected, servo.getState().velocity);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cascade_settles_faster_than_the_single_loop);
+    RUN_TEST(test_update_without_time_passing_keeps_the_state);
+    return UNITY_END();
+}
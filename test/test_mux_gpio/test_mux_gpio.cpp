@@ -0,0 +1,182 @@
+/*!
+ * @file test_mux_gpio.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the multiplexer switching against the simulated GPIO registers.
+ * @details Every write to the W1TS and W1TC registers is logged with the levels it leaves,
+ * so the tests see each state the pins pass through, not just the final one. An enabled
+ * multiplexer must never select a channel other than the one switched to.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+#include "CD74HC4067SM.h"
+
+/// Select pins s0-s3 span both GPIO registers, as on the board
+static const uint8_t SELECT[] = {26, 25, 33, 32};
+/// nE on an output pin, as on a board reworked for gating
+static const uint8_t ENABLE = HOST_ENABLE_PINS[0];
+
+/*! @brief Gets the channel a logged state selects, if the multiplexer is enabled
+* @param write the logged write
+* @param enablePin nE of the multiplexer, or CD74HC4067SM_NO_ENABLE if it is always enabled
+* @return the channel, or -1 while disabled
+*/
+static int connected(const HostGpioWrite& write, uint8_t enablePin)
+{
+    if (enablePin != CD74HC4067SM_NO_ENABLE && (write.out[enablePin / 32] >> (enablePin % 32)) & 1) {return -1;}
+    int channel = 0;
+    for (uint8_t k=0;k<4;k++) {channel |= ((write.out[SELECT[k] / 32] >> (SELECT[k] % 32)) & 1) << k;}
+    return channel;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_pins_are_outputs(void)
+{
+    CD74HC4067SM mux(SELECT[0], SELECT[1], SELECT[2], SELECT[3], ENABLE);
+    TEST_ASSERT_EQUAL(OUTPUT, hostPinMode[ENABLE]);
+    for (uint8_t k=0;k<4;k++) {TEST_ASSERT_EQUAL(OUTPUT, hostPinMode[SELECT[k]]);}
+}
+
+void test_gated_switch_never_connects_another_channel(void)
+{
+    CD74HC4067SM mux(SELECT[0], SELECT[1], SELECT[2], SELECT[3], ENABLE);
+    for (uint8_t from=0;from<16;from++)
+    {
+        for (uint8_t to=0;to<16;to++)
+        {
+            mux.switchPin(from, true);
+            std::vector<HostGpioWrite>& log = HOST_startGpioLog();
+            mux.switchPin(to, true);
+            HOST_stopGpioLog();
+
+            // Disable, clear and set the select pins in each register that has any, enable
+            TEST_ASSERT_LESS_OR_EQUAL(6, log.size());
+            TEST_ASSERT_EQUAL(-1, connected(log.front(), ENABLE));
+            TEST_ASSERT_EQUAL(to, connected(log.back(), ENABLE));
+            for (size_t w=0;w+1<log.size();w++) {TEST_ASSERT_EQUAL(-1, connected(log[w], ENABLE));}
+        }
+    }
+}
+
+void test_ungated_switch_passes_through_other_channels(void)
+{
+    // From 7 to 8 the select pins are cleared to 0 before 8 is set, so channel 0 is
+    // connected in between; this is why the engine gates every switch
+    CD74HC4067SM mux(SELECT[0], SELECT[1], SELECT[2], SELECT[3], ENABLE);
+    mux.switchPin(7, true);
+    std::vector<HostGpioWrite>& log = HOST_startGpioLog();
+    mux.switchPin(8);
+    HOST_stopGpioLog();
+
+    bool other = false;
+    for (const HostGpioWrite& write : log)
+    {
+        int channel = connected(write, ENABLE);
+        if (channel != 7 && channel != 8) {other = true;}
+    }
+    TEST_ASSERT_TRUE(other);
+    TEST_ASSERT_EQUAL(8, connected(log.back(), ENABLE));
+}
+
+/*! @brief Steps an engine through a frame and checks every state its multiplexers pass through
+* @details The electrodes grounded by an enabled multiplexer, with repeats dropped, must be
+* exactly the sinks of the excitations in frame order, with never two banks enabled at once.
+* @param rig the engine, begun
+*/
+template <typename PROTOCOL>
+static void checkFrameSinks(HostEITRig<PROTOCOL>& rig)
+{
+    constexpr uint8_t electrodes = PROTOCOL::electrodes;
+    constexpr uint8_t banks = HostEITRig<PROTOCOL>::Engine::bankCount;
+    std::vector<HostGpioWrite>& log = HOST_startGpioLog();
+    rig.frames(1);
+    HOST_stopGpioLog();
+
+    std::vector<int> sinks;
+    for (const HostGpioWrite& write : log)
+    {
+        int sink = -1;
+        for (uint8_t b=0;b<banks;b++)
+        {
+            int channel = connected(write, rig.enablePins[b]);
+            if (channel < 0) {continue;}
+            TEST_ASSERT_EQUAL_MESSAGE(-1, sink, "Two banks enabled at once");
+            sink = b * 16 + channel;
+        }
+        if (sink >= 0 && (sinks.empty() || sinks.back() != sink)) {sinks.push_back(sink);}
+    }
+
+    // The frame switches to excitations 1 to electrodes - 1 and back to 0
+    TEST_ASSERT_EQUAL(electrodes, sinks.size());
+    for (uint8_t k=0;k<electrodes;k++)
+    {
+        TEST_ASSERT_EQUAL(PROTOCOL::table.excitation[(k + 1) % electrodes].sink, sinks[k]);
+    }
+}
+
+void test_undriven_enable_is_left_alone(void)
+{
+    // GPI35 is input only; the multiplexer must not configure or write it
+    CD74HC4067SM mux(SELECT[0], SELECT[1], SELECT[2], SELECT[3], CD74HC4067SM_NO_ENABLE);
+    TEST_ASSERT_NOT_EQUAL(OUTPUT, hostPinMode[35]);
+    for (uint8_t k=0;k<4;k++) {TEST_ASSERT_EQUAL(OUTPUT, hostPinMode[SELECT[k]]);}
+
+    mux.switchPin(7, true);
+    std::vector<HostGpioWrite>& log = HOST_startGpioLog();
+    mux.switchPin(8, true);
+    mux.disable();
+    mux.enable();
+    HOST_stopGpioLog();
+
+    // Only the select pins are written, so the switch passes through channel 0 ungated
+    TEST_ASSERT_LESS_OR_EQUAL(4, log.size());
+    TEST_ASSERT_EQUAL(8, connected(log.back(), CD74HC4067SM_NO_ENABLE));
+}
+
+void test_board_frame_never_drives_the_enable_pin(void)
+{
+    static HostEITRig<EITProtocolOf<16, EITPattern::Adjacent>> rig;
+    TEST_ASSERT_EQUAL_PTR(HOST_BOARD_ENABLE_PINS, rig.enablePins);
+    TEST_ASSERT_TRUE(rig.begin());
+    TEST_ASSERT_NOT_EQUAL(OUTPUT, hostPinMode[35]);
+
+    std::vector<HostGpioWrite>& log = HOST_startGpioLog();
+    rig.frames(1);
+    HOST_stopGpioLog();
+    TEST_ASSERT_TRUE(log.size() > 0);
+    for (const HostGpioWrite& write : log) {TEST_ASSERT_EQUAL(0, (write.out[35 / 32] >> (35 % 32)) & 1);}
+}
+
+void test_one_bank_frame_grounds_only_the_sinks(void)
+{
+    static HostEITRig<EITProtocolOf<16, EITPattern::Adjacent>> rig(&Wire, HOST_ENABLE_PINS);
+    TEST_ASSERT_TRUE(rig.begin());
+    checkFrameSinks(rig);
+}
+
+void test_two_bank_frame_grounds_only_the_sinks(void)
+{
+    static HostEITRig<EITProtocolOf<32, EITPattern::Adjacent>> rig;
+    TEST_ASSERT_TRUE(rig.begin());
+    checkFrameSinks(rig);
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_pins_are_outputs);
+    RUN_TEST(test_gated_switch_never_connects_another_channel);
+    RUN_TEST(test_ungated_switch_passes_through_other_channels);
+    RUN_TEST(test_undriven_enable_is_left_alone);
+    RUN_TEST(test_board_frame_never_drives_the_enable_pin);
+    RUN_TEST(test_one_bank_frame_grounds_only_the_sinks);
+    RUN_TEST(test_two_bank_frame_grounds_only_the_sinks);
+    return UNITY_END();
+}
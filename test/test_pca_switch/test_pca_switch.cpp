@@ -0,0 +1,135 @@
+/*!
+ * @file test_pca_switch.cpp
+ * @author Setting-Dawn
+ * @brief Tests that every current source switch is one auto-increment write of the LEDOUT registers.
+ * @details The bus logs every transaction, so the tests see exactly what each switch
+ * puts on the bus: the control byte 0x82, LEDOUT0 with auto-increment, and the four
+ * LEDOUT bytes driving only the new source.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <HostEIT.h>
+#include "PCA9956Bulk.h"
+
+/// Control byte of a LEDOUT burst: LEDOUT0 with auto-increment
+static const uint8_t LEDOUT_BURST = PCA9956_LEDOUT0_REG | PCA9956_AUTO_INCREMENT;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/*! @brief Checks that a logged transaction is a LEDOUT burst driving one channel
+* @param write the logged transaction
+* @param address the PCA9956 it should go to
+* @param channel the channel it should turn on, or -1 for none
+*/
+static void assertBurst(const HostTwiTransaction& write, uint8_t address, int channel)
+{
+    TEST_ASSERT_EQUAL_HEX8(address, write.address);
+    TEST_ASSERT_FALSE(write.read);
+    TEST_ASSERT_TRUE(write.stop);
+    TEST_ASSERT_TRUE(write.acknowledged);
+    TEST_ASSERT_EQUAL(1 + PCA9956_BANK_LEDOUT_BYTES, write.data.size());
+    TEST_ASSERT_EQUAL_HEX8(LEDOUT_BURST, write.data[0]);
+    for (uint8_t c=0;c<16;c++)
+    {
+        uint8_t mode = (write.data[1 + c / 4] >> (2 * (c % 4))) & 0x03;
+        TEST_ASSERT_EQUAL(c == channel ? PCA9956_LED_ON : 0, mode);
+    }
+}
+
+void test_write_led_out_is_one_transaction(void)
+{
+    SimulatedPCA9956 pca;
+    Wire.attach(0x01, &pca);
+    PCA9956Bulk driver(&Wire, 0x01);
+    TEST_ASSERT_TRUE(driver.begin(0xFF));
+    driver.clearCounters();
+
+    const uint8_t image[PCA9956_BANK_LEDOUT_BYTES] = {0x00, 0x00, PCA9956_LED_ON << 2, 0x00}; // Channel 9
+    Wire.clearCounters();
+    std::vector<HostTwiTransaction>& log = Wire.startLog();
+    TEST_ASSERT_TRUE(driver.writeLedOut(image));
+    Wire.stopLog();
+
+    TEST_ASSERT_EQUAL(1, log.size());
+    assertBurst(log[0], 0x01, 9);
+    TEST_ASSERT_EQUAL(1, Wire.transactions);
+    TEST_ASSERT_EQUAL(PCA9956_LEDOUT_WRITE_BYTES, (uint32_t)Wire.bytes);
+    TEST_ASSERT_EQUAL(1, driver.getTransactions());
+    TEST_ASSERT_EQUAL(PCA9956_LEDOUT_WRITE_BYTES, driver.getBytes());
+    TEST_ASSERT_EQUAL(9, pca.source());
+    Wire.attach(0x01, NULL);
+}
+
+void test_each_switch_of_a_frame_is_one_burst(void)
+{
+    using Protocol = EITProtocolOf<16, EITPattern::Adjacent>;
+    static HostEITRig<Protocol> rig;
+    TEST_ASSERT_TRUE(rig.begin());
+
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        std::vector<HostTwiTransaction>& log = Wire.startLog();
+        rig.engine.step();
+        Wire.stopLog();
+
+        // Only ADC traffic besides the one burst to the PCA9956
+        uint8_t next = (k + 1) % Protocol::electrodes;
+        std::vector<const HostTwiTransaction*> bursts;
+        for (const HostTwiTransaction& t : log)
+        {
+            if (t.address == HOST_PCA_ADDRESSES[0]) {bursts.push_back(&t);}
+        }
+        TEST_ASSERT_EQUAL(1, bursts.size());
+        assertBurst(*bursts[0], HOST_PCA_ADDRESSES[0], Protocol::table.excitation[next].source);
+        TEST_ASSERT_EQUAL(Protocol::table.excitation[next].source, rig.source());
+    }
+    TEST_ASSERT_EQUAL(1, rig.engine.getStats().frames);
+    TEST_ASSERT_EQUAL(Protocol::electrodes, rig.engine.getStats().pcaTransactions);
+    TEST_ASSERT_EQUAL(Protocol::electrodes * PCA9956_LEDOUT_WRITE_BYTES, rig.engine.getStats().pcaBytes);
+}
+
+void test_bank_change_turns_off_the_old_bank_first(void)
+{
+    using Protocol = EITProtocolOf<32, EITPattern::Adjacent>;
+    static HostEITRig<Protocol> rig(&Wire1);
+    TEST_ASSERT_TRUE(rig.begin());
+
+    uint32_t bursts = 0;
+    for (uint8_t k=0;k<Protocol::electrodes;k++)
+    {
+        std::vector<HostTwiTransaction>& log = Wire1.startLog();
+        rig.engine.step();
+        Wire1.stopLog();
+
+        uint8_t next = (k + 1) % Protocol::electrodes;
+        uint8_t bank = Protocol::table.excitation[next].source / 16;
+        uint8_t previous = Protocol::table.excitation[k].source / 16;
+        std::vector<const HostTwiTransaction*> writes;
+        for (const HostTwiTransaction& t : log)
+        {
+            if (t.address == HOST_PCA_ADDRESSES[0] || t.address == HOST_PCA_ADDRESSES[1]) {writes.push_back(&t);}
+        }
+        // The old bank is turned off before the new source is turned on, one burst each
+        TEST_ASSERT_EQUAL(bank == previous ? 1 : 2, writes.size());
+        if (bank != previous) {assertBurst(*writes[0], HOST_PCA_ADDRESSES[previous], -1);}
+        assertBurst(*writes.back(), HOST_PCA_ADDRESSES[bank], Protocol::table.excitation[next].source % 16);
+        TEST_ASSERT_EQUAL(Protocol::table.excitation[next].source, rig.source());
+        bursts += writes.size();
+    }
+    TEST_ASSERT_EQUAL(bursts, rig.engine.getStats().pcaTransactions);
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_write_led_out_is_one_transaction);
+    RUN_TEST(test_each_switch_of_a_frame_is_one_burst);
+    RUN_TEST(test_bank_change_turns_off_the_old_bank_first);
+    return UNITY_END();
+}
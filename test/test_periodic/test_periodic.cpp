@@ -0,0 +1,164 @@
+/*!
+ * @file test_periodic.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the periodic executor's phase, measured dt, overruns and jitter histogram.
+ * @details Cycles run on the simulated clock: their work spends a chosen time, and each
+ * wakeup is made late by a chosen latency, so every dt, overrun and histogram bin the
+ * executor reports can be predicted exactly. Ticks are 1 ms, as on the ESP32.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "Periodic.h"
+
+/// Period and jitter bin of the motor control task
+static const uint32_t PERIOD_US = 5000;
+static const uint32_t BIN_US = 250;
+
+/// Time a cycle takes to read the clock as it ends, which its work includes
+static const uint32_t READ_US = HOST_TIMER_READ_US;
+
+void setUp(void) {HOST_useSimulatedClock(true);}
+void tearDown(void) {HOST_setWakeLatency(nullptr);}
+
+void test_cycles_keep_their_period_whatever_their_work(void)
+{
+    Periodic cycle(PERIOD_US, BIN_US);
+    cycle.begin();
+    int64_t first = HOST_timeUs();
+    for (uint32_t n=0;n<100;n++)
+    {
+        // Work varying from 0.5 to 4.5 ms never moves the next wakeup
+        HOST_spendUs(500 + (n % 5) * 1000);
+        TEST_ASSERT_EQUAL_FLOAT(PERIOD_US * 1e-6f, cycle.wait());
+    }
+
+    PeriodicStats stats;
+    cycle.getStats(stats);
+    TEST_ASSERT_EQUAL(100, stats.cycles);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+    TEST_ASSERT_EQUAL(0, stats.skipped);
+    TEST_ASSERT_EQUAL(PERIOD_US, stats.minDtUs);
+    TEST_ASSERT_EQUAL(PERIOD_US, stats.maxDtUs);
+    TEST_ASSERT_EQUAL(100, stats.jitter[0]);
+    TEST_ASSERT_EQUAL(4500 + READ_US, stats.maxWorkUs);
+    // The 100th cycle starts exactly 100 periods after the first
+    TEST_ASSERT_EQUAL(first + 100 * PERIOD_US, HOST_timeUs());
+}
+
+void test_wake_latency_fills_the_jitter_histogram(void)
+{
+    // Each wake is late by one of these, so dt is the period plus this latency less the last
+    static const uint32_t LATENCY[] = {0, 100, 400, 0, 900, 200, 2100, 0, 600, 1500, 300, 0};
+    const uint32_t CYCLES = sizeof(LATENCY) / sizeof(LATENCY[0]);
+    uint32_t next = 0;
+    HOST_setWakeLatency([&] () {return LATENCY[next++ % CYCLES];});
+
+    Periodic cycle(PERIOD_US, BIN_US);
+    cycle.begin();
+    int64_t first = HOST_timeUs();
+    uint32_t expected[PERIODIC_JITTER_BINS] = {};
+    uint32_t minDt = UINT32_MAX, maxDt = 0;
+    float elapsed = 0;
+    for (uint32_t n=0;n<CYCLES;n++)
+    {
+        HOST_spendUs(1000);
+        float dt = cycle.wait();
+        elapsed += dt;
+
+        int32_t previous = n > 0 ? LATENCY[n - 1] : 0;
+        uint32_t expectedDt = PERIOD_US + LATENCY[n] - previous;
+        TEST_ASSERT_FLOAT_WITHIN(0.5e-6f, expectedDt * 1e-6f, dt);
+        uint32_t jitter = (uint32_t)abs((int32_t)LATENCY[n] - previous);
+        expected[min(jitter / BIN_US, (uint32_t)PERIODIC_JITTER_BINS - 1)]++;
+        minDt = min(minDt, expectedDt);
+        maxDt = max(maxDt, expectedDt);
+    }
+
+    PeriodicStats stats;
+    cycle.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, stats.jitter, PERIODIC_JITTER_BINS);
+    TEST_ASSERT_EQUAL(minDt, stats.minDtUs);
+    TEST_ASSERT_EQUAL(maxDt, stats.maxDtUs);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+    // Late wakes do not shift the grid, and the measured dts add up to the time that passed
+    TEST_ASSERT_EQUAL(first + CYCLES * PERIOD_US + LATENCY[CYCLES - 1], HOST_timeUs());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, (HOST_timeUs() - first) * 1e-6f, elapsed);
+}
+
+void test_overruns_skip_missed_wakeups_and_keep_phase(void)
+{
+    Periodic cycle(PERIOD_US, BIN_US);
+    cycle.begin();
+    int64_t first = HOST_timeUs();
+
+    HOST_spendUs(1000);
+    cycle.wait();
+
+    // Two and a half periods of work miss two wakeups, which are skipped
+    HOST_spendUs(12500);
+    TEST_ASSERT_FLOAT_WITHIN(0.5e-6f, 3 * PERIOD_US * 1e-6f, cycle.wait());
+    PeriodicStats stats;
+    cycle.getStats(stats);
+    TEST_ASSERT_EQUAL(1, stats.overruns);
+    TEST_ASSERT_EQUAL(2, stats.skipped);
+    // Two periods of jitter are beyond the histogram, so the last bin catches them
+    TEST_ASSERT_EQUAL(1, stats.jitter[PERIODIC_JITTER_BINS - 1]);
+    // Back on the grid of the first cycle
+    TEST_ASSERT_EQUAL(first + 4 * PERIOD_US, HOST_timeUs());
+
+    // Work running into the tick the next cycle is due on starts it right away, late by the overrun
+    HOST_spendUs(PERIOD_US);
+    float dt = cycle.wait();
+    cycle.getStats(stats);
+    TEST_ASSERT_EQUAL(2, stats.overruns);
+    TEST_ASSERT_EQUAL(2, stats.skipped);
+    TEST_ASSERT_FLOAT_WITHIN(5e-6f, PERIOD_US * 1e-6f, dt);
+
+    // The cycle after that is due one period after the one it overran into, so it catches up
+    HOST_spendUs(1000);
+    cycle.wait();
+    TEST_ASSERT_EQUAL(first + 6 * PERIOD_US, HOST_timeUs());
+    cycle.getStats(stats);
+    TEST_ASSERT_EQUAL(2, stats.overruns);
+    TEST_ASSERT_EQUAL(4, stats.cycles);
+    TEST_ASSERT_EQUAL(12500 + READ_US, stats.maxWorkUs);
+}
+
+void test_begin_clears_the_statistics(void)
+{
+    Periodic cycle(PERIOD_US, BIN_US);
+    cycle.begin();
+    HOST_spendUs(3 * PERIOD_US);
+    cycle.wait();
+
+    // A pause between begin() calls is not an overrun
+    vTaskDelay(50);
+    cycle.begin();
+    PeriodicStats stats;
+    cycle.getStats(stats);
+    TEST_ASSERT_EQUAL(0, stats.cycles);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+    TEST_ASSERT_EQUAL(PERIOD_US, stats.periodUs);
+    TEST_ASSERT_EQUAL(BIN_US, stats.binUs);
+    HOST_spendUs(1000);
+    cycle.wait();
+    cycle.getStats(stats);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+    TEST_ASSERT_EQUAL(1, stats.cycles);
+    // The first cycle is due a period after the tick begin() was called in
+    TEST_ASSERT_LESS_OR_EQUAL(PERIOD_US, stats.dtUs);
+    TEST_ASSERT_GREATER_THAN(PERIOD_US - 1000, stats.dtUs);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cycles_keep_their_period_whatever_their_work);
+    RUN_TEST(test_wake_latency_fills_the_jitter_histogram);
+    RUN_TEST(test_overruns_skip_missed_wakeups_and_keep_phase);
+    RUN_TEST(test_begin_clears_the_statistics);
+    return UNITY_END();
+}
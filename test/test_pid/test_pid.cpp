@@ -0,0 +1,245 @@
+/*!
+ * @file test_pid.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the Pid controller and the Fixed number type, and a benchmark of their update.
+ * @details Each behaviour is checked in float and in Q16, which must agree to within the
+ * resolution of Q16. The benchmark times the two axis update of the tilt loop's gains on
+ * the host, in nanoseconds and cycles of its time stamp counter; the ratio between float
+ * and Q16 is what carries over to the ESP32.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "Pid.h"
+
+/// The gains of the direct tilt loop in main.cpp
+struct TiltConfig {
+    static constexpr uint8_t axes = 2;
+    static constexpr float kp = 40.0f;
+    static constexpr float ki = 20.0f;
+    static constexpr float kd = 0.05f;
+    static constexpr float derivativeFilter = 0.5f;
+    static constexpr float outputLimit = 255.0f;
+};
+
+/// Proportional and integral only, with an unfiltered derivative for the kick test
+struct PiConfig {
+    static constexpr uint8_t axes = 1;
+    static constexpr float kp = 2.0f;
+    static constexpr float ki = 10.0f;
+    static constexpr float kd = 0.0f;
+    static constexpr float derivativeFilter = 1.0f;
+    static constexpr float outputLimit = 100.0f;
+};
+
+struct PidConfig {
+    static constexpr uint8_t axes = 1;
+    static constexpr float kp = 2.0f;
+    static constexpr float ki = 10.0f;
+    static constexpr float kd = 0.5f;
+    static constexpr float derivativeFilter = 1.0f;
+    static constexpr float outputLimit = 100.0f;
+};
+
+/// Q16 steps a value may differ from float by after a few operations
+static const float Q16_TOLERANCE = 1e-3f;
+
+template <typename T> static T v(float value) {return FixedValue<T>::from(value);}
+template <typename T> static float f(T value) {return FixedValue<T>::toFloat(value);}
+
+/*! @brief Runs one update of a one axis controller differentiating the measurement
+* @return the output as a float
+*/
+template <typename T, typename C>
+static float step(Pid<T, C>& pid, float setpoint, float measurement, float dt)
+{
+    const T sp[1] = {v<T>(setpoint)};
+    const T pv[1] = {v<T>(measurement)};
+    return f<T>(pid.update(sp, pv, v<T>(dt), v<T>(dt))[0]);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+template <typename T>
+static void checkStepResponse(void)
+{
+    Pid<T, PiConfig> pid;
+    // First update: proportional plus one step of integral, 2*1 + 10*1*0.01
+    TEST_ASSERT_FLOAT_WITHIN(Q16_TOLERANCE, 2.1f, step(pid, 1.0f, 0.0f, 0.01f));
+    // The integral keeps adding 0.1 per update while the error stays
+    for (uint8_t n=2;n<=10;n++) {step(pid, 1.0f, 0.0f, 0.01f);}
+    TEST_ASSERT_FLOAT_WITHIN(10 * Q16_TOLERANCE, 3.0f, step(pid, 1.0f, 0.0f, 0.01f) - 0.1f);
+    // At the setpoint only the integral is left
+    TEST_ASSERT_FLOAT_WITHIN(10 * Q16_TOLERANCE, 1.1f, step(pid, 1.0f, 1.0f, 0.01f));
+}
+void test_step_response_float(void) {checkStepResponse<float>();}
+void test_step_response_q16(void) {checkStepResponse<Q16>();}
+
+template <typename T>
+static void checkAntiWindup(void)
+{
+    Pid<T, PiConfig> pid;
+    // The proportional term of an error of 40 is 80, so the integral grows by 4 per update
+    // until it reaches 20 and the output saturates, and then must stop for as long as it stays
+    for (uint16_t n=0;n<1000;n++) {step(pid, 40.0f, 0.0f, 0.01f);}
+    // 0.01 s is not exact in Q16, so its integral reaches 19.99 instead
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 100.0f, f<T>(pid.getOutput()[0]));
+    // Overshooting by one then only leaves that integral, rather than the 4000 a wound up
+    // one would have, so the output leaves saturation at once
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, -2.0f + 20.0f - 0.1f, step(pid, 40.0f, 41.0f, 0.01f));
+}
+void test_anti_windup_float(void) {checkAntiWindup<float>();}
+void test_anti_windup_q16(void) {checkAntiWindup<Q16>();}
+
+template <typename T>
+static void checkNoDerivativeKick(void)
+{
+    Pid<T, PidConfig> pid;
+    for (uint8_t n=0;n<10;n++) {step(pid, 0.0f, 0.0f, 0.01f);}
+    // A setpoint step with the measurement still: only the proportional and integral move,
+    // where a derivative of the error would add 0.5 * 10 / 0.01 = 500
+    float output = step(pid, 10.0f, 0.0f, 0.01f);
+    TEST_ASSERT_FLOAT_WITHIN(Q16_TOLERANCE, 2.0f * 10 + 10.0f * 10 * 0.01f, output);
+    // A moving measurement does produce a derivative term, opposing the motion
+    float moving = step(pid, 10.0f, 0.1f, 0.01f);
+    float expected = 2.0f * 9.9f + (1.0f + 10.0f * 9.9f * 0.01f) - 0.5f * 0.1f / 0.01f;
+    TEST_ASSERT_FLOAT_WITHIN(10 * Q16_TOLERANCE, expected, moving);
+}
+void test_no_derivative_kick_float(void) {checkNoDerivativeKick<float>();}
+void test_no_derivative_kick_q16(void) {checkNoDerivativeKick<Q16>();}
+
+void test_measured_rate_feeds_the_derivative(void)
+{
+    Pid<float, PidConfig> pid;
+    const float sp[1] = {0.0f};
+    const float pv[1] = {0.0f};
+    const float rate[1] = {4.0f};
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -2.0f, pid.update(sp, pv, rate, 0.01f)[0]);
+}
+
+void test_q16_saturates(void)
+{
+    const Q16 big = Q16::from(30000.0f);
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, Q16::from(40000.0f).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, Q16::from(-40000.0f).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, (big + big).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, (-big - big).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, (big * big).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, (big * -big).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, (big / Q16::from(0.001f)).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, (big / Q16::fromRaw(0)).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, ((-big) / Q16::fromRaw(0)).raw);
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, (-Q16::fromRaw(INT32_MIN)).raw);
+    // Rounded to the nearest step rather than truncated
+    TEST_ASSERT_EQUAL_INT32(1, (Q16::fromRaw(1) * Q16::from(0.5f)).raw);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -1.5f, (Q16::from(3.0f) / Q16::from(-2.0f)).toFloat());
+}
+
+void test_q16_controller_saturates_without_wrapping(void)
+{
+    // An error so large its proportional term overflows Q16 must pin the output at the
+    // limit with the right sign, where a wrapping type would flip it
+    Pid<Q16, TiltConfig> pid;
+    const Q16 sp[2] = {Q16::from(2000.0f), Q16::from(-2000.0f)};
+    const Q16 pv[2] = {Q16::from(-2000.0f), Q16::from(2000.0f)};
+    const Q16* out = pid.update(sp, pv, Q16::from(0.005f), Q16::from(0.005f));
+    TEST_ASSERT_FLOAT_WITHIN(Q16_TOLERANCE, 255.0f, out[0].toFloat());
+    TEST_ASSERT_FLOAT_WITHIN(Q16_TOLERANCE, -255.0f, out[1].toFloat());
+}
+
+void test_float_and_q16_agree(void)
+{
+    Pid<float, TiltConfig> pidFloat;
+    Pid<Q16, TiltConfig> pidQ16;
+    float worst = 0;
+    for (uint16_t n=0;n<1000;n++)
+    {
+        float angle = 5.0f * sinf(n * 0.01f) + 0.0625f * (n % 7);
+        const float spF[2] = {0.0f, 1.0f};
+        const float pvF[2] = {angle, -angle};
+        const Q16 spQ[2] = {Q16::from(0.0f), Q16::from(1.0f)};
+        const Q16 pvQ[2] = {Q16::from(angle), Q16::from(-angle)};
+        const float* outF = pidFloat.update(spF, pvF, 0.005f, n % 2 ? 0.0f : 0.01f);
+        const Q16* outQ = pidQ16.update(spQ, pvQ, Q16::from(0.005f), n % 2 ? Q16::from(0.0f) : Q16::from(0.01f));
+        for (uint8_t a=0;a<2;a++) {worst = max(worst, fabsf(outF[a] - outQ[a].toFloat()));}
+    }
+    TEST_ASSERT_LESS_THAN(1, (int)(worst * 10)); // Within 0.1 of 255
+}
+
+/// Reads the host's cycle counter, the time stamp counter on x86 and 0 elsewhere
+static inline uint64_t cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/// Time of one update on the host
+struct UpdateCost {
+    float ns;
+    float cycles;
+};
+
+/*! @brief Times updates of the tilt loop's two axis controller
+* @details The measurements are converted to T beforehand, so only the update is timed.
+* @return the time per update
+*/
+template <typename T>
+static UpdateCost benchmark(void)
+{
+    const uint32_t updates = 1000000;
+    Pid<T, TiltConfig> pid;
+    T angles[256];
+    for (uint16_t n=0;n<256;n++) {angles[n] = v<T>((float)n * 0.0625f - 8.0f);}
+    const T sp[2] = {v<T>(0.5f), v<T>(-0.5f)};
+    const T dt = v<T>(0.005f);
+    const T sampleDt = v<T>(0.01f);
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t startCycles = cycles();
+    for (uint32_t n=0;n<updates;n++)
+    {
+        const T pv[2] = {angles[n & 0xFF], angles[(n * 7) & 0xFF]};
+        const T* out = pid.update(sp, pv, dt, sampleDt);
+        asm volatile("" : : "r"(out) : "memory"); // Keeps every update
+    }
+    uint64_t spent = cycles() - startCycles;
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return {std::chrono::duration<float, std::nano>(elapsed).count() / updates, (float)spent / updates};
+}
+
+void test_benchmark_update(void)
+{
+    UpdateCost costFloat = benchmark<float>();
+    UpdateCost costQ16 = benchmark<Q16>();
+    char message[128];
+    snprintf(message, sizeof(message), "Two axis update on the host: float %.1f ns, %.0f cycles; Q16 %.1f ns, %.0f cycles",
+             costFloat.ns, costFloat.cycles, costQ16.ns, costQ16.cycles);
+    TEST_MESSAGE(message);
+    // Straight-line arithmetic, no more than a few hundred instructions either way
+    TEST_ASSERT_LESS_THAN(1000, (int)costFloat.ns);
+    TEST_ASSERT_LESS_THAN(1000, (int)costQ16.ns);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_step_response_float);
+    RUN_TEST(test_step_response_q16);
+    RUN_TEST(test_anti_windup_float);
+    RUN_TEST(test_anti_windup_q16);
+    RUN_TEST(test_no_derivative_kick_float);
+    RUN_TEST(test_no_derivative_kick_q16);
+    RUN_TEST(test_measured_rate_feeds_the_derivative);
+    RUN_TEST(test_q16_saturates);
+    RUN_TEST(test_q16_controller_saturates_without_wrapping);
+    RUN_TEST(test_float_and_q16_agree);
+    RUN_TEST(test_benchmark_update);
+    return UNITY_END();
+}
@@ -0,0 +1,149 @@
+/*!
+ * @file test_seqshare.cpp
+ * @author Setting-Dawn
+ * @brief Stress test of SeqShare with one writer and several readers on their own threads.
+ * @details Every value put fills all of its words with the number of the put, so a reader
+ * which copied part of one put and part of another sees words that differ.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SeqShare.h"
+
+/// Words of each value, large enough that a copy takes a while
+#define FRAME_WORDS 256
+/// Values the writer puts, and threads reading them
+#define PUTS 200000
+#define READERS 3
+
+struct Frame {
+    uint32_t word[FRAME_WORDS];
+};
+
+static SeqShare<Frame> share("frame");
+
+/// Outcome of one reader thread
+struct ReaderResult {
+    uint32_t reads;
+    uint32_t torn;       // Copies whose words were not all from one put
+    uint32_t mismatched; // Copies whose put differed from the count get() returned
+    uint32_t backwards;  // Copies older than the one before
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_empty_share(void)
+{
+    SeqShare<Frame> empty;
+    Frame frame;
+    frame.word[0] = 1;
+    TEST_ASSERT_EQUAL_UINT32(0, empty.get(frame));
+    TEST_ASSERT_EQUAL_UINT32(0, frame.word[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, empty.sequence());
+}
+
+void test_get_counts_the_copied_put(void)
+{
+    SeqShare<Frame> counted;
+    Frame frame;
+    for (uint32_t n=1;n<=3;n++)
+    {
+        for (uint32_t w=0;w<FRAME_WORDS;w++) {frame.word[w] = n;}
+        counted.put(frame);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, counted.get(frame));
+    TEST_ASSERT_EQUAL_UINT32(3, frame.word[0]);
+    TEST_ASSERT_EQUAL_UINT32(3, counted.sequence());
+}
+
+/**
+ * @class SeqShareAt
+ * @brief A SeqShare whose counter can be set, to reach a put in progress or the wraparound.
+ */
+class SeqShareAt : public SeqShare<Frame> {
+    public:
+        void setCounter(uint32_t counter) {seq.store(counter);}
+};
+
+void test_sequence_counts_completed_puts_and_wraps(void)
+{
+    SeqShareAt counted;
+    Frame frame = {};
+
+    // A put in progress leaves the counter odd, which still counts the puts before it
+    counted.setCounter(2 * 5 + 1);
+    TEST_ASSERT_EQUAL_UINT32(5, counted.sequence());
+    counted.setCounter(2 * 5);
+    counted.put(frame);
+    TEST_ASSERT_EQUAL_UINT32(6, counted.sequence());
+
+    // The last put before the counter wraps and the one after differ
+    counted.setCounter(0xFFFFFFFE);
+    uint32_t last = counted.sequence();
+    counted.put(frame);
+    TEST_ASSERT_EQUAL_UINT32(0, counted.sequence());
+    TEST_ASSERT_NOT_EQUAL(last, counted.sequence());
+    TEST_ASSERT_EQUAL_UINT32(0, counted.get(frame));
+}
+
+void test_no_torn_frames(void)
+{
+    std::atomic<bool> done {false};
+    ReaderResult results[READERS] = {};
+    std::vector<std::thread> readers;
+    for (uint8_t r=0;r<READERS;r++)
+    {
+        readers.emplace_back([&done, &results, r] ()
+        {
+            ReaderResult& result = results[r];
+            Frame frame;
+            uint32_t last = 0;
+            while (!done)
+            {
+                uint32_t count = share.get(frame);
+                result.reads++;
+                for (uint32_t w=1;w<FRAME_WORDS;w++)
+                {
+                    if (frame.word[w] != frame.word[0]) {result.torn++; break;}
+                }
+                if (frame.word[0] != count) {result.mismatched++;}
+                if (count < last) {result.backwards++;}
+                last = count;
+            }
+        });
+    }
+
+    Frame frame;
+    for (uint32_t n=1;n<=PUTS;n++)
+    {
+        for (uint32_t w=0;w<FRAME_WORDS;w++) {frame.word[w] = n;}
+        share.put(frame);
+    }
+    done = true;
+    for (std::thread& reader : readers) {reader.join();}
+
+    uint32_t reads = 0;
+    for (uint8_t r=0;r<READERS;r++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(0, results[r].torn);
+        TEST_ASSERT_EQUAL_UINT32(0, results[r].mismatched);
+        TEST_ASSERT_EQUAL_UINT32(0, results[r].backwards);
+        reads += results[r].reads;
+    }
+    TEST_ASSERT_EQUAL_UINT32(PUTS, share.sequence());
+    TEST_ASSERT_GREATER_THAN_UINT32(READERS, reads);
+    printf("%u puts, %u reads\n", PUTS, reads);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_share);
+    RUN_TEST(test_get_counts_the_copied_put);
+    RUN_TEST(test_sequence_counts_completed_puts_and_wraps);
+    RUN_TEST(test_no_torn_frames);
+    return UNITY_END();
+}
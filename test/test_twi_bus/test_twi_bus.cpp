@@ -0,0 +1,281 @@
+/*!
+ * @file test_twi_bus.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the bus task's ordering, deadlines, notification bits and reported occupancy and queueing delay.
+ * @details The bus task runs on the simulated clock, on which a job takes exactly the time
+ * it spends and a transfer the time its bytes take at the bus clock. A job can hold the bus
+ * until the test opens its gate, so other jobs are queued behind it in a known order and
+ * every wait and busy time the bus reports can be checked to the microsecond.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include "TWIbus.h"
+
+/// Clock of jobs for devices not in the clock table
+static const uint32_t BUS_HZ = 100000;
+
+/**
+ * @struct Work
+ * @brief What a test job does with the bus.
+ */
+struct Work {
+    char name;                     ///< Recorded in the order jobs ran
+    uint32_t us;                   ///< Time the job spends
+    std::atomic<bool>* gate;       ///< If set, the job holds the bus until it is true
+    uint8_t address;               ///< Device written to, if length is not 0
+    uint8_t length;                ///< Data bytes written
+    uint32_t clock;                ///< Receives the bus clock the job ran at
+};
+
+/// Names of the jobs in the order they ran, written only by the bus task
+static std::string order;
+/// Set by a gated job once it holds the bus
+static std::atomic<bool> holding {false};
+
+/*! @brief Job which spends its time, after its gate opens, and writes its bytes
+* @param context the Work
+* @return true if the write was acknowledged
+*/
+static bool doWork(void* context)
+{
+    Work* work = (Work*)context;
+    if (work->gate)
+    {
+        holding = true;
+        while (!*work->gate) {std::this_thread::yield();}
+    }
+    order += work->name;
+    work->clock = Wire.getClock();
+    HOST_spendUs(work->us);
+    if (work->length == 0) {return true;}
+
+    uint8_t data[HOST_TWI_BUFFER] = {};
+    Wire.beginTransmission(work->address);
+    Wire.write(data, work->length);
+    return Wire.endTransmission() == 0;
+}
+
+/*! @brief Fills in a job, to be queued with submit()
+* @param job the job
+* @param client the task it is for
+* @param priority its queue
+* @param work what it does
+* @param startWithin ticks it may wait before it is dropped
+*/
+static void makeJob(TWIJob& job, TWIClient client, TWIPriority priority, Work& work, TickType_t startWithin = portMAX_DELAY)
+{
+    job.function = doWork;
+    job.context = &work;
+    job.client = client;
+    job.priority = priority;
+    job.address = work.length ? work.address : TWI_ANY_DEVICE;
+    job.bytes = work.length ? 1 + work.length : 0;
+    job.deadline = startWithin == portMAX_DELAY ? portMAX_DELAY : xTaskGetTickCount() + startWithin;
+}
+
+/*! @brief Starts a bus task of its own for a test
+* @details The task never ends, so the bus is never freed.
+* @return the bus, with devices at 0x28 and 0x01 given their own clocks
+*/
+static TWIBus& startBus(void)
+{
+    TWIBus* bus = new TWIBus(&Wire);
+    bus->addDevice(0x28, 400000);
+    bus->addDevice(0x01, 1000000);
+    TEST_ASSERT_TRUE(bus->begin("Test Bus", 8, 21, 22, BUS_HZ));
+    order.clear();
+    return *bus;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_occupancy_is_the_share_of_time_spent_running_jobs(void)
+{
+    TWIBus& bus = startBus();
+    Work work = {'e', 300, NULL, 0, 0, 0};
+    for (uint8_t n=0;n<20;n++)
+    {
+        TEST_ASSERT_EQUAL(TWI_JOB_DONE, bus.run(TWI_CLIENT_EIT, TWI_PRIORITY_LOW, TWI_ANY_DEVICE, 0, doWork, &work));
+        HOST_spendUs(700); // The client works without the bus in between
+    }
+
+    TWIStats stats;
+    bus.getStats(stats);
+    const TWIClientStats& eit = stats.client[TWI_CLIENT_EIT];
+    TEST_ASSERT_EQUAL(20, eit.jobs);
+    TEST_ASSERT_EQUAL(0, eit.failed);
+    TEST_ASSERT_EQUAL(20 * 300, (uint32_t)eit.busyUs);
+    TEST_ASSERT_EQUAL(0, (uint32_t)eit.waitUs);
+    TEST_ASSERT_EQUAL(0, stats.client[TWI_CLIENT_IMU].jobs);
+
+    // Occupancy as /stats serves it
+    float busyPercent = 100.0f * eit.busyUs / (float)(esp_timer_get_time() - stats.startedAt);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, busyPercent);
+}
+
+void test_high_priority_jobs_pass_queued_low_priority_ones(void)
+{
+    TWIBus& bus = startBus();
+    std::atomic<bool> gate {false};
+    holding = false;
+
+    // A long EIT job holds the bus while the rest are queued behind it
+    Work hold = {'A', 1000, &gate, 0, 0, 0};
+    Work low1 = {'B', 400, NULL, 0, 0, 0};
+    Work low2 = {'C', 400, NULL, 0, 0, 0};
+    Work high1 = {'x', 200, NULL, 0, 0, 0};
+    Work high2 = {'y', 200, NULL, 0, 0, 0};
+    TWIJob jobs[5];
+    makeJob(jobs[0], TWI_CLIENT_EIT, TWI_PRIORITY_LOW, hold);
+    TEST_ASSERT_TRUE(bus.submit(jobs[0]));
+    while (!holding) {std::this_thread::yield();}
+
+    makeJob(jobs[1], TWI_CLIENT_EIT, TWI_PRIORITY_LOW, low1);
+    makeJob(jobs[2], TWI_CLIENT_EIT, TWI_PRIORITY_LOW, low2);
+    makeJob(jobs[3], TWI_CLIENT_IMU, TWI_PRIORITY_HIGH, high1);
+    makeJob(jobs[4], TWI_CLIENT_IMU, TWI_PRIORITY_HIGH, high2);
+    for (uint8_t n=1;n<5;n++) {TEST_ASSERT_TRUE(bus.submit(jobs[n]));}
+    gate = true;
+    for (TWIJob& job : jobs) {TEST_ASSERT_EQUAL(TWI_JOB_DONE, bus.wait(job));}
+
+    // The IMU jobs ran as soon as the bus was free, ahead of the EIT jobs queued before them
+    TEST_ASSERT_EQUAL_STRING("AxyBC", order.c_str());
+    TWIStats stats;
+    bus.getStats(stats);
+    const TWIClientStats& eit = stats.client[TWI_CLIENT_EIT];
+    const TWIClientStats& imu = stats.client[TWI_CLIENT_IMU];
+    TEST_ASSERT_EQUAL(1000 + 400 + 400, (uint32_t)eit.busyUs);
+    TEST_ASSERT_EQUAL(200 + 200, (uint32_t)imu.busyUs);
+    // Every job was queued at the same time, so each waited for the ones which ran before it
+    TEST_ASSERT_EQUAL(1000 + 1200, (uint32_t)imu.waitUs);
+    TEST_ASSERT_EQUAL(1200, imu.maxWaitUs);
+    TEST_ASSERT_EQUAL(0 + 1400 + 1800, (uint32_t)eit.waitUs);
+    TEST_ASSERT_EQUAL(1800, eit.maxWaitUs);
+}
+
+void test_jobs_past_their_deadline_are_dropped(void)
+{
+    TWIBus& bus = startBus();
+    std::atomic<bool> gate {false};
+    holding = false;
+
+    Work hold = {'A', 3000, &gate, 0, 0, 0};
+    Work late = {'x', 200, NULL, 0, 0, 0};
+    Work inTime = {'y', 200, NULL, 0, 0, 0};
+    TWIJob jobs[3];
+    makeJob(jobs[0], TWI_CLIENT_EIT, TWI_PRIORITY_LOW, hold);
+    TEST_ASSERT_TRUE(bus.submit(jobs[0]));
+    while (!holding) {std::this_thread::yield();}
+
+    // The bus is held for 3 ticks, so only the job which may wait 5 starts
+    makeJob(jobs[1], TWI_CLIENT_IMU, TWI_PRIORITY_HIGH, late, 1);
+    makeJob(jobs[2], TWI_CLIENT_IMU, TWI_PRIORITY_HIGH, inTime, 5);
+    TEST_ASSERT_TRUE(bus.submit(jobs[1]));
+    TEST_ASSERT_TRUE(bus.submit(jobs[2]));
+    gate = true;
+
+    TEST_ASSERT_EQUAL(TWI_JOB_DONE, bus.wait(jobs[0]));
+    TEST_ASSERT_EQUAL(TWI_JOB_EXPIRED, bus.wait(jobs[1]));
+    TEST_ASSERT_EQUAL(TWI_JOB_DONE, bus.wait(jobs[2]));
+    TEST_ASSERT_EQUAL_STRING("Ay", order.c_str());
+
+    TWIStats stats;
+    bus.getStats(stats);
+    TEST_ASSERT_EQUAL(1, stats.client[TWI_CLIENT_IMU].expired);
+    TEST_ASSERT_EQUAL(1, stats.client[TWI_CLIENT_IMU].jobs);
+    TEST_ASSERT_EQUAL(200, (uint32_t)stats.client[TWI_CLIENT_IMU].busyUs);
+}
+
+void test_client_notification_bits_are_kept(void)
+{
+    TWIBus& bus = startBus();
+    std::atomic<bool> gate {false};
+    holding = false;
+    TaskHandle_t client = xTaskGetCurrentTaskHandle();
+
+    Work hold = {'A', 500, &gate, 0, 0, 0};
+    TWIJob job;
+    makeJob(job, TWI_CLIENT_EIT, TWI_PRIORITY_LOW, hold);
+    TEST_ASSERT_TRUE(bus.submit(job));
+    while (!holding) {std::this_thread::yield();}
+
+    // A settle timer notifies the client while its job is still holding the bus
+    const uint32_t SETTLED = 0x02;
+    std::thread timer([client, &gate] ()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        xTaskNotify(client, SETTLED, eSetBits);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        gate = true;
+    });
+    TEST_ASSERT_EQUAL(TWI_JOB_DONE, bus.wait(job));
+    timer.join();
+
+    // The wait ended with the job, cleared only the bus's bit and left the client's set
+    TEST_ASSERT_EQUAL_STRING("A", order.c_str());
+    TEST_ASSERT_EQUAL_HEX32(SETTLED, client->value);
+    client->value = 0;
+}
+
+void test_devices_run_at_their_own_clock(void)
+{
+    HostRegisterDevice imu, pca, other;
+    Wire.attach(0x28, &imu);
+    Wire.attach(0x01, &pca);
+    Wire.attach(0x1D, &other);
+    TWIBus& bus = startBus();
+
+    // Consecutive jobs for the same device share its clock, so the clock changes three times
+    Work imuWrite = {'i', 0, NULL, 0x28, 8, 0};
+    Work pcaWrite = {'p', 0, NULL, 0x01, 5, 0};
+    Work otherWrite = {'o', 0, NULL, 0x1D, 8, 0};
+    Work* sequence[] = {&imuWrite, &imuWrite, &imuWrite, &pcaWrite, &pcaWrite, &otherWrite};
+    uint32_t clocks[6];
+    for (uint8_t n=0;n<6;n++)
+    {
+        TWIJob job;
+        makeJob(job, TWI_CLIENT_IMU, TWI_PRIORITY_HIGH, *sequence[n]);
+        if (sequence[n] == &otherWrite) {job.address = TWI_ANY_DEVICE;}
+        TEST_ASSERT_TRUE(bus.submit(job));
+        TEST_ASSERT_EQUAL(TWI_JOB_DONE, bus.wait(job));
+        clocks[n] = sequence[n]->clock;
+    }
+    const uint32_t expected[] = {400000, 400000, 400000, 1000000, 1000000, BUS_HZ};
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, clocks, 6);
+
+    TWIStats stats;
+    bus.getStats(stats);
+    TEST_ASSERT_EQUAL(3, stats.clockChanges);
+    TEST_ASSERT_EQUAL(2, stats.devices);
+
+    // Each device's throughput is the byte rate of its clock, 9 bit times a byte
+    for (uint8_t d=0;d<stats.devices;d++)
+    {
+        const TWIDeviceStats& device = stats.device[d];
+        TEST_ASSERT_EQUAL(device.address == 0x28 ? 3 : 2, device.jobs);
+        TEST_ASSERT_EQUAL(device.address == 0x28 ? 3 * 9 : 2 * 6, (uint32_t)device.bytes);
+        float bytesPerSecond = device.bytes * 1e6f / device.busyUs;
+        TEST_ASSERT_FLOAT_WITHIN(0.01f * device.frequency / 9, device.frequency / 9.0f, bytesPerSecond);
+    }
+    Wire.attach(0x28, NULL);
+    Wire.attach(0x01, NULL);
+    Wire.attach(0x1D, NULL);
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_occupancy_is_the_share_of_time_spent_running_jobs);
+    RUN_TEST(test_high_priority_jobs_pass_queued_low_priority_ones);
+    RUN_TEST(test_jobs_past_their_deadline_are_dropped);
+    RUN_TEST(test_client_notification_bits_are_kept);
+    RUN_TEST(test_devices_run_at_their_own_clock);
+    return UNITY_END();
+}
@@ -0,0 +1,258 @@
+/*!
+ * @file test_web_server.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the web server's routes and a requests per second and latency benchmark of them.
+ * @details The handlers of EITwebhost.cpp are built unchanged against the host web server,
+ * which runs a request's handler as soon as it is opened and then sends its response a
+ * TCP segment at a time, as the AsyncTCP task does. The benchmark times each request from
+ * its arrival until the last byte of its response has been handed to the connection,
+ * against the up to 100 ms a request waited for the old handleClient() poll.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include "EITwebhost.cpp"
+
+// The shares and tasks main.cpp defines which the handlers read
+Share<bool> initializeVFLG ("Measure V0");
+Share<bool> readVFLG ("Read V");
+Share<float> xBar ("X Centroid");
+Share<float> yBar ("Y Centroid");
+SeqShare<EITActiveFrame> eitFrame ("EIT Frame");
+Share<EITStats> eitStats ("EIT Stats");
+Share<bool> calibrateFLG ("Calibrate");
+SeqShare<IMUStats> imuStats ("IMU Stats");
+TWIBus eitBus (&Wire);
+TWIBus& imuBus = eitBus;
+Periodic imuCycle (10000, 250);
+Periodic controlCycle (5000, 250);
+Periodic servoCycle (1000, 50);
+
+/// Largest segment the connection takes at once, the TCP MSS of the ESP32's lwIP
+static const size_t SEGMENT = 1436;
+/// Period the old web server task polled handleClient() at, in microseconds
+static const uint32_t POLL_PERIOD_US = 100000;
+
+/*! @brief Fills a frame with random codes
+* @param frame the frame
+* @param sequence number of the frame
+*/
+static void fillFrame(EITActiveFrame& frame, uint32_t sequence)
+{
+    static std::mt19937 random(507);
+    std::uniform_int_distribution<int> code(-32768, 32767);
+    for (uint16_t n=0;n<EITActiveFrame::measurements;n++) {frame.values[n] = (int16_t)code(random);}
+    frame.sequence = sequence;
+    frame.timestamp = sequence * 250;
+    frame.scale = ADC128D818_INTERNAL_REF_V / 4096.0f / 4;
+}
+
+/// Registers the routes as setup() in main.cpp does
+static void startServer(void)
+{
+    server.on ("/", HTTP_GET, handle_DocumentRoot);
+    server.on ("/data", HTTP_GET, handle_data);
+    server.on ("/data.bin", HTTP_GET, handle_data_bin);
+    server.on ("/set", HTTP_GET, handleSetValues);
+    server.on ("/flags", HTTP_GET, handleFlags);
+    server.on ("/stats", HTTP_GET, handle_stats);
+    server.onNotFound (handle_NotFound);
+    webSocket.onEvent (handle_ws_event);
+    server.addHandler (&webSocket);
+    server.begin ();
+}
+
+/*! @brief Requests a page and sends the whole response
+* @param url the page and its arguments
+* @param code receives the status of the response
+* @return the response's content
+*/
+static std::string get(const char* url, int& code)
+{
+    std::unique_ptr<AsyncWebServerRequest> request = server.request(url);
+    code = request->code();
+    return request->receive(SEGMENT);
+}
+
+/*! @brief Formats the whole CSV page of a frame at once
+* @param frame the frame
+* @return the page /data should send for it with the current flags
+*/
+static std::string csvPage(const EITActiveFrame& frame)
+{
+    EITCsvState state;
+    EITcsv_begin(state);
+    std::string page;
+    uint8_t buffer[SEGMENT];
+    size_t len;
+    while ((len = EITcsv_write(frame, initializeVFLG.get(), readVFLG.get(), state, buffer, sizeof(buffer))) > 0)
+    {
+        page.append((const char*)buffer, len);
+    }
+    return page;
+}
+
+/*! @brief Finds a percentile of some times by the nearest rank
+* @param times the times, sorted
+* @param p the percentile, from 0 to 100
+* @return the time at that rank
+*/
+static double percentile(const std::vector<double>& times, double p)
+{
+    size_t rank = (size_t)ceil(p / 100.0 * times.size());
+    return times[rank > 0 ? rank - 1 : 0];
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_routes_are_answered(void)
+{
+    int code;
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, get("/", code).find("EIT Reading Home Page"));
+    TEST_ASSERT_EQUAL(200, code);
+
+    TEST_ASSERT_EQUAL_STRING("OK. Received x=0.25 y=-0.50", get("/set?x=0.25&y=-0.5", code).c_str());
+    TEST_ASSERT_EQUAL(200, code);
+    get("/set?x=0.25", code);
+    TEST_ASSERT_EQUAL(400, code);
+
+    initializeVFLG.put(true);
+    get("/flags?initializeFLG=1", code);
+    TEST_ASSERT_EQUAL(200, code);
+    TEST_ASSERT_FALSE(initializeVFLG.get());
+    TEST_ASSERT_TRUE(readVFLG.get());
+    calibrateFLG.put(false);
+    get("/flags?calibrateFLG=1", code);
+    TEST_ASSERT_EQUAL(200, code);
+    TEST_ASSERT_TRUE(calibrateFLG.get());
+    get("/flags?readFLG=1", code);
+    TEST_ASSERT_EQUAL(400, code);
+    get("/flags", code);
+    TEST_ASSERT_EQUAL(400, code);
+
+    get("/missing", code);
+    TEST_ASSERT_EQUAL(404, code);
+
+    TEST_ASSERT_EQUAL(0, get("/stats", code).find("frames,"));
+    TEST_ASSERT_EQUAL(200, code);
+}
+
+void test_data_pages_send_the_latest_frame(void)
+{
+    EITActiveFrame frame;
+    fillFrame(frame, 1);
+    eitFrame.put(frame);
+    initializeVFLG.put(true);
+    readVFLG.put(false);
+
+    // The CSV page is formatted chunk by chunk, so it must match the whole page formatted at once
+    int code;
+    std::string page = get("/data", code);
+    TEST_ASSERT_EQUAL(200, code);
+    TEST_ASSERT_EQUAL_STRING(csvPage(frame).c_str(), page.c_str());
+
+    std::string binary = get("/data.bin", code);
+    TEST_ASSERT_EQUAL(200, code);
+    TEST_ASSERT_EQUAL(EIT_BINARY_HEADER_SIZE + EITActiveFrame::measurements * 2, binary.size());
+    TEST_ASSERT_EQUAL(0, binary.find("EITF"));
+    std::string floats = get("/data.bin?format=float", code);
+    TEST_ASSERT_EQUAL(EIT_BINARY_HEADER_SIZE + EITActiveFrame::measurements * 4, floats.size());
+}
+
+void test_requests_in_flight_keep_their_frame(void)
+{
+    EITActiveFrame first, second;
+    fillFrame(first, 2);
+    fillFrame(second, 3);
+    eitFrame.put(first);
+
+    // Every slot is taken by a client which has only read one segment so far
+    std::vector<std::unique_ptr<AsyncWebServerRequest>> open;
+    std::vector<std::string> pages;
+    uint8_t buffer[SEGMENT];
+    for (uint8_t n=0;n<EIT_CSV_SLOTS;n++)
+    {
+        open.push_back(server.request("/data"));
+        TEST_ASSERT_EQUAL(200, open.back()->code());
+        size_t len = open.back()->transmit(buffer, SEGMENT);
+        pages.emplace_back((const char*)buffer, len);
+    }
+    std::unique_ptr<AsyncWebServerRequest> refused = server.request("/data");
+    TEST_ASSERT_EQUAL(503, refused->code());
+
+    // A new frame does not change the pages already being sent
+    eitFrame.put(second);
+    for (uint8_t n=0;n<EIT_CSV_SLOTS;n++) {pages[n] += open[n]->receive(SEGMENT);}
+    for (uint8_t n=0;n<EIT_CSV_SLOTS;n++) {TEST_ASSERT_EQUAL_STRING(csvPage(first).c_str(), pages[n].c_str());}
+
+    // Closing a connection frees its slot for the next request, which gets the new frame
+    open[0]->close();
+    int code;
+    std::string next = get("/data", code);
+    TEST_ASSERT_EQUAL(200, code);
+    TEST_ASSERT_EQUAL_STRING(csvPage(second).c_str(), next.c_str());
+    open.clear();
+}
+
+void test_benchmark_requests(void)
+{
+    const char* const routes[] = {"/data", "/data.bin", "/stats"};
+    const int ROUNDS = 2000;
+    EITActiveFrame frame;
+    std::vector<double> all;
+    double totalUs = 0;
+    for (const char* route : routes)
+    {
+        std::vector<double> times;
+        for (int n=0;n<ROUNDS;n++)
+        {
+            // A new frame for every request, as the reading task would publish them
+            fillFrame(frame, 10 + n);
+            eitFrame.put(frame);
+
+            auto start = std::chrono::steady_clock::now();
+            std::unique_ptr<AsyncWebServerRequest> request = server.request(route);
+            std::string page = request->receive(SEGMENT);
+            request->close();
+            auto stop = std::chrono::steady_clock::now();
+            TEST_ASSERT_EQUAL(200, request->code());
+            TEST_ASSERT_FALSE(page.empty());
+            times.push_back(std::chrono::duration<double, std::micro>(stop - start).count());
+        }
+        double spentUs = 0;
+        for (double t : times) {spentUs += t;}
+        totalUs += spentUs;
+        all.insert(all.end(), times.begin(), times.end());
+        std::sort(times.begin(), times.end());
+
+        char message[128];
+        snprintf(message, sizeof(message), "%-9s %8.0f requests/s, median %6.1f us, p99 %6.1f us, max %7.1f us",
+                 route, ROUNDS / spentUs * 1e6, percentile(times, 50), percentile(times, 99), times.back());
+        TEST_MESSAGE(message);
+    }
+    std::sort(all.begin(), all.end());
+
+    char message[128];
+    snprintf(message, sizeof(message), "All routes %.0f requests/s, p99 %.1f us; the handleClient() poll alone added up to %lu us",
+             all.size() / totalUs * 1e6, percentile(all, 99), (unsigned long)POLL_PERIOD_US);
+    TEST_MESSAGE(message);
+    // Serving a request must take far less than the poll period it used to wait for
+    TEST_ASSERT_LESS_THAN_FLOAT(POLL_PERIOD_US / 10, percentile(all, 99));
+}
+
+int main(int argc, char** argv)
+{
+    startServer();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_routes_are_answered);
+    RUN_TEST(test_data_pages_send_the_latest_frame);
+    RUN_TEST(test_requests_in_flight_keep_their_frame);
+    RUN_TEST(test_benchmark_requests);
+    return UNITY_END();
+}
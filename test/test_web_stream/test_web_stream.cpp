@@ -0,0 +1,189 @@
+/*!
+ * @file test_web_stream.cpp
+ * @author Setting-Dawn
+ * @brief Tests of the WebSocket frame stream and a frame-to-acknowledgement latency benchmark.
+ * @details The stream functions of EITwebhost.cpp are built unchanged against the host web
+ * server, whose WebSocket keeps the latest message pushed to its clients. A test client
+ * decodes each frame it is pushed and acknowledges it, as StreamLatency.py does on the
+ * device. The benchmark times each frame from its publication by the reading task until
+ * its acknowledgement has been handled, against the up to 100 ms a client polling /data
+ * waited for the old handleClient() poll alone.
+ * @version 1.0.0
+ * @date 2026-Oct-16
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "EITwebhost.cpp"
+
+// The shares and tasks main.cpp defines which the handlers read
+Share<bool> initializeVFLG ("Measure V0");
+Share<bool> readVFLG ("Read V");
+Share<float> xBar ("X Centroid");
+Share<float> yBar ("Y Centroid");
+SeqShare<EITActiveFrame> eitFrame ("EIT Frame");
+Share<EITStats> eitStats ("EIT Stats");
+Share<bool> calibrateFLG ("Calibrate");
+SeqShare<IMUStats> imuStats ("IMU Stats");
+TWIBus eitBus (&Wire);
+TWIBus& imuBus = eitBus;
+Periodic imuCycle (10000, 250);
+Periodic controlCycle (5000, 250);
+Periodic servoCycle (1000, 50);
+
+/// Period the old web server task polled handleClient() at, in microseconds
+static const uint32_t POLL_PERIOD_US = 100000;
+
+/// The streaming client, connected once for every test
+static uint32_t client = 0;
+/// Number of the frames published so far
+static uint32_t published = 0;
+
+/*! @brief Publishes a new frame, completed now, as the reading task does
+* @return the frame's sequence number
+*/
+static uint32_t publish(void)
+{
+    EITActiveFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    for (uint16_t n=0;n<EITActiveFrame::measurements;n++) {frame.values[n] = (int16_t)(n * 7 - 700);}
+    frame.sequence = ++published;
+    frame.timestamp = millis();
+    frame.scale = ADC128D818_INTERNAL_REF_V / 4096.0f;
+    eitFrame.put(frame);
+    return frame.sequence;
+}
+
+/*! @brief Decodes the header of the latest frame pushed to the clients
+* @return the header, whose magic is 0 if nothing valid was pushed
+*/
+static EITBinaryHeader pushed(void)
+{
+    EITBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!EITbinary_decodeHeader(webSocket.lastMessage.data(), webSocket.lastMessage.size(), header)) {header.magic = 0;}
+    return header;
+}
+
+/*! @brief Acknowledges a frame from the client
+* @param sequence the frame's sequence number
+*/
+static void ack(uint32_t sequence)
+{
+    char message[24];
+    snprintf(message, sizeof(message), "ack=%lu", (unsigned long)sequence);
+    webSocket.receive(client, message);
+}
+
+/*! @brief Finds a percentile of some times by the nearest rank
+* @param times the times, sorted
+* @param p the percentile, from 0 to 100
+* @return the time at that rank
+*/
+static double percentile(const std::vector<double>& times, double p)
+{
+    size_t rank = (size_t)ceil(p / 100.0 * times.size());
+    return times[rank > 0 ? rank - 1 : 0];
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_each_frame_is_pushed_once(void)
+{
+    uint32_t before = webSocket.messages;
+    uint32_t sequence = publish();
+    stream_frame();
+    TEST_ASSERT_EQUAL(before + 1, webSocket.messages);
+    EITBinaryHeader header = pushed();
+    TEST_ASSERT_EQUAL_HEX32(EIT_BINARY_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL(sequence, header.sequence);
+    TEST_ASSERT_EQUAL(EITActiveFrame::measurements, header.count);
+
+    // Waking without a new frame, as on the web task's timeout, pushes nothing
+    stream_frame();
+    TEST_ASSERT_EQUAL(before + 1, webSocket.messages);
+}
+
+void test_dropped_frames_do_not_repeat_the_stream(void)
+{
+    // Frames dropped by the reading task leave gaps in the frame numbers, which the
+    // count of frames put must not be compared with
+    published += 5;
+    uint32_t before = webSocket.messages;
+    uint32_t sequence = publish();
+    stream_frame();
+    stream_frame();
+    TEST_ASSERT_EQUAL(before + 1, webSocket.messages);
+    TEST_ASSERT_EQUAL(sequence, pushed().sequence);
+}
+
+void test_ack_measures_the_latency(void)
+{
+    uint32_t sequence = publish();
+    HOST_spendUs(3000);
+    stream_frame();
+    HOST_spendUs(4000);
+    ack(pushed().sequence);
+    TEST_ASSERT_EQUAL(sequence, pushed().sequence);
+    TEST_ASSERT_EQUAL(7, streamLatencyMs);
+}
+
+void test_client_that_never_acks(void)
+{
+    // A client which stops acknowledging neither holds frames back nor changes the latency
+    uint32_t latency = streamLatencyMs;
+    uint32_t first = published + 1;
+    for (uint8_t n=0;n<50;n++)
+    {
+        uint32_t sequence = publish();
+        HOST_spendUs(250000);
+        stream_frame();
+        TEST_ASSERT_EQUAL(sequence, pushed().sequence);
+    }
+    TEST_ASSERT_EQUAL(latency, streamLatencyMs);
+
+    // A late acknowledgement of a frame since replaced is not a measurement
+    ack(first);
+    TEST_ASSERT_EQUAL(latency, streamLatencyMs);
+}
+
+void test_benchmark_frame_to_ack(void)
+{
+    const int FRAMES = 5000;
+    std::vector<double> times;
+    for (int n=0;n<FRAMES;n++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        publish();
+        stream_frame();
+        ack(pushed().sequence);
+        auto stop = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::micro>(stop - start).count());
+    }
+    TEST_ASSERT_EQUAL(published, pushed().sequence);
+    std::sort(times.begin(), times.end());
+
+    char message[128];
+    snprintf(message, sizeof(message), "Frame to ack: median %.1f us, p99 %.1f us, max %.1f us; the handleClient() poll alone added up to %lu us",
+             percentile(times, 50), percentile(times, 99), times.back(), (unsigned long)POLL_PERIOD_US);
+    TEST_MESSAGE(message);
+    // Streaming a frame must take far less than the poll period a client used to wait for
+    TEST_ASSERT_LESS_THAN_FLOAT(POLL_PERIOD_US / 10, percentile(times, 99));
+}
+
+int main(int argc, char** argv)
+{
+    HOST_useSimulatedClock(true);
+    webSocket.onEvent (handle_ws_event);
+    client = webSocket.connect();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_each_frame_is_pushed_once);
+    RUN_TEST(test_dropped_frames_do_not_repeat_the_stream);
+    RUN_TEST(test_ack_measures_the_latency);
+    RUN_TEST(test_client_that_never_acks);
+    RUN_TEST(test_benchmark_frame_to_ack);
+    return UNITY_END();
+}